@@ -1,4 +1,5 @@
 #include "ADScene.hpp"
+#include "ADSceneConst.hpp"
 
 ADScene::ADScene()
 { clear(); }
@@ -11,16 +12,27 @@ void ADScene::clear()
     maxVoxelY_ = -1;
     log2VoxelsWidth_ = 0;
     log2VoxelsHeight_ = 0;
-    voxels_.reset();
-    adVertices_.reset();
-    adVerticesNumber_ = 0;
+    // Since Qt 5.7 resizing to 0 keeps the capacity.
+    voxels_.resize(0);
+    polygonsDescriptors_.resize(0);
+    polygonsDescriptorsAddresses_.resize(0);
+    semiTransparentPolygonsNumber_ = 0;
+    adVertices_.resize(0);
+}
+
+size_t ADScene::scratchMemorySize() const
+{
+    return voxels_.capacity() * sizeof(Voxel)
+            + polygonsDescriptors_.capacity() * sizeof(AD::PolygonDescriptor)
+            + polygonsDescriptorsAddresses_.capacity() * sizeof(PsxRamAddress)
+            + adVertices_.capacity() * sizeof(AD::Point3D);
 }
 
 ADScene::Voxel const* ADScene::yAxisVoxels(uint16_t y) const
-{ return voxels_.get() + voxelIndex(0, y); }
+{ return voxels_.constData() + voxelIndex(0, y); }
 
 AD::Point3D const& ADScene::adVertex(uint16_t vertexIndex) const
-{ return adVertices_[vertexIndex]; }
+{ return adVertices_.constData()[vertexIndex]; }
 
 void ADScene::read(BufferedPsxRam const& psxRam, QByteArray const& psxVRam)
 {
@@ -32,20 +44,20 @@ void ADScene::read(BufferedPsxRam const& psxRam, QByteArray const& psxVRam)
 
 uint16_t ADScene::readVoxels(BufferedPsxRam const& psxRam)
 {
-    log2VoxelsWidth_ = psxRam.readWord(0x80083350) & 0x1f;
-    log2VoxelsHeight_ = psxRam.readWord(0x80083352) & 0x1f;
+    log2VoxelsWidth_ = psxRam.readWord(ADSceneConst::LOG2_VOXELS_WIDTH_ADDRESS) & ADSceneConst::LOG2_VOXELS_SIZE_MASK;
+    log2VoxelsHeight_ = psxRam.readWord(ADSceneConst::LOG2_VOXELS_HEIGHT_ADDRESS) & ADSceneConst::LOG2_VOXELS_SIZE_MASK;
     minVoxelX_ = 0x0;
-    maxVoxelX_ = psxRam.readSWord(0x80083354);
+    maxVoxelX_ = psxRam.readSWord(ADSceneConst::MAX_VOXEL_X_ADDRESS);
     minVoxelY_ = 0x0;
-    maxVoxelY_ = psxRam.readSWord(0x80083356);
+    maxVoxelY_ = psxRam.readSWord(ADSceneConst::MAX_VOXEL_Y_ADDRESS);
     auto voxelsNumber = (maxVoxelY_ - minVoxelY_ + 1) << log2VoxelsWidth_;
-    voxels_ = std::make_unique<Voxel[]>(voxelsNumber);
-    auto const* adVoxels = psxRam.readAsPointer<AD::Voxel>(psxRam.readAddress(0x8008333c));
+    voxels_.fill({false, 0, 0}, voxelsNumber);
+    auto const* adVoxels = psxRam.readAsPointer<AD::Voxel>(psxRam.readAddress(ADSceneConst::VOXELS_ADDRESS_POINTER));
     uint16_t maxVertexIndex = 0;
     for (uint16_t voxelY = minVoxelY_; voxelY <= maxVoxelY_; ++voxelY)
     {
         auto const* adVoxelIt = adVoxels + (voxelY << log2VoxelsWidth_) + minVoxelX_;
-        auto* voxelIt = voxels_.get() + ((voxelY - minVoxelY_) << log2VoxelsWidth_);
+        auto* voxelIt = voxels_.data() + ((voxelY - minVoxelY_) << log2VoxelsWidth_);
         for (uint16_t voxelX = minVoxelX_; voxelX <= maxVoxelX_; ++voxelX, ++adVoxelIt, ++voxelIt)
         { readVoxel(psxRam, *adVoxelIt, *voxelIt, maxVertexIndex); }
     }
@@ -57,18 +69,26 @@ void ADScene::readVoxel(BufferedPsxRam const& psxRam, AD::Voxel const& adVoxel,
     if (adVoxel.polygonsDescriptorsIndex == 0)
     { return; }
     voxel.drawVoxelPolygon = adVoxel.flags() != AD::VoxelFlags::DoNotDrawBackground;
-    auto const* polygonsDescriptorsPtrArray = psxRam.readAsPointer<PsxRamAddress>(psxRam.readAddress(0x80083340));
+    auto const* polygonsDescriptorsPtrArray = psxRam.readAsPointer<PsxRamAddress>(psxRam.readAddress(ADSceneConst::POLYGONS_DESCRIPTORS_ADDRESSES_POINTER));
     auto polygonDescriptorItAddress = polygonsDescriptorsPtrArray[adVoxel.polygonsDescriptorsIndex];
-    auto const* polygonDescriptorIt = psxRam.readAsPointer<AD::PolygonDescriptor>(polygonDescriptorItAddress);
+    auto const* firstPolygonDescriptor = psxRam.readAsPointer<AD::PolygonDescriptor>(polygonDescriptorItAddress);
+    auto const* polygonDescriptorIt = firstPolygonDescriptor;
+    voxel.firstPolygonIndex = polygonsDescriptors_.count();
     while (polygonDescriptorIt != nullptr)
     {
         polygonDescriptorIt = moveToNextDrawablePolygon(polygonDescriptorIt);
         if (polygonDescriptorIt == nullptr)
         { continue; }
-        voxel.polygonsDescriptors.append(*polygonDescriptorIt);
+        polygonsDescriptors_.append(*polygonDescriptorIt);
+        if (polygonDescriptorIt->flags.isSemiTransparent())
+        { ++semiTransparentPolygonsNumber_; }
+        polygonsDescriptorsAddresses_.append(
+                    polygonDescriptorItAddress +
+                    static_cast<uint32_t>((polygonDescriptorIt - firstPolygonDescriptor) * sizeof(AD::PolygonDescriptor)));
         maxVertexIndex = qMax(maxVertexIndex, maxPolygonVertexIndex(polygonDescriptorIt));
         polygonDescriptorIt = moveToNextPolygon(polygonDescriptorIt);
     }
+    voxel.polygonsNumber = polygonsDescriptors_.count() - voxel.firstPolygonIndex;
 }
 
 AD::PolygonDescriptor const* ADScene::moveToNextDrawablePolygon(AD::PolygonDescriptor const* polygonDescriptorIt)
@@ -94,10 +114,9 @@ AD::PolygonDescriptor const* ADScene::moveToNextPolygon(AD::PolygonDescriptor co
 
 void ADScene::readVertices(BufferedPsxRam const& psxRam, uint16_t maxVertexIndex)
 {
-    auto verticesAddress = psxRam.readAddress(0x80083344);
-    adVerticesNumber_ = maxVertexIndex + 1;
-    adVertices_ = std::make_unique<AD::Point3D[]>(adVerticesNumber_);
+    auto verticesAddress = psxRam.readAddress(ADSceneConst::VERTICES_ADDRESS_POINTER);
+    adVertices_.resize(maxVertexIndex + 1);
     psxRam.readRegion(
-                {verticesAddress, static_cast<uint32_t>(sizeof(AD::Point3D)) * adVerticesNumber_},
-                reinterpret_cast<uint8_t*>(adVertices_.get()));
+                {verticesAddress, static_cast<uint32_t>(sizeof(AD::Point3D) * adVertices_.count())},
+                reinterpret_cast<uint8_t*>(adVertices_.data()));
 }
@@ -4,15 +4,18 @@
 #include "ADDefinitions.hpp"
 #include "BufferedPsxRam.hpp"
 #include <QVector>
-#include <memory>
 
+// Parsed scene. Voxels, polygons descriptors and vertices live in flat buffers which keep their capacity
+// between reads, so reading scenes over and over with the same ADScene allocates only when a scene is
+// bigger than every previous one.
 class ADScene
 {
 public:
     struct Voxel
     {
         bool drawVoxelPolygon;
-        QVector<AD::PolygonDescriptor> polygonsDescriptors;
+        uint32_t firstPolygonIndex;
+        uint32_t polygonsNumber;
     };
 
     ADScene();
@@ -22,7 +25,17 @@ public:
     uint32_t height() const
     { return (maxVoxelY_ -minVoxelY_) + 1; }
     Voxel const* yAxisVoxels(uint16_t y) const;
+    AD::PolygonDescriptor const* polygonsDescriptors(Voxel const& voxel) const
+    { return polygonsDescriptors_.constData() + voxel.firstPolygonIndex; }
+    PsxRamAddress const* polygonsDescriptorsAddresses(Voxel const& voxel) const
+    { return polygonsDescriptorsAddresses_.constData() + voxel.firstPolygonIndex; }
+    uint32_t polygonsNumber() const
+    { return polygonsDescriptors_.count(); }
+    uint32_t semiTransparentPolygonsNumber() const
+    { return semiTransparentPolygonsNumber_; }
     AD::Point3D const& adVertex(uint16_t vertexIndex) const;
+    // Bytes held by the scene buffers, i.e. the biggest scene read so far.
+    size_t scratchMemorySize() const;
     void read(BufferedPsxRam const& psxRam, QByteArray const& psxVRam);
     QByteArray const& rawVRam() const
     { return rawVRam_; }
@@ -49,9 +62,11 @@ private:
     int16_t maxVoxelY_;
     uint8_t log2VoxelsWidth_;
     uint8_t log2VoxelsHeight_;
-    std::unique_ptr<Voxel[]> voxels_;
-    std::unique_ptr<AD::Point3D[]> adVertices_;
-    uint32_t adVerticesNumber_;
+    QVector<Voxel> voxels_;
+    QVector<AD::PolygonDescriptor> polygonsDescriptors_;
+    QVector<PsxRamAddress> polygonsDescriptorsAddresses_;
+    uint32_t semiTransparentPolygonsNumber_;
+    QVector<AD::Point3D> adVertices_;
     QByteArray rawVRam_;
 };
 
@@ -0,0 +1,24 @@
+#ifndef ADSCENECONST_HPP
+#define ADSCENECONST_HPP
+
+#include "PsxRamAddress.hpp"
+
+struct ADSceneConst
+{
+    static constexpr PsxRamAddress::Raw const VOXELS_ADDRESS_POINTER = 0x8008333c;
+    static constexpr PsxRamAddress::Raw const POLYGONS_DESCRIPTORS_ADDRESSES_POINTER = 0x80083340;
+    static constexpr PsxRamAddress::Raw const VERTICES_ADDRESS_POINTER = 0x80083344;
+    static constexpr PsxRamAddress::Raw const LOG2_VOXELS_WIDTH_ADDRESS = 0x80083350;
+    static constexpr PsxRamAddress::Raw const LOG2_VOXELS_HEIGHT_ADDRESS = 0x80083352;
+    static constexpr PsxRamAddress::Raw const MAX_VOXEL_X_ADDRESS = 0x80083354;
+    static constexpr PsxRamAddress::Raw const MAX_VOXEL_Y_ADDRESS = 0x80083356;
+    static constexpr uint16_t const LOG2_VOXELS_SIZE_MASK = 0x1f;
+    static constexpr uint16_t const MAX_POLYGONS_DESCRIPTORS_INDEX = (1 << 14) - 1;
+    static constexpr uint32_t const MAX_VERTICES_NUMBER = 1 << 16;
+    static constexpr int16_t const VOXEL_SIZE = 0x40;
+    static constexpr int16_t const HALF_VOXEL_SIZE = VOXEL_SIZE / 2;
+
+    ADSceneConst() = delete;
+};
+
+#endif // ADSCENECONST_HPP
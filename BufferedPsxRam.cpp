@@ -5,9 +5,15 @@
 BufferedPsxRam::BufferedPsxRam()
 { ram_.fill(0); }
 
+void BufferedPsxRam::clear()
+{ ram_.fill(0); }
+
 void BufferedPsxRam::fill(char const* ram)
 { std::memcpy(ram_.data(), ram, ram_.size()); }
 
+void BufferedPsxRam::dump(char* ram) const
+{ std::memcpy(ram, ram_.data(), ram_.size()); }
+
 uint8_t BufferedPsxRam::readByte(PsxRamAddress address) const
 { return *readAsPointer<uint8_t>(address); }
 
@@ -39,6 +45,28 @@ void BufferedPsxRam::readRegion(
     std::memcpy(buffer, inBufferPointer(inPsxRamAddress), region.size);
 }
 
+void BufferedPsxRam::writeByte(PsxRamAddress address, uint8_t value)
+{ *writeAsPointer<uint8_t>(address) = value; }
+
+void BufferedPsxRam::writeWord(PsxRamAddress address, uint16_t value)
+{ *writeAsPointer<uint16_t>(address) = value; }
+
+void BufferedPsxRam::writeDWord(PsxRamAddress address, uint32_t value)
+{ *writeAsPointer<uint32_t>(address) = value; }
+
+void BufferedPsxRam::writeAddress(PsxRamAddress address, PsxRamAddress value)
+{ *writeAsPointer<PsxRamAddress::Raw>(address) = value.raw(); }
+
+void BufferedPsxRam::writeRegion(
+        PsxRamAddress::Region const& region,
+        uint8_t const* buffer)
+{
+    PsxRamAddress inPsxRamAddress = PsxRamConst::toNoSegRamAddress(region.address);
+    if (!isInPsxRamRegion(inPsxRamAddress, region.size))
+    { throwWriteOutOfBoundsError(region.address, region.size); }
+    std::memcpy(inBufferPointer(inPsxRamAddress), buffer, region.size);
+}
+
 bool BufferedPsxRam::isInPsxRamRegion(
         PsxRamAddress address,
         uint32_t size) const
@@ -14,7 +14,9 @@ class BufferedPsxRam
 public:
     BufferedPsxRam();
 
+    void clear();
     void fill(char const* ram);
+    void dump(char* ram) const;
     uint8_t readByte(PsxRamAddress address) const;
     int8_t readSBbyte(PsxRamAddress address) const;
     uint16_t readWord(PsxRamAddress address) const;
@@ -32,6 +34,20 @@ public:
     }
     PsxRamAddress readAddress(PsxRamAddress address) const;
     void readRegion(PsxRamAddress::Region const& region, uint8_t* buffer) const;
+    void writeByte(PsxRamAddress address, uint8_t value);
+    void writeWord(PsxRamAddress address, uint16_t value);
+    void writeDWord(PsxRamAddress address, uint32_t value);
+    template <typename T>
+    T* writeAsPointer(PsxRamAddress address)
+    {
+        constexpr uint32_t const size = sizeof(T);
+        PsxRamAddress inPsxRamAddress = PsxRamConst::toNoSegRamAddress(address);
+        if (!isInPsxRamRegion(inPsxRamAddress, size))
+        { throwWriteOutOfBoundsError(address, size); }
+        return reinterpret_cast<T*>(inBufferPointer(inPsxRamAddress));
+    }
+    void writeAddress(PsxRamAddress address, PsxRamAddress value);
+    void writeRegion(PsxRamAddress::Region const& region, uint8_t const* buffer);
 
 private:
     constexpr std::size_t size() const
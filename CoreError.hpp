@@ -0,0 +1,29 @@
+#ifndef COREERROR_HPP
+#define COREERROR_HPP
+
+#include <QString>
+
+enum class CoreErrorCode
+{
+    OK = 0,
+    FILE_OPEN_FAILED,
+    FILE_READ_FAILED,
+    INVALID_DUMP_SIZE,
+    UNSUPPORTED_FORMAT,
+    SCENE_READ_FAILED,
+    SCENE_NOT_READ,
+    OUT_OF_MEMORY
+};
+
+struct CoreError
+{
+    CoreErrorCode code;
+    QString message;
+
+    static CoreError ok()
+    { return {CoreErrorCode::OK, {}}; }
+    bool isOk() const
+    { return code == CoreErrorCode::OK; }
+};
+
+#endif // COREERROR_HPP
@@ -0,0 +1,175 @@
+#include "DumpCatalog.hpp"
+#include <QDir>
+#include <QHash>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(DumpCatalogRecord) % 8 == 0, "Catalog records have to keep 8 byte alignment.");
+
+QByteArray const DumpCatalog::MAGIC("VMCATL01", 8);
+QString const DumpCatalog::DEFAULT_FILE_NAME("VirtualMonsbaia.vmcat");
+
+int DumpCatalogRecord::texpagesNumber() const
+{
+    int texpagesNumber = 0;
+    for (auto mask = texpagesMask; mask != 0; mask &= mask - 1)
+    { ++texpagesNumber; }
+    return texpagesNumber;
+}
+
+DumpCatalog::DumpCatalog()
+    : data_{nullptr},
+      size_{0},
+      records_{nullptr},
+      recordsNumber_{0},
+      strings_{nullptr},
+      stringsSize_{0}
+{}
+
+DumpCatalog::~DumpCatalog()
+{ close(); }
+
+void DumpCatalog::open(QString const& filePath)
+{
+    close();
+    file_.setFileName(filePath);
+    if (!file_.open(QFile::ReadOnly))
+    { throw QString("Could not open file %1.").arg(filePath); }
+    size_ = file_.size();
+    data_ = size_ >= HEADER_SIZE ? file_.map(0, size_) : nullptr;
+    if (data_ == nullptr || QByteArray::fromRawData(reinterpret_cast<char const*>(data_), MAGIC.size()) != MAGIC)
+    {
+        close();
+        throw QString("File %1 is not a dump catalog.").arg(filePath);
+    }
+    uint32_t version;
+    uint32_t recordsNumber;
+    uint32_t rootPathOffset;
+    uint32_t rootPathSize;
+    uint64_t stringsOffset;
+    std::memcpy(&version, data_ + 8, 4);
+    std::memcpy(&recordsNumber, data_ + 12, 4);
+    std::memcpy(&rootPathOffset, data_ + 16, 4);
+    std::memcpy(&rootPathSize, data_ + 20, 4);
+    std::memcpy(&stringsOffset, data_ + 24, 8);
+    std::memcpy(&stringsSize_, data_ + 32, 8);
+    if (version != VERSION
+            || HEADER_SIZE + static_cast<uint64_t>(recordsNumber) * sizeof(DumpCatalogRecord) > stringsOffset
+            || stringsOffset + stringsSize_ > static_cast<uint64_t>(size_))
+    {
+        close();
+        throw QString("Dump catalog %1 is damaged or has unsupported version.").arg(filePath);
+    }
+    records_ = reinterpret_cast<DumpCatalogRecord const*>(data_ + HEADER_SIZE);
+    recordsNumber_ = recordsNumber;
+    strings_ = reinterpret_cast<char const*>(data_ + stringsOffset);
+    rootPath_ = string(rootPathOffset, rootPathSize);
+}
+
+void DumpCatalog::close()
+{
+    if (data_ != nullptr)
+    { file_.unmap(const_cast<uchar*>(data_)); }
+    file_.close();
+    data_ = nullptr;
+    size_ = 0;
+    records_ = nullptr;
+    recordsNumber_ = 0;
+    strings_ = nullptr;
+    stringsSize_ = 0;
+    rootPath_.clear();
+}
+
+QString DumpCatalog::string(uint32_t offset, uint32_t size) const
+{
+    if (static_cast<uint64_t>(offset) + size > stringsSize_)
+    { return {}; }
+    return QString::fromUtf8(strings_ + offset, size);
+}
+
+QString DumpCatalog::relativePath(int index) const
+{ return string(records_[index].pathOffset, records_[index].pathSize); }
+
+QString DumpCatalog::filePath(int index) const
+{ return QDir(rootPath_).filePath(relativePath(index)); }
+
+int DumpCatalog::findRecord(QString const& relativePath) const
+{
+    int first = 0;
+    int last = recordsNumber_;
+    while (first < last)
+    {
+        int middle = (first + last) / 2;
+        if (this->relativePath(middle) < relativePath)
+        { first = middle + 1; }
+        else
+        { last = middle; }
+    }
+    return first < recordsNumber_ && this->relativePath(first) == relativePath ? first : -1;
+}
+
+uint64_t DumpCatalog::hash(void const* data, size_t size, uint64_t hash)
+{
+    static constexpr uint64_t const PRIME = 0x100000001b3;
+    auto const* bytes = static_cast<uint8_t const*>(data);
+    for (size_t byteIndex = 0; byteIndex < size; ++byteIndex)
+    {
+        hash ^= bytes[byteIndex];
+        hash *= PRIME;
+    }
+    return hash;
+}
+
+int DumpCatalog::write(QString const& filePath, QString const& rootPath, QVector<Entry> entries)
+{
+    std::sort(entries.begin(), entries.end(), [](Entry const& one, Entry const& other) {
+        return one.relativePath < other.relativePath;
+    });
+    QByteArray strings = rootPath.toUtf8();
+    QHash<uint64_t, int> contentsRecords;
+    int duplicatesNumber = 0;
+    for (int entryIndex = 0; entryIndex < entries.count(); ++entryIndex)
+    {
+        auto& record = entries[entryIndex].record;
+        auto path = entries[entryIndex].relativePath.toUtf8();
+        record.pathOffset = strings.size();
+        record.pathSize = path.size();
+        strings.append(path);
+        record.duplicateOf = -1;
+        if (!record.isSceneRead())
+        { continue; }
+        auto contentsHash = hash(record.vramPagesHashes, sizeof(record.vramPagesHashes), record.sceneHash);
+        auto contentsRecordIt = contentsRecords.constFind(contentsHash);
+        if (contentsRecordIt != contentsRecords.constEnd())
+        {
+            record.duplicateOf = contentsRecordIt.value();
+            ++duplicatesNumber;
+        }
+        else
+        { contentsRecords.insert(contentsHash, entryIndex); }
+    }
+    uint32_t version = VERSION;
+    uint32_t recordsNumber = entries.count();
+    uint32_t rootPathOffset = 0;
+    uint32_t rootPathSize = rootPath.toUtf8().size();
+    uint64_t stringsOffset = HEADER_SIZE + static_cast<uint64_t>(recordsNumber) * sizeof(DumpCatalogRecord);
+    uint64_t stringsSize = strings.size();
+    QByteArray header(MAGIC);
+    header.append(reinterpret_cast<char const*>(&version), 4);
+    header.append(reinterpret_cast<char const*>(&recordsNumber), 4);
+    header.append(reinterpret_cast<char const*>(&rootPathOffset), 4);
+    header.append(reinterpret_cast<char const*>(&rootPathSize), 4);
+    header.append(reinterpret_cast<char const*>(&stringsOffset), 8);
+    header.append(reinterpret_cast<char const*>(&stringsSize), 8);
+    QSaveFile file(filePath);
+    if (!file.open(QFile::WriteOnly))
+    { throw QString("Could not create file %1.").arg(filePath); }
+    file.write(header);
+    for (auto const& entry : entries)
+    { file.write(reinterpret_cast<char const*>(&entry.record), sizeof(DumpCatalogRecord)); }
+    file.write(strings);
+    if (!file.commit())
+    { throw QString("Could not write file %1.").arg(filePath); }
+    return duplicatesNumber;
+}
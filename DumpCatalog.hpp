@@ -0,0 +1,103 @@
+#ifndef DUMPCATALOG_HPP
+#define DUMPCATALOG_HPP
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+// Summary of one AD 3D model (*.3dm) in a catalog. Fixed size, so the records can be read in place.
+struct DumpCatalogRecord
+{
+    static constexpr int const VRAM_PAGES_NUMBER = 32;
+
+    enum Flags : uint32_t
+    {
+        SCENE_READ = 1,
+        // The file could not be scanned, it is scanned again once its size or modification time change.
+        SCAN_FAILED = 2
+    };
+
+    int64_t modificationTimeMs;
+    uint64_t fileSize;
+    uint32_t pathOffset;
+    uint32_t pathSize;
+    uint32_t flags;
+    // Index of the first record with the same scene and VRAM contents, -1 for unique dumps.
+    int32_t duplicateOf;
+    uint16_t voxelsWidth;
+    uint16_t voxelsHeight;
+    uint32_t polygonsNumber;
+    uint32_t semiTransparentPolygonsNumber;
+    uint32_t verticesNumber;
+    // Bit x + 16 * y is set for every texpage used by a polygon.
+    uint32_t texpagesMask;
+    uint32_t reserved;
+    // Hash of the scene header, voxels, polygons descriptors and vertices.
+    uint64_t sceneHash;
+    // Hashes of the VRAM texpages, 64x256 pixels each, in texpage number order.
+    uint64_t vramPagesHashes[VRAM_PAGES_NUMBER];
+
+    bool isSceneRead() const
+    { return (flags & SCENE_READ) != 0; }
+    bool isScanFailed() const
+    { return (flags & SCAN_FAILED) != 0; }
+    int texpagesNumber() const;
+};
+
+// Catalog file (*.vmcat) of the AD 3D models under a directory, laid out to be mapped and read in place.
+// All numbers little endian: header (magic, version u32, records number u32, root path offset u32,
+// root path size u32, strings offset u64, strings size u64), records sorted by relative path, then the
+// UTF-8 strings the header and records refer to.
+class DumpCatalog
+{
+public:
+    struct Entry
+    {
+        QString relativePath;
+        DumpCatalogRecord record;
+    };
+
+    static QByteArray const MAGIC;
+    static QString const DEFAULT_FILE_NAME;
+    static constexpr uint32_t const VERSION = 1;
+    static constexpr uint32_t const HEADER_SIZE = 8 + 4 + 4 + 4 + 4 + 8 + 8;
+    static constexpr uint64_t const HASH_OFFSET_BASIS = 0xcbf29ce484222325;
+
+    DumpCatalog();
+    ~DumpCatalog();
+
+    void open(QString const& filePath);
+    void close();
+    bool isOpen() const
+    { return records_ != nullptr; }
+    QString const& rootPath() const
+    { return rootPath_; }
+    int recordsNumber() const
+    { return recordsNumber_; }
+    DumpCatalogRecord const& record(int index) const
+    { return records_[index]; }
+    QString relativePath(int index) const;
+    QString filePath(int index) const;
+    int findRecord(QString const& relativePath) const;
+
+    // Returns the number of records marked as duplicates.
+    static int write(QString const& filePath, QString const& rootPath, QVector<Entry> entries);
+    // 64-bit FNV-1a, chainable through the hash argument.
+    static uint64_t hash(void const* data, size_t size, uint64_t hash = HASH_OFFSET_BASIS);
+
+private:
+    QString string(uint32_t offset, uint32_t size) const;
+
+    QFile file_;
+    uchar const* data_;
+    qint64 size_;
+    DumpCatalogRecord const* records_;
+    int recordsNumber_;
+    char const* strings_;
+    uint64_t stringsSize_;
+    QString rootPath_;
+};
+
+#endif // DUMPCATALOG_HPP
@@ -0,0 +1,45 @@
+#include "DumpCatalogDialog.hpp"
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QLineEdit>
+#include <QTableView>
+#include <QVBoxLayout>
+
+DumpCatalogDialog::DumpCatalogDialog(QWidget* parent)
+    : QDialog(parent),
+      filterEdit_(new QLineEdit(this)),
+      tableView_(new QTableView(this))
+{
+    filterModel_.setSourceModel(&model_);
+    filterModel_.setFilterCaseSensitivity(Qt::CaseInsensitive);
+    filterModel_.setFilterKeyColumn(-1);
+    filterEdit_->setPlaceholderText("Filter");
+    filterEdit_->setClearButtonEnabled(true);
+    connect(filterEdit_, &QLineEdit::textChanged, &filterModel_, &QSortFilterProxyModel::setFilterFixedString);
+    tableView_->setModel(&filterModel_);
+    tableView_->setSortingEnabled(true);
+    tableView_->sortByColumn(DumpCatalogModel::PATH_COLUMN, Qt::AscendingOrder);
+    tableView_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    tableView_->setSelectionMode(QAbstractItemView::SingleSelection);
+    tableView_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tableView_->verticalHeader()->hide();
+    tableView_->horizontalHeader()->setStretchLastSection(true);
+    connect(tableView_, &QTableView::activated, this, &DumpCatalogDialog::activateRow);
+    auto* layout = new QVBoxLayout(this);
+    layout->addWidget(filterEdit_);
+    layout->addWidget(tableView_);
+    resize(900, 500);
+}
+
+void DumpCatalogDialog::showCatalog(QString const& catalogPath)
+{
+    model_.open(catalogPath);
+    setWindowTitle(QString("Dump archive %1").arg(QFileInfo(catalogPath).absolutePath()));
+    tableView_->resizeColumnsToContents();
+}
+
+void DumpCatalogDialog::closeCatalog()
+{ model_.close(); }
+
+void DumpCatalogDialog::activateRow(QModelIndex const& index)
+{ emit dumpActivated(model_.filePath(filterModel_.mapToSource(index).row())); }
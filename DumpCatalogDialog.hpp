@@ -0,0 +1,34 @@
+#ifndef DUMPCATALOGDIALOG_HPP
+#define DUMPCATALOGDIALOG_HPP
+
+#include "DumpCatalogModel.hpp"
+#include <QDialog>
+#include <QSortFilterProxyModel>
+
+class QLineEdit;
+class QTableView;
+
+// Filterable list of the dumps in a catalog. Activating a row requests the dump to be opened.
+class DumpCatalogDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DumpCatalogDialog(QWidget* parent = nullptr);
+
+    void showCatalog(QString const& catalogPath);
+    void closeCatalog();
+
+signals:
+    void dumpActivated(QString const& filePath);
+
+private:
+    void activateRow(QModelIndex const& index);
+
+    DumpCatalogModel model_;
+    QSortFilterProxyModel filterModel_;
+    QLineEdit* filterEdit_;
+    QTableView* tableView_;
+};
+
+#endif // DUMPCATALOGDIALOG_HPP
@@ -0,0 +1,97 @@
+#include "DumpCatalog.hpp"
+#include "DumpCatalogIndexer.hpp"
+#include "DumpSceneScanner.hpp"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <cstring>
+
+QString DumpCatalogIndexer::defaultCatalogPath(QString const& rootPath)
+{ return QDir(rootPath).filePath(DumpCatalog::DEFAULT_FILE_NAME); }
+
+DumpCatalogIndexer::Statistics DumpCatalogIndexer::index(QString const& rootPath, QString const& catalogPath)
+{
+    errors_.clear();
+    QDir rootDirectory(rootPath);
+    if (!rootDirectory.exists())
+    { throw QString("Directory %1 does not exist.").arg(rootPath); }
+    auto canonicalRootPath = rootDirectory.canonicalPath();
+    rootDirectory.setPath(canonicalRootPath);
+    Statistics statistics{0, 0, 0, 0, 0};
+    DumpCatalog previousCatalog;
+    if (QFileInfo::exists(catalogPath))
+    {
+        try
+        { previousCatalog.open(catalogPath); }
+        catch (QString const& error)
+        { errors_.append(QString("%1 Indexing from scratch.").arg(error)); }
+    }
+    bool isPreviousCatalogUsable = previousCatalog.isOpen() && previousCatalog.rootPath() == canonicalRootPath;
+    QVector<DumpCatalog::Entry> entries;
+    QVector<int> scannedEntriesIndices;
+    QDirIterator fileIt(canonicalRootPath, {"*.3dm"}, QDir::Files, QDirIterator::Subdirectories);
+    while (fileIt.hasNext())
+    {
+        fileIt.next();
+        auto fileInfo = fileIt.fileInfo();
+        DumpCatalog::Entry entry;
+        entry.relativePath = rootDirectory.relativeFilePath(fileInfo.filePath());
+        auto recordIndex = isPreviousCatalogUsable ? previousCatalog.findRecord(entry.relativePath) : -1;
+        if (recordIndex >= 0
+                && previousCatalog.record(recordIndex).fileSize == static_cast<uint64_t>(fileInfo.size())
+                && previousCatalog.record(recordIndex).modificationTimeMs
+                    == fileInfo.lastModified().toMSecsSinceEpoch())
+        {
+            entry.record = previousCatalog.record(recordIndex);
+            ++statistics.reusedRecordsNumber;
+            if (entry.record.isScanFailed())
+            {
+                errors_.append(QString("%1 failed to scan before and is unchanged.").arg(fileInfo.filePath()));
+                ++statistics.failedFilesNumber;
+            }
+        }
+        else
+        {
+            scannedEntriesIndices.append(entries.count());
+            entry.record.fileSize = fileInfo.size();
+            entry.record.modificationTimeMs = fileInfo.lastModified().toMSecsSinceEpoch();
+        }
+        entries.append(entry);
+    }
+    // The catalog file is replaced below, which fails on some systems while it is mapped.
+    previousCatalog.close();
+    statistics.filesNumber = entries.count();
+    statistics.scannedFilesNumber = scannedEntriesIndices.count();
+    QVector<QString> scanErrors(entries.count());
+    auto* entriesData = entries.data();
+    auto* scanErrorsData = scanErrors.data();
+    // Failed files stay in the catalog with the size and modification time they were listed with, so they are
+    // not scanned again until they change.
+    QtConcurrent::blockingMap(scannedEntriesIndices, [&](int entryIndex) {
+        auto& record = entriesData[entryIndex].record;
+        auto fileSize = record.fileSize;
+        auto modificationTimeMs = record.modificationTimeMs;
+        scanErrorsData[entryIndex] = DumpSceneScanner::scan(
+                    QDir(canonicalRootPath).filePath(entriesData[entryIndex].relativePath), record);
+        if (!scanErrorsData[entryIndex].isEmpty())
+        {
+            std::memset(&record, 0, sizeof(record));
+            record.fileSize = fileSize;
+            record.modificationTimeMs = modificationTimeMs;
+            record.flags = DumpCatalogRecord::SCAN_FAILED;
+            record.duplicateOf = -1;
+        }
+    });
+    for (auto const& scanError : scanErrors)
+    {
+        if (!scanError.isEmpty())
+        {
+            errors_.append(scanError);
+            ++statistics.failedFilesNumber;
+        }
+    }
+    statistics.duplicatesNumber = DumpCatalog::write(catalogPath, canonicalRootPath, std::move(entries));
+    return statistics;
+}
@@ -0,0 +1,30 @@
+#ifndef DUMPCATALOGINDEXER_HPP
+#define DUMPCATALOGINDEXER_HPP
+
+#include <QString>
+#include <QStringList>
+
+// Builds or refreshes the catalog of all AD 3D models (*.3dm) under a directory. Files with the same size
+// and modification time as in the previous catalog keep their records, the rest are scanned in parallel.
+class DumpCatalogIndexer
+{
+public:
+    struct Statistics
+    {
+        int filesNumber;
+        int scannedFilesNumber;
+        int reusedRecordsNumber;
+        int failedFilesNumber;
+        int duplicatesNumber;
+    };
+
+    static QString defaultCatalogPath(QString const& rootPath);
+    Statistics index(QString const& rootPath, QString const& catalogPath);
+    QStringList const& errors() const
+    { return errors_; }
+
+private:
+    QStringList errors_;
+};
+
+#endif // DUMPCATALOGINDEXER_HPP
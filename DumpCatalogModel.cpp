@@ -0,0 +1,93 @@
+#include "DumpCatalogModel.hpp"
+#include <QDateTime>
+
+DumpCatalogModel::DumpCatalogModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{}
+
+void DumpCatalogModel::open(QString const& catalogPath)
+{
+    beginResetModel();
+    try
+    { catalog_.open(catalogPath); }
+    catch (QString const&)
+    {
+        endResetModel();
+        throw;
+    }
+    endResetModel();
+}
+
+void DumpCatalogModel::close()
+{
+    beginResetModel();
+    catalog_.close();
+    endResetModel();
+}
+
+int DumpCatalogModel::rowCount(QModelIndex const& parent) const
+{ return parent.isValid() ? 0 : catalog_.recordsNumber(); }
+
+int DumpCatalogModel::columnCount(QModelIndex const& parent) const
+{ return parent.isValid() ? 0 : COLUMNS_NUMBER; }
+
+QVariant DumpCatalogModel::data(QModelIndex const& index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
+    { return {}; }
+    auto const& record = catalog_.record(index.row());
+    if (index.column() == PATH_COLUMN)
+    { return role == Qt::ToolTipRole ? catalog_.filePath(index.row()) : catalog_.relativePath(index.row()); }
+    if (index.column() == MODIFIED_COLUMN)
+    { return QDateTime::fromMSecsSinceEpoch(record.modificationTimeMs); }
+    if (!record.isSceneRead())
+    {
+        if (index.column() != GRID_COLUMN)
+        { return {}; }
+        return record.isScanFailed() ? "scan failed" : "not read";
+    }
+    switch (index.column())
+    {
+    case GRID_COLUMN:
+        return QString("%1x%2").arg(record.voxelsWidth).arg(record.voxelsHeight);
+    case POLYGONS_COLUMN:
+        return record.polygonsNumber;
+    case SEMI_TRANSPARENT_POLYGONS_COLUMN:
+        return record.semiTransparentPolygonsNumber;
+    case VERTICES_COLUMN:
+        return record.verticesNumber;
+    case TEXPAGES_COLUMN:
+        return record.texpagesNumber();
+    case DUPLICATE_OF_COLUMN:
+        return record.duplicateOf >= 0 ? catalog_.relativePath(record.duplicateOf) : QString();
+    default:
+        return {};
+    }
+}
+
+QVariant DumpCatalogModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    { return QAbstractTableModel::headerData(section, orientation, role); }
+    switch (section)
+    {
+    case PATH_COLUMN:
+        return "Path";
+    case GRID_COLUMN:
+        return "Grid";
+    case POLYGONS_COLUMN:
+        return "Polygons";
+    case SEMI_TRANSPARENT_POLYGONS_COLUMN:
+        return "Semi-transparent";
+    case VERTICES_COLUMN:
+        return "Vertices";
+    case TEXPAGES_COLUMN:
+        return "Texpages";
+    case DUPLICATE_OF_COLUMN:
+        return "Duplicate of";
+    case MODIFIED_COLUMN:
+        return "Modified";
+    default:
+        return {};
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef DUMPCATALOGMODEL_HPP
+#define DUMPCATALOGMODEL_HPP
+
+#include "DumpCatalog.hpp"
+#include <QAbstractTableModel>
+
+// Table of the records of a mapped dump catalog; rows are read from the catalog on demand.
+class DumpCatalogModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        PATH_COLUMN,
+        GRID_COLUMN,
+        POLYGONS_COLUMN,
+        SEMI_TRANSPARENT_POLYGONS_COLUMN,
+        VERTICES_COLUMN,
+        TEXPAGES_COLUMN,
+        DUPLICATE_OF_COLUMN,
+        MODIFIED_COLUMN,
+        COLUMNS_NUMBER
+    };
+
+    explicit DumpCatalogModel(QObject* parent = nullptr);
+
+    void open(QString const& catalogPath);
+    // Unmaps the catalog, e.g. before it is replaced by indexing again.
+    void close();
+    QString filePath(int row) const
+    { return catalog_.filePath(row); }
+    int rowCount(QModelIndex const& parent = QModelIndex()) const override;
+    int columnCount(QModelIndex const& parent = QModelIndex()) const override;
+    QVariant data(QModelIndex const& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    DumpCatalog catalog_;
+};
+
+#endif // DUMPCATALOGMODEL_HPP
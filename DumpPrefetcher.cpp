@@ -0,0 +1,150 @@
+#include "DumpPrefetcher.hpp"
+#include "PsxRamConst.hpp"
+#include "PsxVRamConst.hpp"
+#include "SceneLoader.hpp"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+size_t DumpPrefetcher::Scene::memorySize() const
+{
+    return mesh.vertices.count() * sizeof(SceneMeshVertex)
+            + (mesh.opaquePolygonsIndices.count() + mesh.semiTransparentPolygonsIndices.count())
+                * sizeof(uint32_t)
+            + mesh.voxelsChunks.count() * sizeof(VoxelsChunk)
+            + mesh.polygonsSources.count() * sizeof(ScenePolygonSource)
+            + mesh.voxelsGrid.semiTransparentFirstIndices.count() * sizeof(uint32_t)
+            + mesh.voxelsGrid.chunksIndices.count() * sizeof(int32_t)
+            + vram.size();
+}
+
+DumpPrefetcher::DumpPrefetcher()
+    : depth_{DEFAULT_DEPTH},
+      memoryBudget_{DEFAULT_MEMORY_BUDGET},
+      lastSceneMemorySize_{PsxRamConst::SIZE + PsxVRamConst::SIZE},
+      hitsNumber_{0},
+      missesNumber_{0}
+{ threadPool_.setMaxThreadCount(depth_); }
+
+DumpPrefetcher::~DumpPrefetcher()
+{
+    clear();
+    threadPool_.waitForDone();
+}
+
+void DumpPrefetcher::setDepth(int depth)
+{
+    depth_ = qMax(0, depth);
+    threadPool_.setMaxThreadCount(qMax(1, depth_));
+}
+
+void DumpPrefetcher::prefetch(QStringList const& filePaths, int currentIndex, int direction)
+{
+    QStringList windowFilePaths;
+    for (int step = 1; step <= depth_; ++step)
+    {
+        auto fileIndex = currentIndex + step * direction;
+        if (fileIndex < 0 || fileIndex >= filePaths.count())
+        { break; }
+        windowFilePaths.append(filePaths[fileIndex]);
+    }
+    for (int entryIndex = entries_.count() - 1; entryIndex >= 0; --entryIndex)
+    {
+        if (!windowFilePaths.contains(entries_[entryIndex].filePath))
+        { dropEntry(entryIndex); }
+    }
+    // Nearest first, so the next step is the first to be ready.
+    for (auto const& filePath : windowFilePaths)
+    {
+        if (findEntry(filePath) >= 0)
+        { continue; }
+        if (estimatedMemorySize() + lastSceneMemorySize_ > memoryBudget_)
+        { break; }
+        auto isCanceled = std::make_shared<std::atomic<bool>>(false);
+        auto scene = QtConcurrent::run(&threadPool_, [filePath, isCanceled]() {
+            return prepare(filePath, *isCanceled);
+        });
+        entries_.append({filePath, scene, isCanceled});
+    }
+}
+
+std::shared_ptr<DumpPrefetcher::Scene> DumpPrefetcher::prepare(
+        QString const& filePath,
+        std::atomic<bool> const& isCanceled)
+{
+    if (isCanceled)
+    { return nullptr; }
+    QFileInfo fileInfo(filePath);
+    auto scene = std::make_shared<Scene>();
+    scene->fileSize = fileInfo.size();
+    scene->modificationTimeMs = fileInfo.lastModified().toMSecsSinceEpoch();
+    SceneLoader sceneLoader;
+    auto error = sceneLoader.loadDump(filePath);
+    if (error.isOk() && !isCanceled)
+    { error = sceneLoader.readScene(); }
+    if (error.isOk() && !isCanceled)
+    { error = sceneLoader.buildMesh(scene->mesh); }
+    if (!error.isOk() || isCanceled)
+    { return nullptr; }
+    scene->vram = sceneLoader.psxVRam();
+    return scene;
+}
+
+std::shared_ptr<DumpPrefetcher::Scene const> DumpPrefetcher::take(QString const& filePath)
+{
+    auto entryIndex = findEntry(filePath);
+    if (entryIndex < 0)
+    {
+        ++missesNumber_;
+        return nullptr;
+    }
+    auto entry = entries_.takeAt(entryIndex);
+    auto scene = entry.scene.result();
+    QFileInfo fileInfo(filePath);
+    if (scene == nullptr
+            || scene->fileSize != fileInfo.size()
+            || scene->modificationTimeMs != fileInfo.lastModified().toMSecsSinceEpoch())
+    {
+        ++missesNumber_;
+        return nullptr;
+    }
+    lastSceneMemorySize_ = scene->memorySize();
+    ++hitsNumber_;
+    return scene;
+}
+
+void DumpPrefetcher::clear()
+{
+    for (int entryIndex = entries_.count() - 1; entryIndex >= 0; --entryIndex)
+    { dropEntry(entryIndex); }
+}
+
+int DumpPrefetcher::findEntry(QString const& filePath) const
+{
+    for (int entryIndex = 0; entryIndex < entries_.count(); ++entryIndex)
+    {
+        if (entries_[entryIndex].filePath == filePath)
+        { return entryIndex; }
+    }
+    return -1;
+}
+
+void DumpPrefetcher::dropEntry(int entryIndex)
+{
+    // The job keeps its own reference to the flag and stops at its next step; its result is discarded.
+    *entries_[entryIndex].isCanceled = true;
+    entries_.removeAt(entryIndex);
+}
+
+size_t DumpPrefetcher::estimatedMemorySize() const
+{
+    size_t memorySize = 0;
+    for (auto const& entry : entries_)
+    {
+        if (entry.scene.isFinished() && entry.scene.result() != nullptr)
+        { memorySize += entry.scene.result()->memorySize(); }
+        else if (!entry.scene.isFinished())
+        { memorySize += lastSceneMemorySize_; }
+    }
+    return memorySize;
+}
@@ -0,0 +1,78 @@
+#ifndef DUMPPREFETCHER_HPP
+#define DUMPPREFETCHER_HPP
+
+#include "SceneMesh.hpp"
+#include <QByteArray>
+#include <QFuture>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+// Parses the dumps following the current one in the stepping direction on background threads into meshes
+// ready to upload. Scenes are only started while the prepared ones and an estimate for those in flight fit
+// the memory budget. Scenes leaving the prefetch window, e.g. when the direction changes, are dropped and
+// their parsing is cancelled at the next step boundary.
+class DumpPrefetcher
+{
+public:
+    static constexpr int const DEFAULT_DEPTH = 2;
+    static constexpr size_t const DEFAULT_MEMORY_BUDGET = 256 << 20;
+
+    struct Scene
+    {
+        SceneMesh mesh;
+        QByteArray vram;
+        qint64 fileSize;
+        qint64 modificationTimeMs;
+
+        size_t memorySize() const;
+    };
+
+    DumpPrefetcher();
+    ~DumpPrefetcher();
+
+    int depth() const
+    { return depth_; }
+    void setDepth(int depth);
+    size_t memoryBudget() const
+    { return memoryBudget_; }
+    void setMemoryBudget(size_t memoryBudget)
+    { memoryBudget_ = memoryBudget; }
+    // Prefetches up to depth() files of filePaths after currentIndex, going by direction (1 or -1).
+    void prefetch(QStringList const& filePaths, int currentIndex, int direction);
+    // The prepared scene of the file, waiting for it if still parsed. A miss, nullptr, if the file was not
+    // prefetched, failed to parse or changed since.
+    std::shared_ptr<Scene const> take(QString const& filePath);
+    void clear();
+    uint32_t hitsNumber() const
+    { return hitsNumber_; }
+    uint32_t missesNumber() const
+    { return missesNumber_; }
+
+private:
+    struct Entry
+    {
+        QString filePath;
+        QFuture<std::shared_ptr<Scene>> scene;
+        std::shared_ptr<std::atomic<bool>> isCanceled;
+    };
+
+    static std::shared_ptr<Scene> prepare(QString const& filePath, std::atomic<bool> const& isCanceled);
+    int findEntry(QString const& filePath) const;
+    void dropEntry(int entryIndex);
+    size_t estimatedMemorySize() const;
+
+    QThreadPool threadPool_;
+    QList<Entry> entries_;
+    int depth_;
+    size_t memoryBudget_;
+    // Memory size of the last prepared scene, the estimate for scenes in flight.
+    size_t lastSceneMemorySize_;
+    uint32_t hitsNumber_;
+    uint32_t missesNumber_;
+};
+
+#endif // DUMPPREFETCHER_HPP
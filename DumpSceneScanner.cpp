@@ -0,0 +1,166 @@
+#include "ADDefinitions.hpp"
+#include "ADSceneConst.hpp"
+#include "DumpSceneScanner.hpp"
+#include "PsxRamConst.hpp"
+#include "PsxVRamConst.hpp"
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <cstring>
+
+namespace
+{
+class MappedPsxRam
+{
+public:
+    explicit MappedPsxRam(uchar const* ram)
+        : ram_{ram}
+    {}
+
+    template <typename T>
+    T const* readAsPointer(PsxRamAddress::Raw address, uint32_t count = 1) const
+    {
+        auto size = static_cast<uint64_t>(sizeof(T)) * count;
+        auto offset = PsxRamConst::toNoSegRamAddress(address);
+        if (!PsxRamConst::isInPsxRamAddress(address) || offset + size > PsxRamConst::SIZE)
+        { throw QString("Scene data at 0x%1 is outside of PSX RAM.").arg(address, 8, 16, QChar('0')); }
+        return reinterpret_cast<T const*>(ram_ + offset);
+    }
+
+    template <typename T>
+    T read(PsxRamAddress::Raw address) const
+    {
+        T value;
+        std::memcpy(&value, readAsPointer<T>(address), sizeof(T));
+        return value;
+    }
+
+private:
+    uchar const* ram_;
+};
+}
+
+QString DumpSceneScanner::scan(QString const& filePath, DumpCatalogRecord& record)
+{
+    std::memset(&record, 0, sizeof(record));
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly))
+    { return QString("Could not open file %1.").arg(filePath); }
+    if (file.size() != PsxRamConst::SIZE + PsxVRamConst::SIZE)
+    { return QString("File %1 size %2 is not a dump size.").arg(filePath).arg(file.size()); }
+    auto const* data = file.map(0, file.size());
+    if (data == nullptr)
+    { return QString("Could not map file %1.").arg(filePath); }
+    record.fileSize = file.size();
+    record.modificationTimeMs = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+    record.duplicateOf = -1;
+    try
+    {
+        scanScene(data, record);
+        record.flags |= DumpCatalogRecord::SCENE_READ;
+    }
+    catch (QString const&)
+    {
+        record.voxelsWidth = record.voxelsHeight = 0;
+        record.polygonsNumber = record.semiTransparentPolygonsNumber = record.verticesNumber = 0;
+        record.texpagesMask = 0;
+        record.sceneHash = 0;
+    }
+    scanVRam(data + PsxRamConst::SIZE, record);
+    file.unmap(const_cast<uchar*>(data));
+    return {};
+}
+
+void DumpSceneScanner::scanScene(uchar const* ram, DumpCatalogRecord& record)
+{
+    MappedPsxRam psxRam(ram);
+    auto log2VoxelsWidth = psxRam.read<uint16_t>(ADSceneConst::LOG2_VOXELS_WIDTH_ADDRESS)
+            & ADSceneConst::LOG2_VOXELS_SIZE_MASK;
+    auto maxVoxelX = psxRam.read<int16_t>(ADSceneConst::MAX_VOXEL_X_ADDRESS);
+    auto maxVoxelY = psxRam.read<int16_t>(ADSceneConst::MAX_VOXEL_Y_ADDRESS);
+    if (maxVoxelX < 0 || maxVoxelY < 0 || maxVoxelX >= (1 << log2VoxelsWidth))
+    { throw QString("Scene header is invalid."); }
+    auto sceneHash = DumpCatalog::hash(
+                psxRam.readAsPointer<uint8_t>(ADSceneConst::LOG2_VOXELS_WIDTH_ADDRESS, 8),
+                8);
+    uint32_t voxelsNumber = (maxVoxelY + 1) << log2VoxelsWidth;
+    auto const* adVoxels = psxRam.readAsPointer<AD::Voxel>(
+                psxRam.read<PsxRamAddress::Raw>(ADSceneConst::VOXELS_ADDRESS_POINTER),
+                voxelsNumber);
+    sceneHash = DumpCatalog::hash(adVoxels, voxelsNumber * sizeof(AD::Voxel), sceneHash);
+    auto descriptorsAddressesAddress = psxRam.read<PsxRamAddress::Raw>(
+                ADSceneConst::POLYGONS_DESCRIPTORS_ADDRESSES_POINTER);
+    uint32_t maxVertexIndex = 0;
+    for (int voxelY = 0; voxelY <= maxVoxelY; ++voxelY)
+    {
+        for (int voxelX = 0; voxelX <= maxVoxelX; ++voxelX)
+        {
+            auto const& adVoxel = adVoxels[(voxelY << log2VoxelsWidth) + voxelX];
+            if (adVoxel.polygonsDescriptorsIndex == 0)
+            { continue; }
+            auto descriptorAddress = psxRam.read<PsxRamAddress::Raw>(
+                        descriptorsAddressesAddress
+                        + adVoxel.polygonsDescriptorsIndex * static_cast<uint32_t>(sizeof(PsxRamAddress::Raw)));
+            // Same walk as ADScene::readVoxel().
+            while (true)
+            {
+                auto const* descriptor = psxRam.readAsPointer<AD::PolygonDescriptor>(descriptorAddress);
+                if (descriptor->texCoord2AndTexPage.raw == 0)
+                {
+                    if (descriptor->flags.lsb.raw == 1 && descriptor->flags.isLastPolygon())
+                    { break; }
+                    descriptorAddress += sizeof(AD::PolygonDescriptor);
+                    continue;
+                }
+                ++record.polygonsNumber;
+                if (descriptor->flags.isSemiTransparent())
+                { ++record.semiTransparentPolygonsNumber; }
+                auto const& texpage = descriptor->texCoord2AndTexPage.fields.texpage;
+                record.texpagesMask |= 1u << (texpage.x + 16 * texpage.y);
+                maxVertexIndex = qMax<uint32_t>(
+                            maxVertexIndex,
+                            qMax(
+                                qMax(descriptor->vertex1Index, descriptor->vertex2Index),
+                                qMax(descriptor->vertex3Index, descriptor->vertex4Index)));
+                sceneHash = DumpCatalog::hash(descriptor, sizeof(AD::PolygonDescriptor), sceneHash);
+                if (descriptor->flags.lsb.fields.someSize == 1
+                        && descriptor->flags.isLastPolygon()
+                        && descriptor->flags.lsb.fields.nextPolygonOffset == 0)
+                { break; }
+                descriptorAddress += sizeof(AD::PolygonDescriptor);
+            }
+        }
+    }
+    record.voxelsWidth = maxVoxelX + 1;
+    record.voxelsHeight = maxVoxelY + 1;
+    record.verticesNumber = record.polygonsNumber > 0 ? maxVertexIndex + 1 : 0;
+    if (record.verticesNumber > 0)
+    {
+        auto const* adVertices = psxRam.readAsPointer<AD::Point3D>(
+                    psxRam.read<PsxRamAddress::Raw>(ADSceneConst::VERTICES_ADDRESS_POINTER),
+                    record.verticesNumber);
+        sceneHash = DumpCatalog::hash(adVertices, record.verticesNumber * sizeof(AD::Point3D), sceneHash);
+    }
+    record.sceneHash = sceneHash;
+}
+
+void DumpSceneScanner::scanVRam(uchar const* vram, DumpCatalogRecord& record)
+{
+    static constexpr int const TEXPAGE_WIDTH = PsxVRamConst::TEXTURE_4BPP_PAGE_WIDTH;
+    static constexpr int const TEXPAGES_PER_LINE = PsxVRamConst::PIXELS_PER_LINE / TEXPAGE_WIDTH;
+    static constexpr int const TEXPAGE_LINE_SIZE = TEXPAGE_WIDTH * PsxVRamConst::PIXEL_SIZE;
+    for (int texpage = 0; texpage < DumpCatalogRecord::VRAM_PAGES_NUMBER; ++texpage)
+    {
+        int x = (texpage % TEXPAGES_PER_LINE) * TEXPAGE_WIDTH;
+        int y = (texpage / TEXPAGES_PER_LINE) * PsxVRamConst::TEXTURE_PAGE_HEIGHT;
+        auto hash = DumpCatalog::HASH_OFFSET_BASIS;
+        for (int line = y; line < y + PsxVRamConst::TEXTURE_PAGE_HEIGHT; ++line)
+        {
+            hash = DumpCatalog::hash(
+                        vram + (line * PsxVRamConst::PIXELS_PER_LINE + x) * PsxVRamConst::PIXEL_SIZE,
+                        TEXPAGE_LINE_SIZE,
+                        hash);
+        }
+        record.vramPagesHashes[texpage] = hash;
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef DUMPSCENESCANNER_HPP
+#define DUMPSCENESCANNER_HPP
+
+#include "DumpCatalog.hpp"
+#include <QString>
+
+// Summarizes an AD 3D model (*.3dm) for the dump catalog without loading it: the file is mapped and only
+// the scene header, the voxels and polygons descriptors tables, the vertices and the VRAM are touched.
+class DumpSceneScanner
+{
+public:
+    DumpSceneScanner() = delete;
+
+    // Returns an error if the file cannot be read as a dump. A dump whose scene cannot be read is still
+    // summarized, without DumpCatalogRecord::SCENE_READ.
+    static QString scan(QString const& filePath, DumpCatalogRecord& record);
+
+private:
+    static void scanScene(uchar const* ram, DumpCatalogRecord& record);
+    static void scanVRam(uchar const* vram, DumpCatalogRecord& record);
+};
+
+#endif // DUMPSCENESCANNER_HPP
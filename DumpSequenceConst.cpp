@@ -0,0 +1,3 @@
+#include "DumpSequenceConst.hpp"
+
+QByteArray const DumpSequenceConst::MAGIC("VMDSEQ01", 8);
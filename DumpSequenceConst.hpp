@@ -0,0 +1,32 @@
+#ifndef DUMPSEQUENCECONST_HPP
+#define DUMPSEQUENCECONST_HPP
+
+#include "PsxRamConst.hpp"
+#include "PsxVRamConst.hpp"
+#include <QByteArray>
+#include <cstdint>
+
+// Dump sequence (*.3ds) layout, all numbers little endian:
+// header: magic, frame size (u32), keyframe interval (u32), frames number (u32), index offset (u64);
+// frames: type (u8), payload size (u32), payload;
+// index: frame offset (u64) and frame type (u8) for every frame.
+// Keyframe payloads are zlib compressed frames, delta payloads are DumpSequenceDelta encoded XORs against
+// the previous frame. A frame is PSX RAM followed by PSX VRAM, the same as in *.3dm files.
+struct DumpSequenceConst
+{
+    static QByteArray const MAGIC;
+    static constexpr uint32_t const FRAME_SIZE = PsxRamConst::SIZE + PsxVRamConst::SIZE;
+    static constexpr uint32_t const HEADER_SIZE = 8 + 4 + 4 + 4 + 8;
+    static constexpr uint32_t const DEFAULT_KEYFRAME_INTERVAL = 64;
+    static constexpr int const KEYFRAME_COMPRESSION_LEVEL = 1;
+
+    enum FrameType : uint8_t
+    {
+        KEYFRAME = 0,
+        DELTA_FRAME = 1
+    };
+
+    DumpSequenceConst() = delete;
+};
+
+#endif // DUMPSEQUENCECONST_HPP
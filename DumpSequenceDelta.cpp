@@ -0,0 +1,104 @@
+#include "DumpSequenceDelta.hpp"
+#include <QString>
+#include <cstring>
+
+// Shorter equal runs are cheaper to keep inside a literal than to encode as a separate pair.
+static constexpr int MIN_EQUAL_RUN = 8;
+
+QByteArray DumpSequenceDelta::encode(char const* previousFrame, char const* frame, int size)
+{
+    QByteArray delta;
+    int position = 0;
+    while (position < size)
+    {
+        auto literalStart = skipEqualBytes(previousFrame, frame, position, size);
+        if (literalStart == size)
+        { break; }
+        auto literalEnd = literalStart + 1;
+        int equalRun = 0;
+        while (literalEnd + equalRun < size && equalRun < MIN_EQUAL_RUN)
+        {
+            if (previousFrame[literalEnd + equalRun] == frame[literalEnd + equalRun])
+            { ++equalRun; }
+            else
+            {
+                literalEnd += equalRun + 1;
+                equalRun = 0;
+            }
+        }
+        appendVarint(delta, literalStart - position);
+        appendVarint(delta, literalEnd - literalStart);
+        auto literalOffset = delta.size();
+        delta.resize(literalOffset + literalEnd - literalStart);
+        auto* literal = delta.data() + literalOffset;
+        for (auto byteIndex = literalStart; byteIndex < literalEnd; ++byteIndex)
+        { *(literal++) = previousFrame[byteIndex] ^ frame[byteIndex]; }
+        position = literalEnd;
+    }
+    return delta;
+}
+
+void DumpSequenceDelta::apply(QByteArray const& delta, char* frame, int size)
+{
+    int deltaPosition = 0;
+    int position = 0;
+    while (deltaPosition < delta.size())
+    {
+        // Checked as unsigned before any addition, so corrupted lengths can neither overflow nor go negative.
+        auto equalRun = readVarint(delta, deltaPosition);
+        if (equalRun > static_cast<uint32_t>(size - position))
+        { throw QString("Corrupted delta frame."); }
+        position += static_cast<int>(equalRun);
+        auto literalLength = readVarint(delta, deltaPosition);
+        if (literalLength > static_cast<uint32_t>(size - position)
+                || literalLength > static_cast<uint32_t>(delta.size() - deltaPosition))
+        { throw QString("Corrupted delta frame."); }
+        auto const* literal = delta.constData() + deltaPosition;
+        for (uint32_t byteIndex = 0; byteIndex < literalLength; ++byteIndex)
+        { frame[position + byteIndex] ^= literal[byteIndex]; }
+        position += static_cast<int>(literalLength);
+        deltaPosition += static_cast<int>(literalLength);
+    }
+}
+
+int DumpSequenceDelta::skipEqualBytes(char const* previousFrame, char const* frame, int position, int size)
+{
+    while (position + 8 <= size)
+    {
+        uint64_t previousWord;
+        uint64_t word;
+        std::memcpy(&previousWord, previousFrame + position, 8);
+        std::memcpy(&word, frame + position, 8);
+        if (previousWord != word)
+        { break; }
+        position += 8;
+    }
+    while (position < size && previousFrame[position] == frame[position])
+    { ++position; }
+    return position;
+}
+
+void DumpSequenceDelta::appendVarint(QByteArray& delta, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        delta.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    delta.append(static_cast<char>(value));
+}
+
+uint32_t DumpSequenceDelta::readVarint(QByteArray const& delta, int& position)
+{
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 7)
+    {
+        if (position >= delta.size())
+        { throw QString("Corrupted delta frame."); }
+        auto byte = static_cast<uint8_t>(delta[position++]);
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        { return value; }
+    }
+    throw QString("Corrupted delta frame.");
+}
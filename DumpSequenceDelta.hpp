@@ -0,0 +1,23 @@
+#ifndef DUMPSEQUENCEDELTA_HPP
+#define DUMPSEQUENCEDELTA_HPP
+
+#include <QByteArray>
+
+// Run-length encoded XOR of two equally sized frames: a series of (equal bytes run, literal length) varint
+// pairs, each followed by the literal XOR bytes. Applying a delta is its own inverse, so it can step a frame
+// forward as well as backwards.
+class DumpSequenceDelta
+{
+public:
+    DumpSequenceDelta() = delete;
+
+    static QByteArray encode(char const* previousFrame, char const* frame, int size);
+    static void apply(QByteArray const& delta, char* frame, int size);
+
+private:
+    static int skipEqualBytes(char const* previousFrame, char const* frame, int position, int size);
+    static void appendVarint(QByteArray& delta, uint32_t value);
+    static uint32_t readVarint(QByteArray const& delta, int& position);
+};
+
+#endif // DUMPSEQUENCEDELTA_HPP
@@ -0,0 +1,148 @@
+#include "DumpSequenceDelta.hpp"
+#include "DumpSequenceReader.hpp"
+#include <QDataStream>
+#include <cstring>
+
+DumpSequenceReader::DumpSequenceReader()
+    : keyframeInterval_{0},
+      currentFrameIndex_{-1}
+{}
+
+void DumpSequenceReader::open(QString const& filePath)
+{
+    close();
+    file_.setFileName(filePath);
+    if (!file_.open(QFile::ReadOnly))
+    { throw QString("Could not open file %1.").arg(filePath); }
+    QDataStream stream(&file_);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    QByteArray magic(DumpSequenceConst::MAGIC.size(), Qt::Uninitialized);
+    stream.readRawData(magic.data(), magic.size());
+    quint32 frameSize;
+    quint32 framesNumber;
+    quint64 indexOffset;
+    stream >> frameSize >> keyframeInterval_ >> framesNumber >> indexOffset;
+    if (stream.status() != QDataStream::Ok || magic != DumpSequenceConst::MAGIC)
+    {
+        close();
+        throw QString("File %1 is not a dump sequence.").arg(filePath);
+    }
+    if (frameSize != DumpSequenceConst::FRAME_SIZE || indexOffset == 0)
+    {
+        close();
+        throw QString("Dump sequence %1 is unsupported or was not closed properly.").arg(filePath);
+    }
+    file_.seek(indexOffset);
+    framesIndex_.resize(framesNumber);
+    for (auto& frameIndexEntry : framesIndex_)
+    {
+        quint8 type;
+        stream >> frameIndexEntry.offset >> type;
+        frameIndexEntry.type = static_cast<DumpSequenceConst::FrameType>(type);
+    }
+    if (stream.status() != QDataStream::Ok || (framesNumber > 0 && framesIndex_[0].type != DumpSequenceConst::KEYFRAME))
+    {
+        close();
+        throw QString("Dump sequence %1 index is corrupted.").arg(filePath);
+    }
+    frame_ = QByteArray(DumpSequenceConst::FRAME_SIZE, '\0');
+}
+
+void DumpSequenceReader::close()
+{
+    if (file_.isOpen())
+    { file_.close(); }
+    framesIndex_.clear();
+    frame_.clear();
+    currentFrameIndex_ = -1;
+}
+
+void DumpSequenceReader::seek(uint32_t frameIndex)
+{
+    if (frameIndex >= framesNumber())
+    { throw QString("Frame %1 is out of dump sequence range 0..%2.").arg(frameIndex).arg(framesNumber() - 1); }
+    if (static_cast<int>(frameIndex) == currentFrameIndex_)
+    { return; }
+    try
+    { stepToFrame(frameIndex); }
+    catch (QString const&)
+    {
+        currentFrameIndex_ = -1;
+        throw;
+    }
+}
+
+void DumpSequenceReader::stepToFrame(uint32_t frameIndex)
+{
+    auto keyframeIndex = findKeyframe(frameIndex);
+    // Deltas are XORs, so stepping backwards undoes them in reverse order as long as no keyframe is crossed.
+    if (currentFrameIndex_ > static_cast<int>(frameIndex)
+            && findKeyframe(currentFrameIndex_) == keyframeIndex
+            && currentFrameIndex_ - frameIndex <= frameIndex - keyframeIndex)
+    {
+        while (currentFrameIndex_ > static_cast<int>(frameIndex))
+        {
+            applyDelta(currentFrameIndex_);
+            --currentFrameIndex_;
+        }
+        return;
+    }
+    if (currentFrameIndex_ < static_cast<int>(keyframeIndex) || currentFrameIndex_ > static_cast<int>(frameIndex))
+    {
+        loadKeyframe(keyframeIndex);
+        currentFrameIndex_ = keyframeIndex;
+    }
+    while (currentFrameIndex_ < static_cast<int>(frameIndex))
+    {
+        applyDelta(currentFrameIndex_ + 1);
+        ++currentFrameIndex_;
+    }
+}
+
+void DumpSequenceReader::readFrame(BufferedPsxRam& psxRam, QByteArray& psxVRam) const
+{
+    if (currentFrameIndex_ < 0)
+    { throw QString("No dump sequence frame is loaded."); }
+    psxRam.fill(frame_.constData());
+    psxVRam = QByteArray(frame_.constData() + PsxRamConst::SIZE, PsxVRamConst::SIZE);
+}
+
+uint32_t DumpSequenceReader::findKeyframe(uint32_t frameIndex) const
+{
+    while (framesIndex_[frameIndex].type != DumpSequenceConst::KEYFRAME)
+    { --frameIndex; }
+    return frameIndex;
+}
+
+QByteArray DumpSequenceReader::readPayload(uint32_t frameIndex)
+{
+    file_.seek(framesIndex_[frameIndex].offset);
+    QDataStream stream(&file_);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    quint8 type;
+    quint32 payloadSize;
+    stream >> type >> payloadSize;
+    if (stream.status() != QDataStream::Ok || type != framesIndex_[frameIndex].type)
+    { throw QString("Dump sequence frame %1 is corrupted.").arg(frameIndex); }
+    auto payload = file_.read(payloadSize);
+    if (payload.size() != static_cast<int>(payloadSize))
+    { throw QString("Dump sequence frame %1 is truncated.").arg(frameIndex); }
+    return payload;
+}
+
+void DumpSequenceReader::loadKeyframe(uint32_t frameIndex)
+{
+    auto frame = qUncompress(readPayload(frameIndex));
+    if (frame.size() != static_cast<int>(DumpSequenceConst::FRAME_SIZE))
+    { throw QString("Dump sequence keyframe %1 is corrupted.").arg(frameIndex); }
+    std::memcpy(frame_.data(), frame.constData(), frame.size());
+}
+
+void DumpSequenceReader::applyDelta(uint32_t frameIndex)
+{
+    auto payload = readPayload(frameIndex);
+    try
+    { DumpSequenceDelta::apply(payload, frame_.data(), frame_.size()); }
+    catch (QString const& error)
+    { throw QString("Dump sequence frame %1: %2").arg(frameIndex).arg(error); }
+}
@@ -0,0 +1,52 @@
+#ifndef DUMPSEQUENCEREADER_HPP
+#define DUMPSEQUENCEREADER_HPP
+
+#include "BufferedPsxRam.hpp"
+#include "DumpSequenceConst.hpp"
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+
+class DumpSequenceReader
+{
+public:
+    DumpSequenceReader();
+
+    bool isOpen() const
+    { return file_.isOpen(); }
+    void open(QString const& filePath);
+    void close();
+    QString filePath() const
+    { return file_.fileName(); }
+    uint32_t framesNumber() const
+    { return framesIndex_.count(); }
+    uint32_t keyframeInterval() const
+    { return keyframeInterval_; }
+    int currentFrameIndex() const
+    { return currentFrameIndex_; }
+    void seek(uint32_t frameIndex);
+    QByteArray const& frame() const
+    { return frame_; }
+    void readFrame(BufferedPsxRam& psxRam, QByteArray& psxVRam) const;
+
+private:
+    struct FrameIndexEntry
+    {
+        quint64 offset;
+        DumpSequenceConst::FrameType type;
+    };
+
+    void stepToFrame(uint32_t frameIndex);
+    uint32_t findKeyframe(uint32_t frameIndex) const;
+    QByteArray readPayload(uint32_t frameIndex);
+    void loadKeyframe(uint32_t frameIndex);
+    void applyDelta(uint32_t frameIndex);
+
+    QFile file_;
+    uint32_t keyframeInterval_;
+    QVector<FrameIndexEntry> framesIndex_;
+    QByteArray frame_;
+    int currentFrameIndex_;
+};
+
+#endif // DUMPSEQUENCEREADER_HPP
@@ -0,0 +1,110 @@
+#include "DumpSequenceDelta.hpp"
+#include "DumpSequenceWriter.hpp"
+#include <cstring>
+
+DumpSequenceWriter::DumpSequenceWriter()
+    : keyframeInterval_{DumpSequenceConst::DEFAULT_KEYFRAME_INTERVAL},
+      framesSinceKeyframe_{0}
+{}
+
+DumpSequenceWriter::~DumpSequenceWriter()
+{
+    if (!isOpen())
+    { return; }
+    try
+    { close(); }
+    catch (QString const&)
+    {}
+}
+
+void DumpSequenceWriter::open(QString const& filePath, uint32_t keyframeInterval)
+{
+    if (isOpen())
+    { close(); }
+    file_.setFileName(filePath);
+    if (!file_.open(QFile::WriteOnly | QFile::Truncate))
+    { throw QString("Could not create file %1.").arg(filePath); }
+    stream_.setDevice(&file_);
+    stream_.setByteOrder(QDataStream::LittleEndian);
+    keyframeInterval_ = qMax(1u, keyframeInterval);
+    framesSinceKeyframe_ = 0;
+    previousFrame_.clear();
+    framesIndex_.clear();
+    writeHeader(0);
+}
+
+void DumpSequenceWriter::addFrame(BufferedPsxRam const& psxRam, QByteArray const& psxVRam)
+{
+    if (psxVRam.size() != static_cast<int>(PsxVRamConst::SIZE))
+    { throw QString("VRAM size %1 is different than expected %2.").arg(psxVRam.size()).arg(PsxVRamConst::SIZE); }
+    QByteArray frame(DumpSequenceConst::FRAME_SIZE, Qt::Uninitialized);
+    psxRam.dump(frame.data());
+    std::memcpy(frame.data() + PsxRamConst::SIZE, psxVRam.constData(), PsxVRamConst::SIZE);
+    addFrame(frame);
+}
+
+void DumpSequenceWriter::addFrame(QByteArray const& frame)
+{
+    if (!isOpen())
+    { throw QString("Dump sequence is not open."); }
+    if (frame.size() != static_cast<int>(DumpSequenceConst::FRAME_SIZE))
+    {
+        throw QString("Frame size %1 is different than expected %2.")
+                .arg(frame.size())
+                .arg(DumpSequenceConst::FRAME_SIZE);
+    }
+    if (!previousFrame_.isEmpty() && framesSinceKeyframe_ < keyframeInterval_)
+    {
+        auto delta = DumpSequenceDelta::encode(previousFrame_.constData(), frame.constData(), frame.size());
+        // A delta of a heavily changed frame costs more than a compressed keyframe and cannot be seeked to.
+        if (delta.size() < frame.size() / 4)
+        {
+            writeFrame(DumpSequenceConst::DELTA_FRAME, delta);
+            ++framesSinceKeyframe_;
+            previousFrame_ = frame;
+            return;
+        }
+    }
+    writeFrame(DumpSequenceConst::KEYFRAME, qCompress(frame, DumpSequenceConst::KEYFRAME_COMPRESSION_LEVEL));
+    framesSinceKeyframe_ = 1;
+    previousFrame_ = frame;
+}
+
+void DumpSequenceWriter::close()
+{
+    if (!isOpen())
+    { return; }
+    quint64 indexOffset = file_.pos();
+    for (auto const& frameIndexEntry : framesIndex_)
+    { stream_ << frameIndexEntry.offset << static_cast<quint8>(frameIndexEntry.type); }
+    file_.seek(0);
+    writeHeader(indexOffset);
+    auto status = stream_.status();
+    stream_.setDevice(nullptr);
+    file_.close();
+    previousFrame_.clear();
+    if (status != QDataStream::Ok)
+    { throw QString("Could not write dump sequence %1.").arg(file_.fileName()); }
+}
+
+void DumpSequenceWriter::writeHeader(quint64 indexOffset)
+{
+    stream_.writeRawData(DumpSequenceConst::MAGIC.constData(), DumpSequenceConst::MAGIC.size());
+    stream_ << DumpSequenceConst::FRAME_SIZE << keyframeInterval_ << static_cast<quint32>(framesIndex_.count());
+    stream_ << indexOffset;
+    checkStatus();
+}
+
+void DumpSequenceWriter::writeFrame(DumpSequenceConst::FrameType type, QByteArray const& payload)
+{
+    framesIndex_.append({static_cast<quint64>(file_.pos()), type});
+    stream_ << static_cast<quint8>(type) << static_cast<quint32>(payload.size());
+    stream_.writeRawData(payload.constData(), payload.size());
+    checkStatus();
+}
+
+void DumpSequenceWriter::checkStatus() const
+{
+    if (stream_.status() != QDataStream::Ok)
+    { throw QString("Could not write dump sequence %1.").arg(file_.fileName()); }
+}
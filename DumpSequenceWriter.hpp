@@ -0,0 +1,47 @@
+#ifndef DUMPSEQUENCEWRITER_HPP
+#define DUMPSEQUENCEWRITER_HPP
+
+#include "BufferedPsxRam.hpp"
+#include "DumpSequenceConst.hpp"
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QVector>
+
+class DumpSequenceWriter
+{
+public:
+    DumpSequenceWriter();
+    ~DumpSequenceWriter();
+
+    bool isOpen() const
+    { return file_.isOpen(); }
+    void open(QString const& filePath, uint32_t keyframeInterval = DumpSequenceConst::DEFAULT_KEYFRAME_INTERVAL);
+    void addFrame(BufferedPsxRam const& psxRam, QByteArray const& psxVRam);
+    void addFrame(QByteArray const& frame);
+    void close();
+    uint32_t framesNumber() const
+    { return framesIndex_.count(); }
+    qint64 writtenBytes() const
+    { return file_.pos(); }
+
+private:
+    struct FrameIndexEntry
+    {
+        quint64 offset;
+        DumpSequenceConst::FrameType type;
+    };
+
+    void writeHeader(quint64 indexOffset);
+    void writeFrame(DumpSequenceConst::FrameType type, QByteArray const& payload);
+    void checkStatus() const;
+
+    QFile file_;
+    QDataStream stream_;
+    uint32_t keyframeInterval_;
+    uint32_t framesSinceKeyframe_;
+    QByteArray previousFrame_;
+    QVector<FrameIndexEntry> framesIndex_;
+};
+
+#endif // DUMPSEQUENCEWRITER_HPP
@@ -0,0 +1,220 @@
+#include "ADDefinitions.hpp"
+#include "ADSceneConst.hpp"
+#include "DumpTriage.hpp"
+#include "PsxRamConst.hpp"
+#include "PsxVRamConst.hpp"
+#include <QFile>
+#include <cstring>
+
+namespace
+{
+// Scene header and tables pointers, from VOXELS_ADDRESS_POINTER to the end of MAX_VOXEL_Y_ADDRESS.
+constexpr PsxRamAddress::Raw const HEADER_ADDRESS = ADSceneConst::VOXELS_ADDRESS_POINTER;
+constexpr uint32_t const HEADER_SIZE = ADSceneConst::MAX_VOXEL_Y_ADDRESS + 2 - HEADER_ADDRESS;
+
+struct InvalidPointers
+{
+    QString reason;
+};
+
+struct InvalidTables
+{
+    QString reason;
+};
+
+// Positioned reads of PSX RAM straight from an unbuffered dump file.
+class PsxRamReader
+{
+public:
+    explicit PsxRamReader(QFile& file)
+        : file_(file)
+    {}
+
+    bool isInRam(PsxRamAddress::Raw address, uint64_t size) const
+    {
+        return PsxRamConst::isInPsxRamAddress(address)
+                && PsxRamConst::toNoSegRamAddress(address) + size <= PsxRamConst::SIZE;
+    }
+
+    void read(PsxRamAddress::Raw address, void* data, uint32_t size)
+    {
+        if (!file_.seek(PsxRamConst::toNoSegRamAddress(address))
+                || file_.read(static_cast<char*>(data), size) != size)
+        { throw QString("Could not read file %1.").arg(file_.fileName()); }
+    }
+
+    template <typename T>
+    T read(PsxRamAddress::Raw address)
+    {
+        T value;
+        read(address, &value, sizeof(T));
+        return value;
+    }
+
+private:
+    QFile& file_;
+};
+
+template <typename T>
+T headerValue(uint8_t const* header, PsxRamAddress::Raw address)
+{
+    T value;
+    std::memcpy(&value, header + (address - HEADER_ADDRESS), sizeof(T));
+    return value;
+}
+
+QString addressText(PsxRamAddress::Raw address)
+{ return QString("0x%1").arg(address, 8, 16, QChar('0')); }
+
+void checkTables(
+        PsxRamReader& psxRam,
+        PsxRamAddress::Raw voxelsAddress,
+        PsxRamAddress::Raw descriptorsAddressesAddress,
+        PsxRamAddress::Raw verticesAddress,
+        int log2VoxelsWidth,
+        int voxelsWidth,
+        int voxelsHeight,
+        int sampledVoxelsNumber)
+{
+    uint32_t voxelsNumber = static_cast<uint32_t>(voxelsHeight) << log2VoxelsWidth;
+    if (!psxRam.isInRam(voxelsAddress, static_cast<uint64_t>(voxelsNumber) * sizeof(AD::Voxel)))
+    { throw InvalidPointers{QString("Voxels table at %1 is outside of PSX RAM.").arg(addressText(voxelsAddress))}; }
+    auto sampledVoxelsCount = qMin(sampledVoxelsNumber, voxelsWidth * voxelsHeight);
+    for (int sampleIndex = 0; sampleIndex < sampledVoxelsCount; ++sampleIndex)
+    {
+        // Evenly spread over the used part of the grid.
+        auto voxelIndex = static_cast<int64_t>(sampleIndex) * voxelsWidth * voxelsHeight / sampledVoxelsCount;
+        auto voxelX = static_cast<int>(voxelIndex % voxelsWidth);
+        auto voxelY = static_cast<int>(voxelIndex / voxelsWidth);
+        auto adVoxel = psxRam.read<AD::Voxel>(
+                    voxelsAddress + ((voxelY << log2VoxelsWidth) + voxelX) * static_cast<uint32_t>(sizeof(AD::Voxel)));
+        if (adVoxel.polygonsDescriptorsIndex == 0)
+        { continue; }
+        auto descriptorAddressAddress = descriptorsAddressesAddress
+                + adVoxel.polygonsDescriptorsIndex * static_cast<uint32_t>(sizeof(PsxRamAddress::Raw));
+        if (!psxRam.isInRam(descriptorAddressAddress, sizeof(PsxRamAddress::Raw)))
+        {
+            throw InvalidTables{QString("Voxel %1,%2 descriptors index %3 points outside of PSX RAM.")
+                        .arg(voxelX)
+                        .arg(voxelY)
+                        .arg(adVoxel.polygonsDescriptorsIndex)};
+        }
+        auto descriptorAddress = psxRam.read<PsxRamAddress::Raw>(descriptorAddressAddress);
+        if (!psxRam.isInRam(descriptorAddress, sizeof(AD::PolygonDescriptor)))
+        {
+            throw InvalidTables{QString("Voxel %1,%2 polygons descriptors at %3 are outside of PSX RAM.")
+                        .arg(voxelX)
+                        .arg(voxelY)
+                        .arg(addressText(descriptorAddress))};
+        }
+        auto descriptor = psxRam.read<AD::PolygonDescriptor>(descriptorAddress);
+        if (descriptor.texCoord2AndTexPage.raw == 0)
+        { continue; }
+        uint32_t maxVertexIndex = qMax(
+                    qMax(descriptor.vertex1Index, descriptor.vertex2Index),
+                    qMax(descriptor.vertex3Index, descriptor.vertex4Index));
+        if (!psxRam.isInRam(verticesAddress, (maxVertexIndex + 1) * static_cast<uint64_t>(sizeof(AD::Point3D))))
+        {
+            throw InvalidTables{QString("Voxel %1,%2 polygon vertex %3 is outside of PSX RAM.")
+                        .arg(voxelX)
+                        .arg(voxelY)
+                        .arg(maxVertexIndex)};
+        }
+    }
+}
+}
+
+DumpTriage::Result DumpTriage::triage(QString const& filePath, int sampledVoxelsNumber)
+{
+    Result result{Verdict::NOT_A_DUMP, 0, 0, {}};
+    // Unbuffered, so every read is a single small positioned read of the file.
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly | QFile::Unbuffered))
+    {
+        result.reason = QString("Could not open file %1.").arg(filePath);
+        return result;
+    }
+    if (file.size() != PsxRamConst::SIZE + PsxVRamConst::SIZE)
+    {
+        result.reason = QString("File size %1 is not a dump size.").arg(file.size());
+        return result;
+    }
+    try
+    {
+        PsxRamReader psxRam(file);
+        uint8_t header[HEADER_SIZE];
+        psxRam.read(HEADER_ADDRESS, header, HEADER_SIZE);
+        auto log2VoxelsWidth = headerValue<uint16_t>(header, ADSceneConst::LOG2_VOXELS_WIDTH_ADDRESS)
+                & ADSceneConst::LOG2_VOXELS_SIZE_MASK;
+        auto log2VoxelsHeight = headerValue<uint16_t>(header, ADSceneConst::LOG2_VOXELS_HEIGHT_ADDRESS)
+                & ADSceneConst::LOG2_VOXELS_SIZE_MASK;
+        auto maxVoxelX = headerValue<int16_t>(header, ADSceneConst::MAX_VOXEL_X_ADDRESS);
+        auto maxVoxelY = headerValue<int16_t>(header, ADSceneConst::MAX_VOXEL_Y_ADDRESS);
+        if (maxVoxelX < 0 || maxVoxelY < 0 || maxVoxelX >= (1 << log2VoxelsWidth)
+                || maxVoxelY >= (1 << log2VoxelsHeight))
+        {
+            result.verdict = Verdict::NO_SCENE;
+            result.reason = "Scene header is invalid.";
+            return result;
+        }
+        result.voxelsWidth = maxVoxelX + 1;
+        result.voxelsHeight = maxVoxelY + 1;
+        for (auto pointerAddress : {
+             ADSceneConst::VOXELS_ADDRESS_POINTER,
+             ADSceneConst::POLYGONS_DESCRIPTORS_ADDRESSES_POINTER,
+             ADSceneConst::VERTICES_ADDRESS_POINTER})
+        {
+            auto address = headerValue<PsxRamAddress::Raw>(header, pointerAddress);
+            if (!PsxRamConst::isInPsxRamAddress(address))
+            {
+                throw InvalidPointers{QString("Pointer at %1 holds %2, outside of PSX RAM.")
+                            .arg(addressText(pointerAddress))
+                            .arg(addressText(address))};
+            }
+        }
+        checkTables(
+                    psxRam,
+                    headerValue<PsxRamAddress::Raw>(header, ADSceneConst::VOXELS_ADDRESS_POINTER),
+                    headerValue<PsxRamAddress::Raw>(header, ADSceneConst::POLYGONS_DESCRIPTORS_ADDRESSES_POINTER),
+                    headerValue<PsxRamAddress::Raw>(header, ADSceneConst::VERTICES_ADDRESS_POINTER),
+                    log2VoxelsWidth,
+                    result.voxelsWidth,
+                    result.voxelsHeight,
+                    sampledVoxelsNumber);
+        result.verdict = Verdict::VALID_SCENE;
+    }
+    catch (InvalidPointers const& error)
+    {
+        result.verdict = Verdict::INVALID_POINTERS;
+        result.reason = error.reason;
+    }
+    catch (InvalidTables const& error)
+    {
+        result.verdict = Verdict::INVALID_TABLES;
+        result.reason = error.reason;
+    }
+    catch (QString const& error)
+    {
+        result.verdict = Verdict::NOT_A_DUMP;
+        result.reason = error;
+    }
+    return result;
+}
+
+char const* DumpTriage::verdictName(Verdict verdict)
+{
+    switch (verdict)
+    {
+    case Verdict::VALID_SCENE:
+        return "valid";
+    case Verdict::NO_SCENE:
+        return "no-scene";
+    case Verdict::INVALID_POINTERS:
+        return "invalid-pointers";
+    case Verdict::INVALID_TABLES:
+        return "invalid-tables";
+    case Verdict::NOT_A_DUMP:
+        return "not-a-dump";
+    }
+    return "unknown";
+}
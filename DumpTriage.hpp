@@ -0,0 +1,39 @@
+#ifndef DUMPTRIAGE_HPP
+#define DUMPTRIAGE_HPP
+
+#include <QString>
+#include <cstdint>
+
+// Classifies an AD 3D model (*.3dm) by whether it holds a loaded scene, reading only the scene header,
+// the tables pointers and a few sampled voxels with their first polygon descriptor. A handful of small
+// positioned reads per file, so thousands of files can be triaged before running DumpSceneScanner or
+// loading any of them. A valid verdict is a strong hint, not a proof: unsampled voxels are not checked.
+class DumpTriage
+{
+public:
+    static constexpr int const DEFAULT_SAMPLED_VOXELS_NUMBER = 16;
+
+    enum class Verdict : uint8_t
+    {
+        VALID_SCENE,
+        NO_SCENE,
+        INVALID_POINTERS,
+        INVALID_TABLES,
+        NOT_A_DUMP
+    };
+
+    struct Result
+    {
+        Verdict verdict;
+        uint16_t voxelsWidth;
+        uint16_t voxelsHeight;
+        QString reason;
+    };
+
+    DumpTriage() = delete;
+
+    static Result triage(QString const& filePath, int sampledVoxelsNumber = DEFAULT_SAMPLED_VOXELS_NUMBER);
+    static char const* verdictName(Verdict verdict);
+};
+
+#endif // DUMPTRIAGE_HPP
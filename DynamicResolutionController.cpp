@@ -0,0 +1,54 @@
+#include "DynamicResolutionController.hpp"
+#include <QtGlobal>
+#include <cmath>
+
+static constexpr float const DEFAULT_FRAME_TIME_BUDGET_MS = 1000.0f / 60.0f;
+static constexpr float const DEFAULT_MIN_SCALE = 0.25f;
+static constexpr float const DEFAULT_MAX_SCALE = 1.0f;
+static constexpr float const FRAME_TIME_SMOOTHING = 0.2f;
+static constexpr float const SCALE_HYSTERESIS = 0.05f;
+static constexpr float const MAX_SCALE_STEP = 0.1f;
+static constexpr float const SCALE_QUANTUM = 32.0f;
+
+DynamicResolutionController::DynamicResolutionController()
+    : frameTimeBudgetMs_{DEFAULT_FRAME_TIME_BUDGET_MS},
+      minScale_{DEFAULT_MIN_SCALE},
+      maxScale_{DEFAULT_MAX_SCALE},
+      scale_{DEFAULT_MAX_SCALE},
+      smoothedFrameTimeMs_{0.0f}
+{}
+
+void DynamicResolutionController::setFrameTimeBudget(float frameTimeBudgetMs)
+{ frameTimeBudgetMs_ = qMax(frameTimeBudgetMs, 1.0f); }
+
+void DynamicResolutionController::setScaleRange(float minScale, float maxScale)
+{
+    minScale_ = qBound(1.0f / SCALE_QUANTUM, qMin(minScale, maxScale), 1.0f);
+    maxScale_ = qBound(minScale_, qMax(minScale, maxScale), 1.0f);
+    scale_ = clampedScale(scale_);
+}
+
+void DynamicResolutionController::reset()
+{
+    scale_ = maxScale_;
+    smoothedFrameTimeMs_ = 0.0f;
+}
+
+void DynamicResolutionController::addFrameTime(float frameTimeMs)
+{
+    smoothedFrameTimeMs_ = smoothedFrameTimeMs_ == 0.0f ?
+                frameTimeMs :
+                smoothedFrameTimeMs_ + (frameTimeMs - smoothedFrameTimeMs_) * FRAME_TIME_SMOOTHING;
+    if (smoothedFrameTimeMs_ <= 0.0f)
+    { return; }
+    // Fragment cost grows with the square of the resolution scale.
+    float desiredScale = scale_ * std::sqrt(frameTimeBudgetMs_ / smoothedFrameTimeMs_);
+    float scaleChange = desiredScale / scale_ - 1.0f;
+    if (std::fabs(scaleChange) < SCALE_HYSTERESIS)
+    { return; }
+    scaleChange = qBound(-MAX_SCALE_STEP, scaleChange, MAX_SCALE_STEP);
+    scale_ = clampedScale(scale_ * (1.0f + scaleChange));
+}
+
+float DynamicResolutionController::clampedScale(float scale) const
+{ return qBound(minScale_, std::round(scale * SCALE_QUANTUM) / SCALE_QUANTUM, maxScale_); }
@@ -0,0 +1,34 @@
+#ifndef DYNAMICRESOLUTIONCONTROLLER_HPP
+#define DYNAMICRESOLUTIONCONTROLLER_HPP
+
+class DynamicResolutionController
+{
+public:
+    DynamicResolutionController();
+
+    float frameTimeBudget() const
+    { return frameTimeBudgetMs_; }
+    void setFrameTimeBudget(float frameTimeBudgetMs);
+    float minScale() const
+    { return minScale_; }
+    float maxScale() const
+    { return maxScale_; }
+    void setScaleRange(float minScale, float maxScale);
+    float scale() const
+    { return scale_; }
+    float smoothedFrameTime() const
+    { return smoothedFrameTimeMs_; }
+    void reset();
+    void addFrameTime(float frameTimeMs);
+
+private:
+    float clampedScale(float scale) const;
+
+    float frameTimeBudgetMs_;
+    float minScale_;
+    float maxScale_;
+    float scale_;
+    float smoothedFrameTimeMs_;
+};
+
+#endif // DYNAMICRESOLUTIONCONTROLLER_HPP
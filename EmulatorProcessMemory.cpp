@@ -0,0 +1,158 @@
+#include "EmulatorProcessMemory.hpp"
+#include "PatternSearcher.hpp"
+#include "PsxVRamConst.hpp"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/uio.h>
+
+static constexpr quintptr const SCAN_CHUNK_SIZE = 0x1000000;
+
+QHash<QString, quintptr> EmulatorProcessMemory::cachedPsxRamAddresses_;
+
+EmulatorProcessMemory::EmulatorProcessMemory(qint64 pid, qint64 psxVRamOffset)
+    : pid_{pid},
+      psxVRamOffset_{psxVRamOffset},
+      psxRamAddress_{0},
+      scanStatistics_{false, 0, 0}
+{}
+
+QString EmulatorProcessMemory::processKey() const
+{
+    QFile statFile(QString("/proc/%1/stat").arg(pid_));
+    if (!statFile.open(QFile::ReadOnly))
+    { throw QString("Process %1 does not exist.").arg(pid_); }
+    auto stat = QString::fromLatin1(statFile.readAll());
+    auto fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    static constexpr int const START_TIME_FIELD_INDEX = 19;
+    auto startTime = fields.size() > START_TIME_FIELD_INDEX ? fields[START_TIME_FIELD_INDEX] : QString();
+    return QString("%1:%2").arg(pid_).arg(startTime);
+}
+
+void EmulatorProcessMemory::attach()
+{
+    QElapsedTimer scanTimer;
+    scanTimer.start();
+    scanStatistics_ = {false, 0, 0};
+    auto key = processKey();
+    auto cachedAddressIt = cachedPsxRamAddresses_.constFind(key);
+    if (cachedAddressIt != cachedPsxRamAddresses_.constEnd() && isPsxRamAt(*cachedAddressIt))
+    {
+        psxRamAddress_ = *cachedAddressIt;
+        scanStatistics_.isCached = true;
+    }
+    else
+    {
+        psxRamAddress_ = scanForPsxRam();
+        cachedPsxRamAddresses_.insert(key, psxRamAddress_);
+    }
+    scanStatistics_.scanTimeMs = scanTimer.elapsed();
+}
+
+QVector<EmulatorProcessMemory::MemoryMapping> EmulatorProcessMemory::readMappings() const
+{
+    QFile mapsFile(QString("/proc/%1/maps").arg(pid_));
+    if (!mapsFile.open(QFile::ReadOnly | QFile::Text))
+    { throw QString("Could not read memory mappings of process %1.").arg(pid_); }
+    QVector<MemoryMapping> mappings;
+    for (auto const& line : mapsFile.readAll().split('\n'))
+    {
+        auto fields = line.split(' ');
+        if (fields.size() < 2 || !fields[1].startsWith('r'))
+        { continue; }
+        auto range = fields[0].split('-');
+        if (range.size() != 2)
+        { continue; }
+        MemoryMapping mapping{
+            static_cast<quintptr>(range[0].toULongLong(nullptr, 16)),
+            static_cast<quintptr>(range[1].toULongLong(nullptr, 16))};
+        if (mapping.end - mapping.start >= PsxRamConst::SIZE)
+        { mappings.append(mapping); }
+    }
+    return mappings;
+}
+
+bool EmulatorProcessMemory::readMemory(quintptr address, void* buffer, size_t size) const
+{
+    iovec localIov{buffer, size};
+    iovec remoteIov{reinterpret_cast<void*>(address), size};
+    return process_vm_readv(static_cast<pid_t>(pid_), &localIov, 1, &remoteIov, 1, 0) == static_cast<ssize_t>(size);
+}
+
+void EmulatorProcessMemory::readMemoryOrThrow(quintptr address, void* buffer, size_t size) const
+{
+    if (!readMemory(address, buffer, size))
+    {
+        throw QString("Could not read 0x%1 bytes at 0x%2 of process %3: %4.")
+                .arg(size, 0, 16)
+                .arg(address, 0, 16)
+                .arg(pid_)
+                .arg(std::strerror(errno));
+    }
+}
+
+bool EmulatorProcessMemory::isPsxRamAt(quintptr address) const
+{
+    auto const& pattern = PsxRamConst::PSX_RAM_PATTERN;
+    QByteArray memory(pattern.size(), 0);
+    return readMemory(address, memory.data(), memory.size()) && memory == pattern;
+}
+
+quintptr EmulatorProcessMemory::scanForPsxRam()
+{
+    QVector<ScanChunk> scanChunks;
+    for (auto const& mapping : readMappings())
+    {
+        for (auto chunkStart = mapping.start; chunkStart < mapping.end; chunkStart += SCAN_CHUNK_SIZE)
+        {
+            auto chunkEnd = std::min(chunkStart + SCAN_CHUNK_SIZE, mapping.end);
+            scanChunks.append({chunkStart, chunkEnd, mapping.end, 0});
+            scanStatistics_.scannedBytes += chunkEnd - chunkStart;
+        }
+    }
+    QtConcurrent::blockingMap(scanChunks, [this](ScanChunk& chunk) { scanChunk(chunk); });
+    for (auto const& chunk : scanChunks)
+    {
+        if (chunk.foundAddress != 0)
+        { return chunk.foundAddress; }
+    }
+    throw QString("PSX RAM was not found in memory of process %1.").arg(pid_);
+}
+
+void EmulatorProcessMemory::scanChunk(ScanChunk& chunk) const
+{
+    static PatternSearcher const patternSearcher(PsxRamConst::PSX_RAM_PATTERN);
+    qint64 patternSize = patternSearcher.pattern().size();
+    auto readEnd = std::min(chunk.end + patternSize - 1, chunk.mappingEnd);
+    QByteArray memory(static_cast<int>(readEnd - chunk.start), Qt::Uninitialized);
+    if (!readMemory(chunk.start, memory.data(), memory.size()))
+    { return; }
+    for (qint64 position = 0; ; ++position)
+    {
+        position = patternSearcher.find(memory.constData(), memory.size(), position);
+        if (position < 0)
+        { return; }
+        auto address = chunk.start + position;
+        if (chunk.mappingEnd - address >= PsxRamConst::SIZE)
+        {
+            chunk.foundAddress = address;
+            return;
+        }
+    }
+}
+
+void EmulatorProcessMemory::readPsxRam(BufferedPsxRam& psxRam) const
+{
+    QByteArray memory(PsxRamConst::SIZE, Qt::Uninitialized);
+    readMemoryOrThrow(psxRamAddress_, memory.data(), memory.size());
+    psxRam.fill(memory.constData());
+}
+
+void EmulatorProcessMemory::readPsxVRam(QByteArray& psxVRam) const
+{
+    psxVRam = QByteArray(PsxVRamConst::SIZE, Qt::Uninitialized);
+    readMemoryOrThrow(psxVRamAddress(), psxVRam.data(), psxVRam.size());
+}
@@ -0,0 +1,65 @@
+#ifndef EMULATORPROCESSMEMORY_HPP
+#define EMULATORPROCESSMEMORY_HPP
+
+#include "BufferedPsxRam.hpp"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class EmulatorProcessMemory
+{
+public:
+    struct ScanStatistics
+    {
+        bool isCached;
+        quint64 scannedBytes;
+        qint64 scanTimeMs;
+    };
+
+    explicit EmulatorProcessMemory(qint64 pid, qint64 psxVRamOffset = PsxRamConst::SIZE);
+
+    qint64 pid() const
+    { return pid_; }
+    quintptr psxRamAddress() const
+    { return psxRamAddress_; }
+    quintptr psxVRamAddress() const
+    { return psxRamAddress_ + psxVRamOffset_; }
+    ScanStatistics const& scanStatistics() const
+    { return scanStatistics_; }
+    void attach();
+    void readPsxRam(BufferedPsxRam& psxRam) const;
+    void readPsxVRam(QByteArray& psxVRam) const;
+
+private:
+    struct MemoryMapping
+    {
+        quintptr start;
+        quintptr end;
+    };
+
+    struct ScanChunk
+    {
+        quintptr start;
+        quintptr end;
+        quintptr mappingEnd;
+        quintptr foundAddress;
+    };
+
+    QString processKey() const;
+    QVector<MemoryMapping> readMappings() const;
+    bool readMemory(quintptr address, void* buffer, size_t size) const;
+    void readMemoryOrThrow(quintptr address, void* buffer, size_t size) const;
+    bool isPsxRamAt(quintptr address) const;
+    quintptr scanForPsxRam();
+    void scanChunk(ScanChunk& scanChunk) const;
+
+    static QHash<QString, quintptr> cachedPsxRamAddresses_;
+
+    qint64 pid_;
+    qint64 psxVRamOffset_;
+    quintptr psxRamAddress_;
+    ScanStatistics scanStatistics_;
+};
+
+#endif // EMULATORPROCESSMEMORY_HPP
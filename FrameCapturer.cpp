@@ -0,0 +1,169 @@
+#include "FrameCapturer.hpp"
+#include <QDir>
+#include <QImage>
+#include <QtConcurrent>
+#include <cstring>
+
+static constexpr int const BYTES_PER_PIXEL = 4;
+static constexpr GLuint64 const FLUSH_TIMEOUT_NS = 1000000000;
+
+FrameCapturer::FrameCapturer()
+    : nextReadbackSlot_{0},
+      isRecording_{false},
+      recordedFramesNumber_{0},
+      droppedFramesNumber_{0},
+      queuedEncodesNumber_{0},
+      failedWritesNumber_{0}
+{
+    for (auto& slot : readbackSlots_)
+    {
+        slot.buffer = QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+        slot.fence = nullptr;
+    }
+    encodingThreadPool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+FrameCapturer::~FrameCapturer()
+{ encodingThreadPool_.waitForDone(); }
+
+void FrameCapturer::initialize()
+{ initializeOpenGLFunctions(); }
+
+void FrameCapturer::destroy()
+{
+    flush();
+    for (auto& slot : readbackSlots_)
+    {
+        // Left by a readback that flush() timed out on.
+        if (slot.fence != nullptr)
+        {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.buffer.isCreated())
+        { slot.buffer.destroy(); }
+    }
+}
+
+void FrameCapturer::requestScreenshot(QString const& filePath)
+{ screenshotFilePath_ = filePath; }
+
+void FrameCapturer::startRecording(QString const& directoryPath)
+{
+    recordingDirectoryPath_ = directoryPath;
+    recordedFramesNumber_ = 0;
+    droppedFramesNumber_ = 0;
+    failedWritesNumber_ = 0;
+    isRecording_ = true;
+}
+
+void FrameCapturer::stopRecording()
+{ isRecording_ = false; }
+
+bool FrameCapturer::isCapturePending() const
+{
+    if (!screenshotFilePath_.isNull())
+    { return true; }
+    for (auto const& slot : readbackSlots_)
+    {
+        if (slot.fence != nullptr)
+        { return true; }
+    }
+    return false;
+}
+
+QString FrameCapturer::nextFilePath()
+{
+    if (!screenshotFilePath_.isNull())
+    {
+        auto filePath = screenshotFilePath_;
+        screenshotFilePath_.clear();
+        return filePath;
+    }
+    if (isRecording())
+    {
+        return QDir(recordingDirectoryPath_).filePath(
+                    QString("frame_%1.png").arg(recordedFramesNumber_++, 6, 10, QChar('0')));
+    }
+    return {};
+}
+
+void FrameCapturer::captureFrame(GLuint framebuffer, QSize const& size)
+{
+    for (int slotOffset = 0; slotOffset < READBACK_SLOTS_NUMBER; ++slotOffset)
+    { collectSlot(readbackSlots_[(nextReadbackSlot_ + slotOffset) % READBACK_SLOTS_NUMBER], 0); }
+    // Frames are dropped rather than piling up when the readbacks or the encoding fall behind; a requested
+    // screenshot is taken from a later frame instead.
+    auto& slot = readbackSlots_[nextReadbackSlot_];
+    if (slot.fence != nullptr || queuedEncodesNumber_ >= MAX_QUEUED_ENCODES)
+    {
+        if (screenshotFilePath_.isNull() && isRecording())
+        { ++droppedFramesNumber_; }
+        return;
+    }
+    auto filePath = nextFilePath();
+    if (filePath.isNull())
+    { return; }
+    readPixels(slot, framebuffer, size, filePath);
+    nextReadbackSlot_ = (nextReadbackSlot_ + 1) % READBACK_SLOTS_NUMBER;
+}
+
+void FrameCapturer::readPixels(ReadbackSlot& slot, GLuint framebuffer, QSize const& size, QString const& filePath)
+{
+    int bufferSize = size.width() * size.height() * BYTES_PER_PIXEL;
+    if (!slot.buffer.isCreated())
+    {
+        slot.buffer.create();
+        slot.buffer.setUsagePattern(QOpenGLBuffer::StreamRead);
+    }
+    slot.buffer.bind();
+    if (slot.buffer.size() != bufferSize)
+    { slot.buffer.allocate(bufferSize); }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    slot.buffer.release();
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.size = size;
+    slot.filePath = filePath;
+}
+
+bool FrameCapturer::collectSlot(ReadbackSlot& slot, GLuint64 timeoutNs)
+{
+    if (slot.fence == nullptr)
+    { return false; }
+    auto waitResult = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+    if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+    { return false; }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    // Blending writes the destination alpha as well, the saved frames have to be opaque.
+    QImage image(slot.size, QImage::Format_RGBX8888);
+    slot.buffer.bind();
+    auto const* pixels = static_cast<uchar const*>(
+                slot.buffer.mapRange(0, slot.buffer.size(), QOpenGLBuffer::RangeRead));
+    if (pixels != nullptr)
+    {
+        std::memcpy(image.bits(), pixels, slot.buffer.size());
+        slot.buffer.unmap();
+    }
+    slot.buffer.release();
+    if (pixels == nullptr)
+    { return false; }
+    auto filePath = slot.filePath;
+    ++queuedEncodesNumber_;
+    QtConcurrent::run(&encodingThreadPool_, [this, image, filePath]() {
+        if (!image.mirrored().save(filePath, "PNG"))
+        { ++failedWritesNumber_; }
+        --queuedEncodesNumber_;
+    });
+    return true;
+}
+
+void FrameCapturer::flush()
+{
+    for (int slotOffset = 0; slotOffset < READBACK_SLOTS_NUMBER; ++slotOffset)
+    { collectSlot(readbackSlots_[(nextReadbackSlot_ + slotOffset) % READBACK_SLOTS_NUMBER], FLUSH_TIMEOUT_NS); }
+    encodingThreadPool_.waitForDone();
+}
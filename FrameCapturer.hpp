@@ -0,0 +1,66 @@
+#ifndef FRAMECAPTURER_HPP
+#define FRAMECAPTURER_HPP
+
+#include <QOpenGLBuffer>
+#include <QOpenGLExtraFunctions>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <array>
+#include <atomic>
+
+class FrameCapturer : protected QOpenGLExtraFunctions
+{
+public:
+    FrameCapturer();
+    ~FrameCapturer();
+
+    void initialize();
+    void destroy();
+    void requestScreenshot(QString const& filePath);
+    void startRecording(QString const& directoryPath);
+    void stopRecording();
+    // A recording stops by itself once a frame could not be written.
+    bool isRecording() const
+    { return isRecording_ && failedWritesNumber_ == 0; }
+    uint32_t recordedFramesNumber() const
+    { return recordedFramesNumber_; }
+    // Recorded frames skipped because the readbacks or the encoding queue were still full.
+    uint32_t droppedFramesNumber() const
+    { return droppedFramesNumber_; }
+    uint32_t failedWritesNumber() const
+    { return failedWritesNumber_; }
+    bool isCapturePending() const;
+    void captureFrame(GLuint framebuffer, QSize const& size);
+    // Collects the pending readbacks and waits until their images are written.
+    void flush();
+
+private:
+    static constexpr int const READBACK_SLOTS_NUMBER = 3;
+    static constexpr int const MAX_QUEUED_ENCODES = 8;
+
+    struct ReadbackSlot
+    {
+        QOpenGLBuffer buffer;
+        GLsync fence;
+        QSize size;
+        QString filePath;
+    };
+
+    QString nextFilePath();
+    void readPixels(ReadbackSlot& slot, GLuint framebuffer, QSize const& size, QString const& filePath);
+    bool collectSlot(ReadbackSlot& slot, GLuint64 timeoutNs);
+
+    std::array<ReadbackSlot, READBACK_SLOTS_NUMBER> readbackSlots_;
+    int nextReadbackSlot_;
+    QString screenshotFilePath_;
+    bool isRecording_;
+    QString recordingDirectoryPath_;
+    uint32_t recordedFramesNumber_;
+    uint32_t droppedFramesNumber_;
+    std::atomic<int> queuedEncodesNumber_;
+    std::atomic<uint32_t> failedWritesNumber_;
+    QThreadPool encodingThreadPool_;
+};
+
+#endif // FRAMECAPTURER_HPP
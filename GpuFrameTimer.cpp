@@ -0,0 +1,85 @@
+#include "GpuFrameTimer.hpp"
+
+GpuFrameTimer::GpuFrameTimer()
+    : isGpuTimed_{false},
+      nextTimedFrame_{0},
+      isMeasuring_{false},
+      isCpuFrameTimeAvailable_{false},
+      cpuFrameTimeMs_{0.0f}
+{}
+
+void GpuFrameTimer::initialize()
+{
+    isGpuTimed_ = true;
+    for (auto& timedFrame : timedFrames_)
+    {
+        timedFrame.query = std::make_unique<QOpenGLTimerQuery>();
+        timedFrame.isPending = false;
+        isGpuTimed_ = isGpuTimed_ && timedFrame.query->create();
+    }
+    if (!isGpuTimed_)
+    { destroy(); }
+}
+
+void GpuFrameTimer::destroy()
+{
+    for (auto& timedFrame : timedFrames_)
+    {
+        if (timedFrame.query != nullptr && timedFrame.query->isCreated())
+        { timedFrame.query->destroy(); }
+        timedFrame.query.reset();
+        timedFrame.isPending = false;
+    }
+    isGpuTimed_ = false;
+}
+
+void GpuFrameTimer::begin()
+{
+    if (!isGpuTimed_)
+    {
+        cpuTimer_.start();
+        return;
+    }
+    auto& timedFrame = timedFrames_[nextTimedFrame_];
+    isMeasuring_ = !timedFrame.isPending;
+    if (isMeasuring_)
+    { timedFrame.query->begin(); }
+}
+
+void GpuFrameTimer::end()
+{
+    if (!isGpuTimed_)
+    {
+        cpuFrameTimeMs_ = cpuTimer_.nsecsElapsed() / 1000000.0f;
+        isCpuFrameTimeAvailable_ = true;
+        return;
+    }
+    if (!isMeasuring_)
+    { return; }
+    auto& timedFrame = timedFrames_[nextTimedFrame_];
+    timedFrame.query->end();
+    timedFrame.isPending = true;
+    nextTimedFrame_ = (nextTimedFrame_ + 1) % QUERIES_NUMBER;
+    isMeasuring_ = false;
+}
+
+bool GpuFrameTimer::takeFrameTime(float& frameTimeMs)
+{
+    if (!isGpuTimed_)
+    {
+        frameTimeMs = cpuFrameTimeMs_;
+        bool isAvailable = isCpuFrameTimeAvailable_;
+        isCpuFrameTimeAvailable_ = false;
+        return isAvailable;
+    }
+    for (int frameOffset = 0; frameOffset < QUERIES_NUMBER; ++frameOffset)
+    {
+        auto& timedFrame = timedFrames_[(nextTimedFrame_ + frameOffset) % QUERIES_NUMBER];
+        if (!timedFrame.isPending || !timedFrame.query->isResultAvailable())
+        { continue; }
+        frameTimeMs = timedFrame.query->waitForResult() / 1000000.0f;
+        timedFrame.isPending = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,40 @@
+#ifndef GPUFRAMETIMER_HPP
+#define GPUFRAMETIMER_HPP
+
+#include <QElapsedTimer>
+#include <QOpenGLTimerQuery>
+#include <array>
+#include <memory>
+
+class GpuFrameTimer
+{
+public:
+    GpuFrameTimer();
+
+    void initialize();
+    void destroy();
+    bool isGpuTimed() const
+    { return isGpuTimed_; }
+    void begin();
+    void end();
+    bool takeFrameTime(float& frameTimeMs);
+
+private:
+    static constexpr int const QUERIES_NUMBER = 3;
+
+    struct TimedFrame
+    {
+        std::unique_ptr<QOpenGLTimerQuery> query;
+        bool isPending;
+    };
+
+    bool isGpuTimed_;
+    std::array<TimedFrame, QUERIES_NUMBER> timedFrames_;
+    int nextTimedFrame_;
+    bool isMeasuring_;
+    QElapsedTimer cpuTimer_;
+    bool isCpuFrameTimeAvailable_;
+    float cpuFrameTimeMs_;
+};
+
+#endif // GPUFRAMETIMER_HPP
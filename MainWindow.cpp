@@ -1,12 +1,25 @@
+#include "DumpCatalogDialog.hpp"
+#include "DumpCatalogIndexer.hpp"
 #include "MainWindow.hpp"
 #include "PsxRamConst.hpp"
 #include "PsxVRamConst.hpp"
+#include "ScenePvs.hpp"
 #include "ui_MainWindow.h"
 #include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QGuiApplication>
+#include <QInputDialog>
 #include <QKeyEvent>
+#include <QLineEdit>
 #include <QMessageBox>
 #include <QMouseEvent>
+#include <QStatusBar>
+#include <QtConcurrent>
+#include <climits>
 #include <cmath>
 #include <cstring>
 
@@ -16,10 +29,34 @@ MainWindow::MainWindow(QWidget *parent)
 {
     psxRam_ = std::make_unique<BufferedPsxRam>();
     ui->setupUi(this);
+#ifndef Q_OS_LINUX
+    ui->action_AttachToEmulator->setVisible(false);
+    ui->action_RefreshFromEmulator->setVisible(false);
+    ui->action_RecordDumpSequence->setVisible(false);
+#endif
+    renderStatisticsLabel_ = new QLabel(this);
+    statusBar()->addPermanentWidget(renderStatisticsLabel_);
+    connect(
+                ui->sceneRenderOpenGLWidget, &SceneGLRenderer::frameRendered,
+                this, &MainWindow::onSceneFrameRendered);
+    connect(
+                ui->sceneRenderOpenGLWidget, &SceneGLRenderer::sceneChanged,
+                this, &MainWindow::onSceneChanged);
+    connect(
+                ui->sceneRenderOpenGLWidget, &SceneGLRenderer::glInitializationFailed,
+                this, &MainWindow::onSceneGlInitializationFailed);
     connect(
                 &keyboardControlsTimer_, &QTimer::timeout,
                 this, &MainWindow::onKeyboardControlsTimerTimeout);
     keyboardControlsTimer_.start(5);
+    connect(
+                &dumpSequencePlaybackTimer_, &QTimer::timeout,
+                this, &MainWindow::onDumpSequencePlaybackTimerTimeout);
+#ifdef Q_OS_LINUX
+    connect(
+                &dumpSequenceRecordingTimer_, &QTimer::timeout,
+                this, &MainWindow::onDumpSequenceRecordingTimerTimeout);
+#endif
     keyboardControlsTimerLastExecutionMs_ = QDateTime::currentMSecsSinceEpoch();
     setFocus();
 }
@@ -32,6 +69,8 @@ MainWindow::~MainWindow()
 
 void MainWindow::keyPressEvent(QKeyEvent* event)
 {
+    if (!event->isAutoRepeat())
+    { pressedKeys_.insert(event->key()); }
     switch (event->key())
     {
     case Qt::Key_1:
@@ -40,6 +79,21 @@ void MainWindow::keyPressEvent(QKeyEvent* event)
     case Qt::Key_2:
         ui->sceneRenderOpenGLWidget->toggleDrawSemiTransparent();
         break;
+    case Qt::Key_3:
+        ui->sceneRenderOpenGLWidget->toggleOcclusionCulling();
+        break;
+    case Qt::Key_4:
+        ui->sceneRenderOpenGLWidget->toggleOverdrawHeatmap();
+        break;
+    case Qt::Key_5:
+        ui->sceneRenderOpenGLWidget->toggleLod();
+        break;
+    case Qt::Key_6:
+        ui->sceneRenderOpenGLWidget->togglePvsCulling();
+        break;
+    case Qt::Key_7:
+        ui->sceneRenderOpenGLWidget->toggleMinimap();
+        break;
     case Qt::Key_R:
         ui->sceneRenderOpenGLWidget->resetCamera();
         break;
@@ -48,6 +102,21 @@ void MainWindow::keyPressEvent(QKeyEvent* event)
         return;
     }
 }
+
+void MainWindow::keyReleaseEvent(QKeyEvent* event)
+{
+    if (!event->isAutoRepeat())
+    { pressedKeys_.remove(event->key()); }
+    QMainWindow::keyReleaseEvent(event);
+}
+
+void MainWindow::focusOutEvent(QFocusEvent* event)
+{
+    // Releases happening while unfocused are never delivered.
+    pressedKeys_.clear();
+    QMainWindow::focusOutEvent(event);
+}
+
 void MainWindow::mousePressEvent(QMouseEvent* event)
 {
     if (event->button() == Qt::RightButton)
@@ -55,6 +124,8 @@ void MainWindow::mousePressEvent(QMouseEvent* event)
         isTrackingMouse_ = true;
         lastMousePosition_ = event->pos();
     }
+    else if (event->button() == Qt::LeftButton)
+    { showPickedPolygon(ui->sceneRenderOpenGLWidget->mapFrom(this, event->pos())); }
     else
     { QMainWindow::mousePressEvent(event); }
 }
@@ -91,38 +162,687 @@ void MainWindow::mouseMoveEvent(QMouseEvent* event)
     { QMainWindow::mouseMoveEvent(event); }
 }
 
+void MainWindow::showPickedPolygon(QPoint const& position)
+{
+    if (!ui->sceneRenderOpenGLWidget->rect().contains(position))
+    { return; }
+    QElapsedTimer pickTimer;
+    pickTimer.start();
+    ScenePolygonSource polygonSource;
+    bool isPicked = ui->sceneRenderOpenGLWidget->pickPolygon(position, polygonSource);
+    auto pickTimeUs = pickTimer.nsecsElapsed() / 1000;
+    if (!isPicked)
+    {
+        statusBar()->showMessage(QString("No polygon under cursor (%1 us).").arg(pickTimeUs));
+        return;
+    }
+    auto const& descriptor = polygonSource.descriptor;
+    auto const& texpage = descriptor.texCoord2AndTexPage.fields.texpage;
+    auto texCoordString = [](GpuTexCoord const& texCoord) {
+        return QString("(%1, %2)").arg(texCoord.x).arg(texCoord.y);
+    };
+    statusBar()->showMessage(
+                QString("Voxel (%1, %2), descriptor at 0x%3: vertices %4/%5/%6/%7, "
+                        "tex coords %8 %9 %10 %11, texpage (%12, %13, bpp %14, semi-transparency %15), "
+                        "CLUT (%16, %17), normal %18, flags 0x%19, semi-transparent %20 (%21 us).")
+                .arg(polygonSource.voxelX)
+                .arg(polygonSource.voxelY)
+                .arg(polygonSource.address.raw(), 8, 16, QChar('0'))
+                .arg(descriptor.vertex1Index)
+                .arg(descriptor.vertex2Index)
+                .arg(descriptor.vertex3Index)
+                .arg(descriptor.vertex4Index)
+                .arg(texCoordString(descriptor.texCoord1))
+                .arg(texCoordString(descriptor.texCoord2()))
+                .arg(texCoordString(descriptor.texCoord3))
+                .arg(texCoordString(descriptor.texCoord4))
+                .arg(texpage.x)
+                .arg(texpage.y)
+                .arg(texpage.texpageBpp)
+                .arg(texpage.semiTransparency)
+                .arg(descriptor.clut.x)
+                .arg(descriptor.clut.y)
+                .arg(descriptor.normalVectorIndex)
+                .arg(descriptor.flags.lsb.raw, 2, 16, QChar('0'))
+                .arg(descriptor.flags.isSemiTransparent() ? "yes" : "no")
+                .arg(pickTimeUs));
+}
+
 void MainWindow::on_action_Open_triggered()
 {
     auto filePath = QFileDialog::getOpenFileName(this, "Open AD 3D model", {}, "AD 3D models (*.3dm)");
     if (filePath.isNull())
     { return; }
+    openDump(filePath);
+}
+
+void MainWindow::openDump(QString const& filePath)
+{
+    dumpPrefetcher_.clear();
+    loadDump(filePath, false);
+}
+
+void MainWindow::loadDump(QString const& filePath, bool isStep)
+{
+    dumpPath_ = filePath;
+    auto sceneKey = fileSceneKey(filePath);
+    if (showResidentScene(sceneKey) || (isStep && showPrefetchedScene(filePath, sceneKey)))
+    { return; }
+    QElapsedTimer loadTimer;
+    loadTimer.start();
     QFile file(filePath);
     if (!file.open(QFile::ReadOnly))
     {
         QMessageBox::warning(this,  "Read AD 3D model error",  QString("Could not open file %1.").arg(filePath));
         return;
     }
-    auto fileContent = file.readAll();
     int expectedSize = PsxRamConst::SIZE + PsxVRamConst::SIZE;
-    if (fileContent.size() != expectedSize)
+    if (file.size() != expectedSize)
     {
         QMessageBox::warning(
                     this,
                     "Read AD 3D model error",
                     QString("File size %1 is different than expected %2.")
-                    .arg(fileContent.size())
+                    .arg(file.size())
                     .arg(expectedSize));
         return;
     }
-    psxRam_->fill(fileContent.data());
-    psxVRam_ = QByteArray(fileContent.data() + PsxRamConst::SIZE, PsxVRamConst::SIZE);
-    adScene_.read(*psxRam_, psxVRam_);
-    ui->sceneRenderOpenGLWidget->loadScene(adScene_);
+    // Mapped instead of read, so only the VRAM kept by the scene is copied to the heap.
+    auto const* fileContent = reinterpret_cast<char const*>(file.map(0, expectedSize));
+    if (fileContent == nullptr)
+    {
+        QMessageBox::warning(this,  "Read AD 3D model error",  QString("Could not read file %1.").arg(filePath));
+        return;
+    }
+    psxRam_->fill(fileContent);
+    psxVRam_ = QByteArray(fileContent + PsxRamConst::SIZE, PsxVRamConst::SIZE);
+    file.close();
+    if (!showPsxMemoryScene(sceneKey, true))
+    { return; }
+    statusBar()->showMessage(
+                QString("Loaded %1 in %2 ms, scene buffers hold %3 KiB, mesh buffers %4 KiB.%5")
+                .arg(sceneDisplayName(sceneKey))
+                .arg(loadTimer.elapsed())
+                .arg(adScene_.scratchMemorySize() / 1024)
+                .arg(ui->sceneRenderOpenGLWidget->sceneMeshMemorySize() / 1024)
+                .arg(loadScenePvs(filePath)));
+}
+
+void MainWindow::on_action_NextDump_triggered()
+{ stepDump(1); }
+
+void MainWindow::on_action_PreviousDump_triggered()
+{ stepDump(-1); }
+
+void MainWindow::stepDump(int direction)
+{
+    if (dumpPath_.isEmpty())
+    { return; }
+    QFileInfo dumpInfo(dumpPath_);
+    QDir dumpDir(dumpInfo.absolutePath());
+    QStringList filePaths;
+    for (auto const& fileName : dumpDir.entryList({"*.3dm"}, QDir::Files, QDir::Name))
+    { filePaths.append(dumpDir.absoluteFilePath(fileName)); }
+    auto nextIndex = filePaths.indexOf(dumpInfo.absoluteFilePath()) + direction;
+    if (nextIndex < 0 || nextIndex >= filePaths.count())
+    {
+        statusBar()->showMessage("No more models in this folder.");
+        return;
+    }
+    loadDump(filePaths[nextIndex], true);
+    // Started after the step, so parsing the neighbours does not compete with a miss loading synchronously.
+    dumpPrefetcher_.prefetch(filePaths, nextIndex, direction);
+}
+
+bool MainWindow::showPrefetchedScene(QString const& filePath, QString const& sceneKey)
+{
+    QElapsedTimer uploadTimer;
+    uploadTimer.start();
+    auto scene = dumpPrefetcher_.take(filePath);
+    if (scene == nullptr)
+    { return false; }
+    ui->sceneRenderOpenGLWidget->loadScene(scene->mesh, scene->vram, sceneKey);
     ui->sceneRenderOpenGLWidget->resetCamera();
+    statusBar()->showMessage(
+                QString("Loaded prefetched %1 in %2 ms.%3")
+                .arg(sceneDisplayName(sceneKey))
+                .arg(uploadTimer.elapsed())
+                .arg(loadScenePvs(filePath)));
+    return true;
+}
+
+QString MainWindow::loadScenePvs(QString const& dumpPath)
+{
+    auto pvsPath = ScenePvs::filePath(dumpPath);
+    if (!QFileInfo::exists(pvsPath))
+    { return {}; }
+    ScenePvs pvs;
+    try
+    { pvs.load(pvsPath); }
+    catch (QString const& error)
+    { return QString(" %1").arg(error); }
+    if (!ui->sceneRenderOpenGLWidget->setScenePvs(std::move(pvs)))
+    { return QString(" PVS file %1 is out of date, rebuild it with PvsBuilder.").arg(pvsPath); }
+    return " PVS loaded.";
+}
+
+QString MainWindow::fileSceneKey(QString const& filePath)
+{
+    QFileInfo fileInfo(filePath);
+    return QString("%1|%2|%3")
+            .arg(fileInfo.canonicalFilePath())
+            .arg(fileInfo.lastModified().toMSecsSinceEpoch())
+            .arg(fileInfo.size());
+}
+
+QString MainWindow::sceneDisplayName(QString const& sceneKey)
+{
+    auto displayName = QFileInfo(sceneKey.section('|', 0, 0)).fileName();
+    auto frameName = sceneKey.section('|', 3, 3);
+    return frameName.isEmpty() ? displayName : QString("%1 %2").arg(displayName).arg(frameName);
+}
+
+bool MainWindow::showResidentScene(QString const& sceneKey)
+{
+    QElapsedTimer switchTimer;
+    switchTimer.start();
+    bool wasResident = ui->sceneRenderOpenGLWidget->isSceneResident(sceneKey);
+    if (!ui->sceneRenderOpenGLWidget->activateScene(sceneKey))
+    { return false; }
+    statusBar()->showMessage(
+                QString("Switched to %1 scene %2 in %3 ms.")
+                .arg(wasResident ? "resident" : "cached")
+                .arg(sceneDisplayName(sceneKey))
+                .arg(switchTimer.elapsed()));
+    return true;
+}
+
+bool MainWindow::showPsxMemoryScene(QString const& sceneKey, bool resetCamera)
+{
+    try
+    { adScene_.read(*psxRam_, psxVRam_); }
+    catch (QString const& error)
+    {
+        QMessageBox::warning(this, "Read AD 3D model error", error);
+        return false;
+    }
+    ui->sceneRenderOpenGLWidget->loadScene(adScene_, sceneKey);
+    if (resetCamera)
+    { ui->sceneRenderOpenGLWidget->resetCamera(); }
+    return true;
+}
+
+void MainWindow::on_action_BrowseDumpArchive_triggered()
+{
+    if (isDumpArchiveIndexing_)
+    {
+        statusBar()->showMessage("A dump archive is already being indexed.");
+        return;
+    }
+    auto rootPath = QFileDialog::getExistingDirectory(this, "Browse dump archive");
+    if (rootPath.isNull())
+    { return; }
+    auto catalogPath = DumpCatalogIndexer::defaultCatalogPath(rootPath);
+    if (dumpCatalogDialog_ != nullptr)
+    {
+        // The indexer replaces the catalog file, which fails on some systems while the dialog maps it.
+        dumpCatalogDialog_->hide();
+        dumpCatalogDialog_->closeCatalog();
+    }
+    auto statistics = std::make_shared<DumpCatalogIndexer::Statistics>();
+    QElapsedTimer indexTimer;
+    indexTimer.start();
+    auto* indexing = new QFutureWatcher<QString>(this);
+    connect(
+                indexing, &QFutureWatcher<QString>::finished,
+                this, [this, indexing, statistics, catalogPath, indexTimer]() {
+        isDumpArchiveIndexing_ = false;
+        indexing->deleteLater();
+        auto error = indexing->result();
+        if (!error.isEmpty())
+        {
+            statusBar()->clearMessage();
+            QMessageBox::warning(this, "Index dump archive error", error);
+            return;
+        }
+        statusBar()->showMessage(
+                    QString("Indexed %1 dumps in %2 ms: %3 scanned, %4 failed, %5 duplicates.")
+                    .arg(statistics->filesNumber)
+                    .arg(indexTimer.elapsed())
+                    .arg(statistics->scannedFilesNumber)
+                    .arg(statistics->failedFilesNumber)
+                    .arg(statistics->duplicatesNumber));
+        showDumpCatalog(catalogPath);
+    });
+    isDumpArchiveIndexing_ = true;
+    statusBar()->showMessage(QString("Indexing %1...").arg(rootPath));
+    // Indexed off the GUI thread; the dialog is shown once the catalog is written.
+    indexing->setFuture(QtConcurrent::run([rootPath, catalogPath, statistics]() {
+        DumpCatalogIndexer indexer;
+        try
+        { *statistics = indexer.index(rootPath, catalogPath); }
+        catch (QString const& error)
+        { return error; }
+        return QString();
+    }));
+}
+
+void MainWindow::showDumpCatalog(QString const& catalogPath)
+{
+    if (dumpCatalogDialog_ == nullptr)
+    {
+        dumpCatalogDialog_ = new DumpCatalogDialog(this);
+        connect(dumpCatalogDialog_, &DumpCatalogDialog::dumpActivated, this, &MainWindow::openDump);
+    }
+    try
+    { dumpCatalogDialog_->showCatalog(catalogPath); }
+    catch (QString const& error)
+    {
+        QMessageBox::warning(this, "Open dump catalog error", error);
+        return;
+    }
+    dumpCatalogDialog_->show();
+    dumpCatalogDialog_->raise();
+}
+
+void MainWindow::on_action_ImportSavestate_triggered()
+{
+    auto filePath = QFileDialog::getOpenFileName(
+                this,
+                "Import emulator savestate",
+                {},
+                "Emulator savestates (*.gz *.000 *.001 *.002 *.003 *.004 *.sav);;All files (*)");
+    if (filePath.isNull())
+    { return; }
+    auto sceneKey = fileSceneKey(filePath);
+    if (showResidentScene(sceneKey))
+    { return; }
+    QElapsedTimer importTimer;
+    importTimer.start();
+    QString formatName;
+    try
+    { formatName = savestateImporter_.import(filePath, *psxRam_, psxVRam_); }
+    catch (QString const& error)
+    {
+        QMessageBox::warning(this, "Import savestate error", error);
+        return;
+    }
+    auto importTimeMs = importTimer.elapsed();
+    if (showPsxMemoryScene(sceneKey, true))
+    { statusBar()->showMessage(QString("Imported %1 savestate in %2 ms.").arg(formatName).arg(importTimeMs)); }
+}
+
+void MainWindow::on_action_AttachToEmulator_triggered()
+{
+#ifdef Q_OS_LINUX
+    bool ok = false;
+    auto pid = QInputDialog::getInt(this, "Attach to emulator", "Emulator process ID:", 0, 1, INT_MAX, 1, &ok);
+    if (!ok)
+    { return; }
+    auto vramOffsetText = QInputDialog::getText(
+                this,
+                "Attach to emulator",
+                "VRAM offset from PSX RAM (hex):",
+                QLineEdit::Normal,
+                QString::number(PsxRamConst::SIZE, 16),
+                &ok);
+    if (!ok)
+    { return; }
+    auto vramOffset = vramOffsetText.toLongLong(&ok, 16);
+    if (!ok)
+    {
+        QMessageBox::warning(this, "Attach to emulator error", QString("Invalid VRAM offset %1.").arg(vramOffsetText));
+        return;
+    }
+    auto emulatorProcessMemory = std::make_unique<EmulatorProcessMemory>(pid, vramOffset);
+    try
+    { emulatorProcessMemory->attach(); }
+    catch (QString const& error)
+    {
+        QMessageBox::warning(this, "Attach to emulator error", error);
+        return;
+    }
+    // A recording holds the frames of one emulator only.
+    ui->action_RecordDumpSequence->setChecked(false);
+    emulatorProcessMemory_ = std::move(emulatorProcessMemory);
+    ui->action_RefreshFromEmulator->setEnabled(true);
+    ui->action_RecordDumpSequence->setEnabled(true);
+    auto const& scanStatistics = emulatorProcessMemory_->scanStatistics();
+    statusBar()->showMessage(
+                scanStatistics.isCached ?
+                    QString("PSX RAM found at cached address 0x%1 (%2 ms).")
+                    .arg(emulatorProcessMemory_->psxRamAddress(), 0, 16)
+                    .arg(scanStatistics.scanTimeMs) :
+                    QString("PSX RAM found at 0x%1 after scanning %2 MB (%3 ms).")
+                    .arg(emulatorProcessMemory_->psxRamAddress(), 0, 16)
+                    .arg(scanStatistics.scannedBytes >> 20)
+                    .arg(scanStatistics.scanTimeMs));
+    if (readEmulatorMemory())
+    { showPsxMemoryScene(emulatorSceneKey(), true); }
+#endif
+}
+
+void MainWindow::on_action_RefreshFromEmulator_triggered()
+{
+#ifdef Q_OS_LINUX
+    if (emulatorProcessMemory_ != nullptr && readEmulatorMemory())
+    { showPsxMemoryScene(emulatorSceneKey(), false); }
+#endif
+}
+
+void MainWindow::on_action_OpenDumpSequence_triggered()
+{
+    auto filePath = QFileDialog::getOpenFileName(this, "Open dump sequence", {}, "Dump sequences (*.3ds)");
+    if (filePath.isNull())
+    { return; }
+    ui->action_PlayDumpSequence->setChecked(false);
+    try
+    { dumpSequenceReader_.open(filePath); }
+    catch (QString const& error)
+    {
+        QMessageBox::warning(this, "Open dump sequence error", error);
+        ui->dumpSequenceSlider->setVisible(false);
+        ui->action_PlayDumpSequence->setEnabled(false);
+        return;
+    }
+    dumpSequenceSceneKey_ = fileSceneKey(filePath);
+    {
+        QSignalBlocker sliderBlocker(ui->dumpSequenceSlider);
+        ui->dumpSequenceSlider->setRange(0, qMax(0, static_cast<int>(dumpSequenceReader_.framesNumber()) - 1));
+        ui->dumpSequenceSlider->setValue(0);
+    }
+    ui->dumpSequenceSlider->setVisible(dumpSequenceReader_.framesNumber() > 0);
+    ui->action_PlayDumpSequence->setEnabled(dumpSequenceReader_.framesNumber() > 1);
+    if (dumpSequenceReader_.framesNumber() > 0)
+    {
+        showDumpSequenceFrame(0);
+        ui->sceneRenderOpenGLWidget->resetCamera();
+    }
+}
+
+void MainWindow::on_dumpSequenceSlider_valueChanged(int value)
+{ showDumpSequenceFrame(value); }
+
+void MainWindow::showDumpSequenceFrame(int frameIndex)
+{
+    auto sceneKey = QString("%1|frame %2").arg(dumpSequenceSceneKey_).arg(frameIndex);
+    if (!ui->sceneRenderOpenGLWidget->activateScene(sceneKey))
+    {
+        try
+        {
+            dumpSequenceReader_.seek(frameIndex);
+            dumpSequenceReader_.readFrame(*psxRam_, psxVRam_);
+        }
+        catch (QString const& error)
+        {
+            ui->action_PlayDumpSequence->setChecked(false);
+            QMessageBox::warning(this, "Read dump sequence error", error);
+            return;
+        }
+        if (!showPsxMemoryScene(sceneKey, false))
+        {
+            ui->action_PlayDumpSequence->setChecked(false);
+            return;
+        }
+    }
+    statusBar()->showMessage(
+                QString("Dump sequence frame %1/%2.").arg(frameIndex + 1).arg(dumpSequenceReader_.framesNumber()));
 }
 
-bool isKeyPressed(int key)
-{ return GetAsyncKeyState(key) < 0; }
+void MainWindow::on_action_PlayDumpSequence_toggled(bool checked)
+{
+    static constexpr int PLAYBACK_FRAME_INTERVAL_MS = 33;
+    if (!checked)
+    {
+        dumpSequencePlaybackTimer_.stop();
+        return;
+    }
+    if (ui->dumpSequenceSlider->value() == ui->dumpSequenceSlider->maximum())
+    { ui->dumpSequenceSlider->setValue(0); }
+    dumpSequencePlaybackTimer_.start(PLAYBACK_FRAME_INTERVAL_MS);
+}
+
+void MainWindow::onDumpSequencePlaybackTimerTimeout()
+{
+    auto* slider = ui->dumpSequenceSlider;
+    if (slider->value() >= slider->maximum())
+    {
+        ui->action_PlayDumpSequence->setChecked(false);
+        return;
+    }
+    slider->setValue(slider->value() + 1);
+}
+
+void MainWindow::on_action_RecordDumpSequence_toggled(bool checked)
+{
+#ifdef Q_OS_LINUX
+    static constexpr int RECORDING_FRAME_INTERVAL_MS = 100;
+    if (!checked)
+    {
+        dumpSequenceRecordingTimer_.stop();
+        try
+        { dumpSequenceWriter_.close(); }
+        catch (QString const& error)
+        { QMessageBox::warning(this, "Record dump sequence error", error); }
+        return;
+    }
+    auto filePath = emulatorProcessMemory_ != nullptr ?
+                QFileDialog::getSaveFileName(this, "Record dump sequence", {}, "Dump sequences (*.3ds)") :
+                QString();
+    if (!filePath.isNull())
+    {
+        try
+        {
+            dumpSequenceWriter_.open(filePath);
+            dumpSequenceRecordingTimer_.start(RECORDING_FRAME_INTERVAL_MS);
+            return;
+        }
+        catch (QString const& error)
+        { QMessageBox::warning(this, "Record dump sequence error", error); }
+    }
+    QSignalBlocker actionBlocker(ui->action_RecordDumpSequence);
+    ui->action_RecordDumpSequence->setChecked(false);
+#else
+    Q_UNUSED(checked);
+#endif
+}
+
+void MainWindow::onDumpSequenceRecordingTimerTimeout()
+{
+#ifdef Q_OS_LINUX
+    if (emulatorProcessMemory_ == nullptr)
+    {
+        ui->action_RecordDumpSequence->setChecked(false);
+        return;
+    }
+    try
+    {
+        emulatorProcessMemory_->readPsxRam(*psxRam_);
+        emulatorProcessMemory_->readPsxVRam(psxVRam_);
+        dumpSequenceWriter_.addFrame(*psxRam_, psxVRam_);
+    }
+    catch (QString const& error)
+    {
+        ui->action_RecordDumpSequence->setChecked(false);
+        QMessageBox::warning(this, "Record dump sequence error", error);
+        return;
+    }
+    statusBar()->showMessage(
+                QString("Recorded %1 frames into %2 KB.")
+                .arg(dumpSequenceWriter_.framesNumber())
+                .arg(dumpSequenceWriter_.writtenBytes() >> 10));
+#endif
+}
+
+#ifdef Q_OS_LINUX
+QString MainWindow::emulatorSceneKey() const
+{ return QString("emulator %1").arg(emulatorProcessMemory_->pid()); }
+
+bool MainWindow::readEmulatorMemory()
+{
+    try
+    {
+        emulatorProcessMemory_->readPsxRam(*psxRam_);
+        emulatorProcessMemory_->readPsxVRam(psxVRam_);
+    }
+    catch (QString const& error)
+    {
+        QMessageBox::warning(this, "Read emulator memory error", error);
+        return false;
+    }
+    return true;
+}
+#endif
+
+void MainWindow::on_action_SaveScreenshot_triggered()
+{
+    auto filePath = QFileDialog::getSaveFileName(this, "Save screenshot", {}, "PNG images (*.png)");
+    if (filePath.isNull())
+    { return; }
+    ui->sceneRenderOpenGLWidget->captureScreenshot(filePath);
+}
+
+void MainWindow::on_action_RecordFrames_toggled(bool checked)
+{
+    if (!checked)
+    {
+        auto* sceneRenderer = ui->sceneRenderOpenGLWidget;
+        sceneRenderer->stopFramesRecording();
+        statusBar()->showMessage(
+                    QString("Recorded %1 frames, %2 dropped, %3 could not be written.")
+                    .arg(sceneRenderer->recordedFramesNumber())
+                    .arg(sceneRenderer->droppedFramesNumber())
+                    .arg(sceneRenderer->failedFrameWritesNumber()));
+        return;
+    }
+    auto directoryPath = QFileDialog::getExistingDirectory(this, "Record frames to directory");
+    if (directoryPath.isNull())
+    {
+        QSignalBlocker actionBlocker(ui->action_RecordFrames);
+        ui->action_RecordFrames->setChecked(false);
+        return;
+    }
+    ui->sceneRenderOpenGLWidget->startFramesRecording(directoryPath);
+}
+
+void MainWindow::on_action_DynamicResolution_toggled(bool checked)
+{ ui->sceneRenderOpenGLWidget->setDynamicResolution(checked); }
+
+void MainWindow::on_action_FrameTimeBudget_triggered()
+{
+    bool ok = false;
+    auto frameTimeBudget = QInputDialog::getDouble(
+                this,
+                "Frame time budget",
+                "Frame time budget (ms):",
+                ui->sceneRenderOpenGLWidget->frameTimeBudget(),
+                1.0,
+                1000.0,
+                1,
+                &ok);
+    if (ok)
+    { ui->sceneRenderOpenGLWidget->setFrameTimeBudget(frameTimeBudget); }
+}
+
+void MainWindow::on_action_ResolutionScaleRange_triggered()
+{
+    bool ok = false;
+    auto minScale = QInputDialog::getDouble(
+                this,
+                "Resolution scale range",
+                "Minimal resolution scale:",
+                ui->sceneRenderOpenGLWidget->minResolutionScale(),
+                0.05,
+                1.0,
+                2,
+                &ok);
+    if (!ok)
+    { return; }
+    auto maxScale = QInputDialog::getDouble(
+                this,
+                "Resolution scale range",
+                "Maximal resolution scale:",
+                ui->sceneRenderOpenGLWidget->maxResolutionScale(),
+                minScale,
+                1.0,
+                2,
+                &ok);
+    if (ok)
+    { ui->sceneRenderOpenGLWidget->setResolutionScaleRange(minScale, maxScale); }
+}
+
+void MainWindow::on_menu_Scenes_aboutToShow()
+{
+    ui->menu_Scenes->clear();
+    ui->menu_Scenes->addAction(ui->action_PreviousScene);
+    ui->menu_Scenes->addSeparator();
+    auto const* sceneRenderer = ui->sceneRenderOpenGLWidget;
+    for (auto const& sceneKey : sceneRenderer->sceneKeys())
+    {
+        auto* sceneAction = ui->menu_Scenes->addAction(
+                    QString("%1%2")
+                    .arg(sceneDisplayName(sceneKey))
+                    .arg(sceneRenderer->isSceneResident(sceneKey) ? "" : " (evicted)"));
+        sceneAction->setCheckable(true);
+        sceneAction->setChecked(sceneKey == sceneRenderer->sceneKey());
+        connect(sceneAction, &QAction::triggered, this, [this, sceneKey]() { showResidentScene(sceneKey); });
+    }
+}
+
+void MainWindow::on_action_PreviousScene_triggered()
+{
+    auto sceneKeys = ui->sceneRenderOpenGLWidget->sceneKeys();
+    if (sceneKeys.count() >= 2)
+    { showResidentScene(sceneKeys[1]); }
+}
+
+void MainWindow::on_action_SceneMemoryBudget_triggered()
+{
+    bool ok = false;
+    auto sceneMemoryBudgetMb = QInputDialog::getInt(
+                this,
+                "Scene memory budget",
+                "GPU memory for resident scenes (MB):",
+                ui->sceneRenderOpenGLWidget->sceneMemoryBudget() >> 20,
+                1,
+                65536,
+                1,
+                &ok);
+    if (ok)
+    { ui->sceneRenderOpenGLWidget->setSceneMemoryBudget(static_cast<size_t>(sceneMemoryBudgetMb) << 20); }
+}
+
+void MainWindow::on_action_AddComparisonView_triggered()
+{
+    auto const* sceneRenderer = ui->sceneRenderOpenGLWidget;
+    auto* comparisonView = new SceneGLRenderer(this);
+    comparisonView->setWindowFlag(Qt::Window);
+    comparisonView->setAttribute(Qt::WA_DeleteOnClose);
+    comparisonView->setWindowTitle(
+                QString("Comparison view %1").arg(comparisonViews_.count() + 1));
+    comparisonView->resize(sceneRenderer->size());
+    connect(
+                comparisonView, &SceneGLRenderer::glInitializationFailed,
+                this, &MainWindow::onSceneGlInitializationFailed);
+    comparisonView->show();
+    comparisonView->shareScenes(*sceneRenderer);
+    comparisonView->copyView(*sceneRenderer);
+    comparisonViews_.removeAll(nullptr);
+    comparisonViews_.append(comparisonView);
+}
+
+void MainWindow::onSceneChanged(QString const& sceneKey)
+{
+    comparisonViews_.removeAll(nullptr);
+    for (auto& comparisonView : comparisonViews_)
+    {
+        if (comparisonView->sceneKey() != sceneKey)
+        { comparisonView->activateScene(sceneKey); }
+    }
+}
+
+void MainWindow::onSceneGlInitializationFailed(QString const& error)
+{ statusBar()->showMessage(QString("Rendering is disabled. %1").arg(error)); }
 
 void MainWindow::onKeyboardControlsTimerTimeout()
 {
@@ -132,7 +852,8 @@ void MainWindow::onKeyboardControlsTimerTimeout()
     { return; }
     static constexpr float VECTOR_CHANGE_PER_SEC = 1.0f;
     float timeElapsedFactor = (timeElapsed / 1000.0f);
-    float movementSpeed = VECTOR_CHANGE_PER_SEC * timeElapsedFactor * (isKeyPressed(VK_CONTROL) ? 1.0f : 0.1f);
+    float movementSpeed = VECTOR_CHANGE_PER_SEC * timeElapsedFactor
+            * (QGuiApplication::queryKeyboardModifiers().testFlag(Qt::ControlModifier) ? 1.0f : 0.1f);
     static constexpr float FOV_CHANGE_PER_SEC = 30.0f;
     float fovChange = FOV_CHANGE_PER_SEC * timeElapsedFactor;
     if (isKeyPressed(Qt::Key_W))
@@ -160,3 +881,27 @@ void MainWindow::onKeyboardControlsTimerTimeout()
     if (isKeyPressed(Qt::Key_X))
     { ui->sceneRenderOpenGLWidget->increaseFieldOfView(fovChange); }
 }
+
+void MainWindow::onSceneFrameRendered()
+{
+    auto const* sceneRenderer = ui->sceneRenderOpenGLWidget;
+    // A failed frame write stops the recording; the action is unchecked once the frame is done, as stopping
+    // makes the renderer context current.
+    if (ui->action_RecordFrames->isChecked() && !sceneRenderer->isRecordingFrames())
+    { QTimer::singleShot(0, this, [this]() { ui->action_RecordFrames->setChecked(false); }); }
+    auto culledChunksNumber = sceneRenderer->culledVoxelsChunksNumber();
+    renderStatisticsLabel_->setText(
+                QString("Frame: %1 ms, scale: %2, chunks visible: %3, culled: %4, PVS culled: %5, LOD: %6, "
+                        "scenes: %7/%8 MB, scene load: %9 ms, prefetch: %10 hits / %11 misses")
+                .arg(sceneRenderer->frameTime(), 0, 'f', 2)
+                .arg(sceneRenderer->resolutionScale(), 0, 'f', 2)
+                .arg(sceneRenderer->voxelsChunksNumber() - culledChunksNumber)
+                .arg(culledChunksNumber)
+                .arg(sceneRenderer->pvsCulledVoxelsChunksNumber())
+                .arg(sceneRenderer->lodVoxelsChunksNumber())
+                .arg(sceneRenderer->residentScenesMemorySize() >> 20)
+                .arg(sceneRenderer->sceneMemoryBudget() >> 20)
+                .arg(sceneRenderer->sceneLoadTime(), 0, 'f', 1)
+                .arg(dumpPrefetcher_.hitsNumber())
+                .arg(dumpPrefetcher_.missesNumber()));
+}
@@ -3,13 +3,27 @@
 
 #include "ADScene.hpp"
 #include "BufferedPsxRam.hpp"
+#include "DumpPrefetcher.hpp"
+#include "DumpSequenceReader.hpp"
+#include "SavestateImporter.hpp"
+#ifdef Q_OS_LINUX
+#include "DumpSequenceWriter.hpp"
+#include "EmulatorProcessMemory.hpp"
+#endif
+#include <QLabel>
+#include <QList>
 #include <QMainWindow>
+#include <QPointer>
+#include <QSet>
 #include <QTimer>
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
+class DumpCatalogDialog;
+class SceneGLRenderer;
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -20,21 +34,84 @@ public:
 
 protected:
     void keyPressEvent(QKeyEvent* event);
+    void keyReleaseEvent(QKeyEvent* event);
+    void focusOutEvent(QFocusEvent* event);
     void mousePressEvent(QMouseEvent* event);
     void mouseReleaseEvent(QMouseEvent* event);
     void mouseMoveEvent(QMouseEvent* event);
 
 private slots:
     void on_action_Open_triggered();
+    void openDump(QString const& filePath);
+    void on_action_NextDump_triggered();
+    void on_action_PreviousDump_triggered();
+    void on_action_BrowseDumpArchive_triggered();
+    void on_action_ImportSavestate_triggered();
+    void on_action_AttachToEmulator_triggered();
+    void on_action_RefreshFromEmulator_triggered();
+    void on_action_OpenDumpSequence_triggered();
+    void on_dumpSequenceSlider_valueChanged(int value);
+    void on_action_PlayDumpSequence_toggled(bool checked);
+    void onDumpSequencePlaybackTimerTimeout();
+    void on_action_RecordDumpSequence_toggled(bool checked);
+    void onDumpSequenceRecordingTimerTimeout();
+    void on_action_SaveScreenshot_triggered();
+    void on_action_RecordFrames_toggled(bool checked);
+    void on_action_DynamicResolution_toggled(bool checked);
+    void on_action_FrameTimeBudget_triggered();
+    void on_action_ResolutionScaleRange_triggered();
+    void on_menu_Scenes_aboutToShow();
+    void on_action_PreviousScene_triggered();
+    void on_action_SceneMemoryBudget_triggered();
+    void on_action_AddComparisonView_triggered();
+    void onSceneChanged(QString const& sceneKey);
+    void onSceneGlInitializationFailed(QString const& error);
     void onKeyboardControlsTimerTimeout();
+    void onSceneFrameRendered();
 
 private:
+    void showPickedPolygon(QPoint const& position);
+    bool isKeyPressed(int key) const
+    { return pressedKeys_.contains(key); }
+    static QString fileSceneKey(QString const& filePath);
+    static QString sceneDisplayName(QString const& sceneKey);
+    bool showResidentScene(QString const& sceneKey);
+    bool showPrefetchedScene(QString const& filePath, QString const& sceneKey);
+    void loadDump(QString const& filePath, bool isStep);
+    void stepDump(int direction);
+    bool showPsxMemoryScene(QString const& sceneKey, bool resetCamera);
+    void showDumpCatalog(QString const& catalogPath);
+    // Attaches the PVS cached next to the dump, if any; returns a status message suffix.
+    QString loadScenePvs(QString const& dumpPath);
+    void showDumpSequenceFrame(int frameIndex);
+#ifdef Q_OS_LINUX
+    QString emulatorSceneKey() const;
+    bool readEmulatorMemory();
+#endif
+
     Ui::MainWindow *ui;
+    QLabel* renderStatisticsLabel_;
     std::unique_ptr<BufferedPsxRam> psxRam_;
     QByteArray psxVRam_;
     ADScene adScene_;
+    QString dumpPath_;
+    DumpPrefetcher dumpPrefetcher_;
+    SavestateImporter savestateImporter_;
+    DumpSequenceReader dumpSequenceReader_;
+    QString dumpSequenceSceneKey_;
+    QTimer dumpSequencePlaybackTimer_;
+#ifdef Q_OS_LINUX
+    std::unique_ptr<EmulatorProcessMemory> emulatorProcessMemory_;
+    DumpSequenceWriter dumpSequenceWriter_;
+    QTimer dumpSequenceRecordingTimer_;
+#endif
+    QList<QPointer<SceneGLRenderer>> comparisonViews_;
+    DumpCatalogDialog* dumpCatalogDialog_{nullptr};
+    bool isDumpArchiveIndexing_{false};
     QTimer keyboardControlsTimer_;
     qint64 keyboardControlsTimerLastExecutionMs_;
+    // Held keys polled by the keyboard controls timer, tracked from key events so it works on every platform.
+    QSet<int> pressedKeys_;
     bool isTrackingMouse_{false};
     QPoint lastMousePosition_;
 };
@@ -0,0 +1,159 @@
+#include "OcclusionCuller.hpp"
+
+#ifndef GL_ANY_SAMPLES_PASSED
+#define GL_ANY_SAMPLES_PASSED 0x8C2F
+#endif
+
+static constexpr float const BOX_MARGIN = 1.0f / 512.0f;
+static constexpr float const CAMERA_INSIDE_MARGIN = 0.01f;
+static constexpr GLsizei const CUBE_INDICES_NUMBER = 36;
+
+static bool isInBox(OcclusionCuller::Box const& box, QVector3D const& point, float margin)
+{
+    return
+            point.x() >= box.min.x() - margin && point.x() <= box.max.x() + margin &&
+            point.y() >= box.min.y() - margin && point.y() <= box.max.y() + margin &&
+            point.z() >= box.min.z() - margin && point.z() <= box.max.z() + margin;
+}
+
+OcclusionCuller::OcclusionCuller()
+    : cubeVbo_(QOpenGLBuffer::VertexBuffer),
+      cubeEbo_(QOpenGLBuffer::IndexBuffer),
+      viewProjectionMatrixLocation_{-1},
+      boxMinLocation_{-1},
+      boxMaxLocation_{-1},
+      occludedBoxesNumber_{0}
+{}
+
+QString OcclusionCuller::initialize()
+{
+    static QVector3D const CUBE_VERTICES[] = {
+        {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}
+    };
+    static GLubyte const CUBE_INDICES[CUBE_INDICES_NUMBER] = {
+        0, 2, 4, 4, 2, 6,
+        1, 5, 3, 3, 5, 7,
+        0, 4, 1, 1, 4, 5,
+        2, 3, 6, 6, 3, 7,
+        0, 1, 2, 2, 1, 3,
+        4, 6, 5, 5, 6, 7
+    };
+
+    initializeOpenGLFunctions();
+    if (!shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/occlusionBoxVertexShader.vsh")
+            || !shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/occlusionBoxFragmentShader.fsh")
+            || !shaderProgram_.link())
+    { return QString("Could not build occlusion box shaders: %1").arg(shaderProgram_.log()); }
+    shaderProgram_.bind();
+    viewProjectionMatrixLocation_ = shaderProgram_.uniformLocation("viewProjectionMatrix");
+    boxMinLocation_ = shaderProgram_.uniformLocation("boxMin");
+    boxMaxLocation_ = shaderProgram_.uniformLocation("boxMax");
+    cubeVbo_.create();
+    cubeVbo_.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    cubeVbo_.bind();
+    cubeVbo_.allocate(CUBE_VERTICES, sizeof(CUBE_VERTICES));
+    {
+        QOpenGLVertexArrayObject::Binder vaoBinder(&cubeVao_);
+        shaderProgram_.setAttributeBuffer(0, GL_FLOAT, 0, 3, sizeof(QVector3D));
+        shaderProgram_.enableAttributeArray(0);
+        cubeEbo_.create();
+        cubeEbo_.setUsagePattern(QOpenGLBuffer::StaticDraw);
+        cubeEbo_.bind();
+        cubeEbo_.allocate(CUBE_INDICES, sizeof(CUBE_INDICES));
+    }
+    cubeEbo_.release();
+    cubeVbo_.release();
+    shaderProgram_.release();
+    return {};
+}
+
+void OcclusionCuller::destroy()
+{
+    deleteQueries();
+    boxes_.clear();
+    if (cubeVao_.isCreated())
+    { cubeVao_.destroy(); }
+    if (cubeVbo_.isCreated())
+    { cubeVbo_.destroy(); }
+    if (cubeEbo_.isCreated())
+    { cubeEbo_.destroy(); }
+    shaderProgram_.removeAllShaders();
+}
+
+void OcclusionCuller::deleteQueries()
+{
+    for (auto const& boxState : boxesStates_)
+    { glDeleteQueries(1, &boxState.query); }
+    boxesStates_.clear();
+    occludedBoxesNumber_ = 0;
+}
+
+void OcclusionCuller::setBoxes(QVector<Box> const& boxes)
+{
+    deleteQueries();
+    boxes_ = boxes;
+    boxesStates_.resize(boxes_.count());
+    for (auto& boxState : boxesStates_)
+    {
+        glGenQueries(1, &boxState.query);
+        boxState.isQueryPending = false;
+        boxState.isVisible = true;
+    }
+}
+
+void OcclusionCuller::collectResults()
+{
+    occludedBoxesNumber_ = 0;
+    for (auto& boxState : boxesStates_)
+    {
+        if (boxState.isQueryPending)
+        {
+            GLuint isResultAvailable = GL_FALSE;
+            glGetQueryObjectuiv(boxState.query, GL_QUERY_RESULT_AVAILABLE, &isResultAvailable);
+            if (isResultAvailable != GL_FALSE)
+            {
+                GLuint anySamplesPassed = GL_FALSE;
+                glGetQueryObjectuiv(boxState.query, GL_QUERY_RESULT, &anySamplesPassed);
+                boxState.isVisible = anySamplesPassed != GL_FALSE;
+                boxState.isQueryPending = false;
+            }
+        }
+        if (!boxState.isVisible)
+        { ++occludedBoxesNumber_; }
+    }
+}
+
+void OcclusionCuller::issueQueries(QMatrix4x4 const& viewProjectionMatrix, QVector3D const& cameraPosition)
+{
+    if (boxes_.isEmpty())
+    { return; }
+    shaderProgram_.bind();
+    shaderProgram_.setUniformValue(viewProjectionMatrixLocation_, viewProjectionMatrix);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    {
+        QOpenGLVertexArrayObject::Binder vaoBinder(&cubeVao_);
+        for (int boxIndex = 0; boxIndex < boxes_.count(); ++boxIndex)
+        {
+            auto& boxState = boxesStates_[boxIndex];
+            if (boxState.isQueryPending)
+            { continue; }
+            auto const& box = boxes_[boxIndex];
+            if (isInBox(box, cameraPosition, CAMERA_INSIDE_MARGIN))
+            {
+                boxState.isVisible = true;
+                continue;
+            }
+            shaderProgram_.setUniformValue(boxMinLocation_, box.min - QVector3D(BOX_MARGIN, BOX_MARGIN, BOX_MARGIN));
+            shaderProgram_.setUniformValue(boxMaxLocation_, box.max + QVector3D(BOX_MARGIN, BOX_MARGIN, BOX_MARGIN));
+            glBeginQuery(GL_ANY_SAMPLES_PASSED, boxState.query);
+            glDrawElements(GL_TRIANGLES, CUBE_INDICES_NUMBER, GL_UNSIGNED_BYTE, nullptr);
+            glEndQuery(GL_ANY_SAMPLES_PASSED);
+            boxState.isQueryPending = true;
+        }
+    }
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    shaderProgram_.release();
+}
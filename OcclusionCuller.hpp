@@ -0,0 +1,57 @@
+#ifndef OCCLUSIONCULLER_HPP
+#define OCCLUSIONCULLER_HPP
+
+#include <QMatrix4x4>
+#include <QOpenGLBuffer>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+
+class OcclusionCuller : protected QOpenGLExtraFunctions
+{
+public:
+    struct Box
+    {
+        QVector3D min;
+        QVector3D max;
+    };
+
+    OcclusionCuller();
+
+    // Returns an error if the shaders cannot be built.
+    QString initialize();
+    void destroy();
+    void setBoxes(QVector<Box> const& boxes);
+    void collectResults();
+    void issueQueries(QMatrix4x4 const& viewProjectionMatrix, QVector3D const& cameraPosition);
+    bool isVisible(int boxIndex) const
+    { return boxesStates_[boxIndex].isVisible; }
+    uint32_t occludedBoxesNumber() const
+    { return occludedBoxesNumber_; }
+
+private:
+    struct BoxState
+    {
+        GLuint query;
+        bool isQueryPending;
+        bool isVisible;
+    };
+
+    void deleteQueries();
+
+    QOpenGLShaderProgram shaderProgram_;
+    QOpenGLBuffer cubeVbo_;
+    QOpenGLBuffer cubeEbo_;
+    QOpenGLVertexArrayObject cubeVao_;
+    int viewProjectionMatrixLocation_;
+    int boxMinLocation_;
+    int boxMaxLocation_;
+    QVector<Box> boxes_;
+    QVector<BoxState> boxesStates_;
+    uint32_t occludedBoxesNumber_;
+};
+
+#endif // OCCLUSIONCULLER_HPP
@@ -0,0 +1,159 @@
+#include "OffscreenSceneRenderer.hpp"
+#include <QThread>
+
+OffscreenSceneRenderer::OffscreenSceneRenderer()
+    : context_(std::make_unique<QOpenGLContext>()),
+      projectionMatrixLocation_{-1},
+      viewMatrixLocation_{-1}
+{
+    auto format = QSurfaceFormat::defaultFormat();
+    surface_.setFormat(format);
+    surface_.create();
+    context_->setFormat(format);
+    if (!context_->create())
+    { throw QString("Could not create OpenGL context."); }
+}
+
+OffscreenSceneRenderer::~OffscreenSceneRenderer()
+{
+    if (context_->thread() == QThread::currentThread())
+    { release(); }
+    context_.reset();
+    surface_.destroy();
+}
+
+void OffscreenSceneRenderer::moveToThread(QThread* thread)
+{ context_->moveToThread(thread); }
+
+void OffscreenSceneRenderer::makeCurrent()
+{
+    if (!context_->makeCurrent(&surface_))
+    { throw QString("Could not make OpenGL context current."); }
+}
+
+void OffscreenSceneRenderer::initialize()
+{
+    makeCurrent();
+    initializeOpenGLFunctions();
+    if (!shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/vertexShader.vsh")
+            || !shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/fragmentShader.fsh")
+            || !shaderProgram_.link())
+    { throw QString("Could not build scene shaders: %1").arg(shaderProgram_.log()); }
+    shaderProgram_.bind();
+    projectionMatrixLocation_ = shaderProgram_.uniformLocation("projectionMatrix");
+    viewMatrixLocation_ = shaderProgram_.uniformLocation("viewMatrix");
+    shaderProgram_.setUniformValue("vramSampler", 0);
+    shaderProgram_.release();
+    glClearColor(0.0f, 0.0f, 0.2f, 1.0f);
+    glEnable(GL_DEPTH_TEST);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void OffscreenSceneRenderer::release()
+{
+    if (!context_->makeCurrent(&surface_))
+    { return; }
+    scene_.reset();
+    semiTransparentOrder_.invalidate();
+    vertexArrays_.destroy();
+    residencyManager_.clear();
+    renderTarget_.reset();
+    shaderProgram_.removeAllShaders();
+    context_->doneCurrent();
+}
+
+void OffscreenSceneRenderer::loadScene(QString const& sceneKey, SceneMesh mesh, QByteArray const& vram)
+{
+    makeCurrent();
+    scene_.reset();
+    semiTransparentOrder_.invalidate();
+    scene_ = residencyManager_.insert(sceneKey, std::make_shared<SceneGLResources>(std::move(mesh), vram));
+}
+
+bool OffscreenSceneRenderer::activateScene(QString const& sceneKey)
+{
+    if (!residencyManager_.contains(sceneKey))
+    { return false; }
+    makeCurrent();
+    scene_.reset();
+    semiTransparentOrder_.invalidate();
+    scene_ = residencyManager_.acquire(sceneKey);
+    return true;
+}
+
+void OffscreenSceneRenderer::setSceneMemoryBudget(size_t sceneMemoryBudget)
+{
+    makeCurrent();
+    residencyManager_.setGpuMemoryBudget(sceneMemoryBudget);
+}
+
+QImage OffscreenSceneRenderer::render(SceneCamera const& camera, QSize const& size)
+{
+    makeCurrent();
+    if (renderTarget_ == nullptr || renderTarget_->size() != size)
+    {
+        renderTarget_ = std::make_unique<QOpenGLFramebufferObject>(
+                    size,
+                    QOpenGLFramebufferObject::CombinedDepthStencil);
+    }
+    renderTarget_->bind();
+    glViewport(0, 0, size.width(), size.height());
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    if (scene_ != nullptr)
+    {
+        vertexArrays_.update(*scene_, shaderProgram_);
+        scene_->vramTexture().bind(0);
+        shaderProgram_.bind();
+        shaderProgram_.setUniformValue(
+                    projectionMatrixLocation_,
+                    camera.projectionMatrix(static_cast<float>(size.width()) / size.height()));
+        shaderProgram_.setUniformValue(viewMatrixLocation_, camera.viewMatrix());
+        {
+            QOpenGLVertexArrayObject::Binder vaoBinder(&vertexArrays_.opaquePolygons());
+            glDrawElements(GL_TRIANGLES, scene_->opaquePolygonsIndicesNumber(), GL_UNSIGNED_INT, nullptr);
+        }
+        glEnable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+        {
+            QOpenGLVertexArrayObject::Binder vaoBinder(&vertexArrays_.semiTransparentPolygons());
+            drawSemiTransparentPolygons(camera);
+        }
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+        shaderProgram_.release();
+        scene_->vramTexture().release(0);
+    }
+    QImage image(size, QImage::Format_RGBA8888);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+    renderTarget_->release();
+    return image.mirrored();
+}
+
+void OffscreenSceneRenderer::drawSemiTransparentPolygons(SceneCamera const& camera)
+{
+    semiTransparentOrder_.update(scene_->voxelsGrid(), camera.position.x(), camera.position.z());
+    uint32_t rangeFirstIndex = 0;
+    uint32_t rangeIndicesNumber = 0;
+    auto drawRange = [this, &rangeFirstIndex, &rangeIndicesNumber]() {
+        if (rangeIndicesNumber == 0)
+        { return; }
+        glDrawElements(
+                    GL_TRIANGLES,
+                    rangeIndicesNumber,
+                    GL_UNSIGNED_INT,
+                    reinterpret_cast<void const*>(rangeFirstIndex * sizeof(GLuint)));
+    };
+    for (auto const& range : semiTransparentOrder_.ranges())
+    {
+        if (rangeFirstIndex + rangeIndicesNumber == range.firstIndex)
+        {
+            rangeIndicesNumber += range.indicesNumber;
+            continue;
+        }
+        drawRange();
+        rangeFirstIndex = range.firstIndex;
+        rangeIndicesNumber = range.indicesNumber;
+    }
+    drawRange();
+}
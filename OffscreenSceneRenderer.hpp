@@ -0,0 +1,55 @@
+#ifndef OFFSCREENSCENERENDERER_HPP
+#define OFFSCREENSCENERENDERER_HPP
+
+#include "SceneCamera.hpp"
+#include "SceneGLVertexArrays.hpp"
+#include "SceneResidencyManager.hpp"
+#include "SceneSemiTransparentOrder.hpp"
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+#include <memory>
+
+// Renders scenes without a window into an FBO of an own OpenGL context. The object has to be constructed
+// and destroyed in the GUI thread (the offscreen surface requires it); after moveToThread() everything
+// else, including initialize() and release(), has to be called from the target thread.
+class OffscreenSceneRenderer : protected QOpenGLExtraFunctions
+{
+public:
+    OffscreenSceneRenderer();
+    ~OffscreenSceneRenderer();
+
+    void moveToThread(QThread* thread);
+    void initialize();
+    void release();
+    QStringList sceneKeys() const
+    { return residencyManager_.keys(); }
+    bool hasScene(QString const& sceneKey) const
+    { return residencyManager_.contains(sceneKey); }
+    bool isSceneResident(QString const& sceneKey) const
+    { return residencyManager_.isResident(sceneKey); }
+    void loadScene(QString const& sceneKey, SceneMesh mesh, QByteArray const& vram);
+    bool activateScene(QString const& sceneKey);
+    void setSceneMemoryBudget(size_t sceneMemoryBudget);
+    QImage render(SceneCamera const& camera, QSize const& size);
+
+private:
+    void makeCurrent();
+    void drawSemiTransparentPolygons(SceneCamera const& camera);
+
+    QOffscreenSurface surface_;
+    std::unique_ptr<QOpenGLContext> context_;
+    QOpenGLShaderProgram shaderProgram_;
+    int projectionMatrixLocation_;
+    int viewMatrixLocation_;
+    std::unique_ptr<QOpenGLFramebufferObject> renderTarget_;
+    SceneResidencyManager residencyManager_;
+    std::shared_ptr<SceneGLResources> scene_;
+    SceneGLVertexArrays vertexArrays_;
+    SceneSemiTransparentOrder semiTransparentOrder_;
+};
+
+#endif // OFFSCREENSCENERENDERER_HPP
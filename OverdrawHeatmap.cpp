@@ -0,0 +1,199 @@
+#include "OverdrawHeatmap.hpp"
+#include <QLinearGradient>
+
+#ifndef GL_RGBA16F
+#define GL_RGBA16F 0x881A
+#endif
+
+static constexpr uint32_t const STATISTICS_INTERVAL_FRAMES = 10;
+static constexpr int const COUNTS_PER_PIXEL = 3;
+static constexpr float const DEFAULT_MAX_OVERDRAW = 8.0f;
+
+OverdrawHeatmap::OverdrawHeatmap()
+    : maxOverdrawLocation_{-1},
+      readbackBuffer_(QOpenGLBuffer::PixelPackBuffer),
+      readbackFence_{nullptr},
+      framesSinceReadback_{0},
+      maxOverdraw_{DEFAULT_MAX_OVERDRAW},
+      statistics_{}
+{}
+
+QString OverdrawHeatmap::initialize()
+{
+    initializeOpenGLFunctions();
+    if (!shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/overdrawHeatmapVertexShader.vsh")
+            || !shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/overdrawHeatmapFragmentShader.fsh")
+            || !shaderProgram_.link())
+    { return QString("Could not build overdraw heatmap shaders: %1").arg(shaderProgram_.log()); }
+    shaderProgram_.bind();
+    shaderProgram_.setUniformValue("countsSampler", 0);
+    maxOverdrawLocation_ = shaderProgram_.uniformLocation("maxOverdraw");
+    shaderProgram_.release();
+    screenVao_.create();
+    return {};
+}
+
+void OverdrawHeatmap::destroy()
+{
+    if (readbackFence_ != nullptr)
+    {
+        glDeleteSync(readbackFence_);
+        readbackFence_ = nullptr;
+    }
+    if (readbackBuffer_.isCreated())
+    { readbackBuffer_.destroy(); }
+    if (screenVao_.isCreated())
+    { screenVao_.destroy(); }
+    countsTarget_.reset();
+    shaderProgram_.removeAllShaders();
+}
+
+void OverdrawHeatmap::begin(QSize const& size)
+{
+    if (countsTarget_ == nullptr || countsTarget_->size() != size)
+    {
+        countsTarget_ = std::make_unique<QOpenGLFramebufferObject>(
+                    size,
+                    QOpenGLFramebufferObject::Depth,
+                    GL_TEXTURE_2D,
+                    GL_RGBA16F);
+    }
+    countsTarget_->bind();
+    glViewport(0, 0, size.width(), size.height());
+}
+
+void OverdrawHeatmap::present(GLuint framebuffer, QSize const& size)
+{
+    collectStatistics();
+    if (readbackFence_ == nullptr && ++framesSinceReadback_ >= STATISTICS_INTERVAL_FRAMES)
+    { readStatistics(); }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, size.width(), size.height());
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, countsTarget_->texture());
+    shaderProgram_.bind();
+    shaderProgram_.setUniformValue(maxOverdrawLocation_, maxOverdraw_);
+    {
+        QOpenGLVertexArrayObject::Binder vaoBinder(&screenVao_);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    shaderProgram_.release();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void OverdrawHeatmap::readStatistics()
+{
+    auto size = countsTarget_->size();
+    int bufferSize = size.width() * size.height() * COUNTS_PER_PIXEL * sizeof(GLfloat);
+    if (!readbackBuffer_.isCreated())
+    {
+        readbackBuffer_.create();
+        readbackBuffer_.setUsagePattern(QOpenGLBuffer::StreamRead);
+    }
+    readbackBuffer_.bind();
+    if (readbackBuffer_.size() != bufferSize)
+    { readbackBuffer_.allocate(bufferSize); }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, countsTarget_->handle());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, size.width(), size.height(), GL_RGB, GL_FLOAT, nullptr);
+    readbackBuffer_.release();
+    readbackFence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readbackSize_ = size;
+    framesSinceReadback_ = 0;
+}
+
+void OverdrawHeatmap::collectStatistics()
+{
+    if (readbackFence_ == nullptr)
+    { return; }
+    auto waitResult = glClientWaitSync(readbackFence_, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+    { return; }
+    glDeleteSync(readbackFence_);
+    readbackFence_ = nullptr;
+    readbackBuffer_.bind();
+    auto const* counts = static_cast<GLfloat const*>(
+                readbackBuffer_.mapRange(0, readbackBuffer_.size(), QOpenGLBuffer::RangeRead));
+    if (counts != nullptr)
+    {
+        Statistics statistics{};
+        double fragmentsNumber = 0.0;
+        double discardedFragmentsNumber = 0.0;
+        auto pixelsNumber = readbackSize_.width() * readbackSize_.height();
+        for (int pixelIndex = 0; pixelIndex < pixelsNumber; ++pixelIndex, counts += COUNTS_PER_PIXEL)
+        {
+            auto pixelFragmentsNumber = static_cast<uint32_t>(counts[0] + counts[1] + 0.5f);
+            ++statistics.histogram[qMin<uint32_t>(pixelFragmentsNumber, HISTOGRAM_BUCKETS_NUMBER - 1)];
+            fragmentsNumber += pixelFragmentsNumber;
+            discardedFragmentsNumber += counts[2];
+        }
+        statistics.coveredPixelsNumber = pixelsNumber - statistics.histogram[0];
+        statistics.meanOverdraw = statistics.coveredPixelsNumber == 0 ?
+                    0.0f :
+                    fragmentsNumber / statistics.coveredPixelsNumber;
+        statistics.discardedFragmentsRatio = fragmentsNumber == 0.0 ?
+                    0.0f :
+                    discardedFragmentsNumber / fragmentsNumber;
+        statistics_ = statistics;
+        readbackBuffer_.unmap();
+    }
+    readbackBuffer_.release();
+}
+
+void OverdrawHeatmap::drawStatistics(QPainter& painter, QRect const& area) const
+{
+    static constexpr int MARGIN = 8;
+    static constexpr int BAR_WIDTH = 12;
+    static constexpr int HISTOGRAM_HEIGHT = 80;
+    static constexpr int LEGEND_HEIGHT = 10;
+
+    QRect panel(
+                area.left() + MARGIN,
+                area.bottom() - MARGIN - HISTOGRAM_HEIGHT - LEGEND_HEIGHT - 3 * MARGIN - 16,
+                HISTOGRAM_BUCKETS_NUMBER * BAR_WIDTH + 2 * MARGIN,
+                HISTOGRAM_HEIGHT + LEGEND_HEIGHT + 3 * MARGIN + 16);
+    painter.fillRect(panel, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    painter.drawText(
+                panel.left() + MARGIN,
+                panel.top() + MARGIN + 10,
+                QString("Mean overdraw: %1, discarded: %2%")
+                .arg(statistics_.meanOverdraw, 0, 'f', 2)
+                .arg(statistics_.discardedFragmentsRatio * 100.0f, 0, 'f', 1));
+    uint32_t maxBucket = 1;
+    for (int bucketIndex = 1; bucketIndex < HISTOGRAM_BUCKETS_NUMBER; ++bucketIndex)
+    { maxBucket = qMax(maxBucket, statistics_.histogram[bucketIndex]); }
+    auto histogramBottom = panel.top() + 2 * MARGIN + 16 + HISTOGRAM_HEIGHT;
+    for (int bucketIndex = 1; bucketIndex < HISTOGRAM_BUCKETS_NUMBER; ++bucketIndex)
+    {
+        auto barHeight = static_cast<int>(
+                    static_cast<float>(statistics_.histogram[bucketIndex]) / maxBucket * HISTOGRAM_HEIGHT);
+        painter.fillRect(
+                    panel.left() + MARGIN + bucketIndex * BAR_WIDTH,
+                    histogramBottom - barHeight,
+                    BAR_WIDTH - 2,
+                    barHeight,
+                    Qt::lightGray);
+    }
+    QRect legend(
+                panel.left() + MARGIN + BAR_WIDTH,
+                histogramBottom + MARGIN,
+                qBound(1, static_cast<int>(maxOverdraw_), HISTOGRAM_BUCKETS_NUMBER - 1) * BAR_WIDTH,
+                LEGEND_HEIGHT);
+    QLinearGradient gradient(legend.topLeft(), legend.topRight());
+    gradient.setColorAt(0.0, Qt::blue);
+    gradient.setColorAt(0.25, Qt::cyan);
+    gradient.setColorAt(0.5, Qt::green);
+    gradient.setColorAt(0.75, Qt::yellow);
+    gradient.setColorAt(1.0, Qt::red);
+    painter.fillRect(legend, gradient);
+    painter.fillRect(
+                legend.right() + 1,
+                legend.top(),
+                panel.right() - MARGIN - legend.right(),
+                LEGEND_HEIGHT,
+                Qt::white);
+}
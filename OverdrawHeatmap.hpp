@@ -0,0 +1,62 @@
+#ifndef OVERDRAWHEATMAP_HPP
+#define OVERDRAWHEATMAP_HPP
+
+#include <QOpenGLBuffer>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QPainter>
+#include <QSize>
+#include <QString>
+#include <array>
+#include <memory>
+
+// Accumulates per-pixel fragment counts of the scene passes and shows them as a color-mapped heatmap.
+// Channels of the accumulation target: opaque fragments, semi-transparent fragments, fragments discarded
+// because of a transparent texel.
+class OverdrawHeatmap : protected QOpenGLExtraFunctions
+{
+public:
+    static constexpr int const HISTOGRAM_BUCKETS_NUMBER = 17;
+
+    struct Statistics
+    {
+        std::array<uint32_t, HISTOGRAM_BUCKETS_NUMBER> histogram;
+        uint32_t coveredPixelsNumber;
+        float meanOverdraw;
+        float discardedFragmentsRatio;
+    };
+
+    OverdrawHeatmap();
+
+    // Returns an error if the shaders cannot be built.
+    QString initialize();
+    void destroy();
+    void begin(QSize const& size);
+    void present(GLuint framebuffer, QSize const& size);
+    float maxOverdraw() const
+    { return maxOverdraw_; }
+    void setMaxOverdraw(float maxOverdraw)
+    { maxOverdraw_ = maxOverdraw; }
+    Statistics const& statistics() const
+    { return statistics_; }
+    void drawStatistics(QPainter& painter, QRect const& area) const;
+
+private:
+    void collectStatistics();
+    void readStatistics();
+
+    QOpenGLShaderProgram shaderProgram_;
+    QOpenGLVertexArrayObject screenVao_;
+    int maxOverdrawLocation_;
+    std::unique_ptr<QOpenGLFramebufferObject> countsTarget_;
+    QOpenGLBuffer readbackBuffer_;
+    GLsync readbackFence_;
+    QSize readbackSize_;
+    uint32_t framesSinceReadback_;
+    float maxOverdraw_;
+    Statistics statistics_;
+};
+
+#endif // OVERDRAWHEATMAP_HPP
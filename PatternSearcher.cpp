@@ -0,0 +1,76 @@
+#include "PatternSearcher.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define PATTERN_SEARCHER_SSE2
+#include <emmintrin.h>
+#endif
+
+PatternSearcher::PatternSearcher(QByteArray const& pattern)
+    : pattern_(pattern)
+{
+    qint64 patternSize = pattern_.size();
+    shifts_.fill(patternSize);
+    for (qint64 index = 0; index + 1 < patternSize; ++index)
+    { shifts_[static_cast<uint8_t>(pattern_[static_cast<int>(index)])] = patternSize - 1 - index; }
+}
+
+qint64 PatternSearcher::find(char const* data, qint64 size, qint64 from) const
+{
+    if (pattern_.isEmpty() || size - from < pattern_.size())
+    { return -1; }
+#ifdef PATTERN_SEARCHER_SSE2
+    if (pattern_.size() > 1)
+    { return findVectorized(data, size, from); }
+#endif
+    return findHorspool(data, size, from);
+}
+
+qint64 PatternSearcher::findVectorized(char const* data, qint64 size, qint64 from) const
+{
+#ifdef PATTERN_SEARCHER_SSE2
+    static constexpr qint64 const BLOCK_SIZE = sizeof(__m128i);
+    qint64 patternSize = pattern_.size();
+    auto const* pattern = pattern_.constData();
+    auto firstBytes = _mm_set1_epi8(pattern[0]);
+    auto lastBytes = _mm_set1_epi8(pattern[patternSize - 1]);
+    qint64 lastBlockStart = size - patternSize - BLOCK_SIZE + 1;
+    qint64 position = from;
+    for (; position <= lastBlockStart; position += BLOCK_SIZE)
+    {
+        auto firstBlock = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + position));
+        auto lastBlock = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + position + patternSize - 1));
+        auto matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+                    _mm_cmpeq_epi8(firstBlock, firstBytes),
+                    _mm_cmpeq_epi8(lastBlock, lastBytes))));
+        while (matches != 0)
+        {
+            int bitIndex = 0;
+            while ((matches & (1u << bitIndex)) == 0)
+            { ++bitIndex; }
+            auto candidate = position + bitIndex;
+            if (std::memcmp(data + candidate + 1, pattern + 1, patternSize - 2) == 0)
+            { return candidate; }
+            matches &= matches - 1;
+        }
+    }
+    return findHorspool(data, size, position);
+#else
+    return findHorspool(data, size, from);
+#endif
+}
+
+qint64 PatternSearcher::findHorspool(char const* data, qint64 size, qint64 from) const
+{
+    qint64 patternSize = pattern_.size();
+    auto const* pattern = pattern_.constData();
+    auto lastPatternByte = pattern[patternSize - 1];
+    for (qint64 position = from; position + patternSize <= size; )
+    {
+        auto lastByte = data[position + patternSize - 1];
+        if (lastByte == lastPatternByte && std::memcmp(data + position, pattern, patternSize - 1) == 0)
+        { return position; }
+        position += shifts_[static_cast<uint8_t>(lastByte)];
+    }
+    return -1;
+}
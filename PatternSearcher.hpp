@@ -0,0 +1,24 @@
+#ifndef PATTERNSEARCHER_HPP
+#define PATTERNSEARCHER_HPP
+
+#include <QByteArray>
+#include <array>
+
+class PatternSearcher
+{
+public:
+    explicit PatternSearcher(QByteArray const& pattern);
+
+    QByteArray const& pattern() const
+    { return pattern_; }
+    qint64 find(char const* data, qint64 size, qint64 from = 0) const;
+
+private:
+    qint64 findVectorized(char const* data, qint64 size, qint64 from) const;
+    qint64 findHorspool(char const* data, qint64 size, qint64 from) const;
+
+    QByteArray pattern_;
+    std::array<qint64, 256> shifts_;
+};
+
+#endif // PATTERNSEARCHER_HPP
@@ -0,0 +1,185 @@
+#include "PsxVRamConst.hpp"
+#include "SavestateImporter.hpp"
+#include <QFile>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <zlib.h>
+
+static constexpr int const STREAM_BUFFER_SIZE = 0x40000;
+static constexpr int const SKIP_BUFFER_SIZE = 0x10000;
+
+namespace
+{
+
+// Reads a gzip compressed file, or an uncompressed one as is, the way gzread does. The file is read through
+// QFile, which handles non-ASCII paths on every platform, and inflated in memory.
+class GzipStream
+{
+public:
+    explicit GzipStream(QFile& file)
+        : filePath_(file.fileName()),
+          file_(file),
+          input_(STREAM_BUFFER_SIZE, Qt::Uninitialized),
+          isCompressed_{false},
+          position_{0}
+    {
+        stream_ = z_stream();
+        auto magic = file_.peek(2);
+        isCompressed_ = magic.size() == 2
+                && static_cast<uint8_t>(magic[0]) == 0x1f && static_cast<uint8_t>(magic[1]) == 0x8b;
+        // 16 added to the window bits selects the gzip wrapper.
+        if (isCompressed_ && inflateInit2(&stream_, MAX_WBITS + 16) != Z_OK)
+        { throw QString("Could not decompress savestate %1.").arg(filePath_); }
+    }
+    ~GzipStream()
+    {
+        if (isCompressed_)
+        { inflateEnd(&stream_); }
+    }
+
+    quint64 position() const
+    { return position_; }
+    void read(char* buffer, quint64 size)
+    {
+        if (isCompressed_)
+        { readInflated(buffer, size); }
+        else if (file_.read(buffer, size) != static_cast<qint64>(size))
+        { throw unexpectedEnd(); }
+        position_ += size;
+    }
+    void skipTo(quint64 offset)
+    {
+        char skipBuffer[SKIP_BUFFER_SIZE];
+        while (position_ < offset)
+        { read(skipBuffer, std::min<quint64>(offset - position_, SKIP_BUFFER_SIZE)); }
+    }
+
+private:
+    void readInflated(char* buffer, quint64 size)
+    {
+        while (size > 0)
+        {
+            auto chunkSize = static_cast<uInt>(std::min<quint64>(size, UINT_MAX));
+            stream_.next_out = reinterpret_cast<Bytef*>(buffer);
+            stream_.avail_out = chunkSize;
+            while (stream_.avail_out > 0)
+            {
+                if (stream_.avail_in == 0 && !fillInput())
+                { throw unexpectedEnd(); }
+                auto result = inflate(&stream_, Z_NO_FLUSH);
+                if (result == Z_STREAM_END)
+                {
+                    // Concatenated gzip members continue the same stream.
+                    bool hasNextMember = stream_.avail_in > 0 || fillInput();
+                    if (!hasNextMember && stream_.avail_out > 0)
+                    { throw unexpectedEnd(); }
+                    if (hasNextMember && inflateReset(&stream_) != Z_OK)
+                    { throw corrupted(); }
+                }
+                else if (result != Z_OK && result != Z_BUF_ERROR)
+                { throw corrupted(); }
+            }
+            buffer += chunkSize;
+            size -= chunkSize;
+        }
+    }
+    bool fillInput()
+    {
+        auto readSize = file_.read(input_.data(), input_.size());
+        if (readSize <= 0)
+        { return false; }
+        stream_.next_in = reinterpret_cast<Bytef*>(input_.data());
+        stream_.avail_in = static_cast<uInt>(readSize);
+        return true;
+    }
+    QString unexpectedEnd() const
+    { return QString("Unexpected end of savestate %1 at offset %2.").arg(filePath_).arg(position_); }
+    QString corrupted() const
+    { return QString("Corrupted savestate %1 at offset %2.").arg(filePath_).arg(position_); }
+
+    QString filePath_;
+    QFile& file_;
+    QByteArray input_;
+    z_stream stream_;
+    bool isCompressed_;
+    quint64 position_;
+};
+
+}
+
+SavestateImporter::SavestateImporter()
+{
+    addSectionLocator(std::make_unique<PcsxReloadedSectionLocator>());
+    addSectionLocator(std::make_unique<RawDumpSectionLocator>());
+}
+
+void SavestateImporter::addSectionLocator(std::unique_ptr<SavestateSectionLocator> sectionLocator)
+{ sectionLocators_.push_back(std::move(sectionLocator)); }
+
+SavestateSectionLocator const* SavestateImporter::findSectionLocator(
+        QByteArray const& header,
+        SavestateSectionLocator::Sections& sections) const
+{
+    for (auto const& sectionLocator : sectionLocators_)
+    {
+        if (sectionLocator->locate(header.left(sectionLocator->headerSize()), sections))
+        { return sectionLocator.get(); }
+    }
+    return nullptr;
+}
+
+QString SavestateImporter::import(QString const& filePath, BufferedPsxRam& psxRam, QByteArray& psxVRam) const
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly))
+    { throw QString("Could not open file %1.").arg(filePath); }
+    return import(file, psxRam, psxVRam);
+}
+
+QString SavestateImporter::import(QFile& file, BufferedPsxRam& psxRam, QByteArray& psxVRam) const
+{
+    auto filePath = file.fileName();
+    int headerSize = 0;
+    for (auto const& sectionLocator : sectionLocators_)
+    { headerSize = std::max(headerSize, sectionLocator->headerSize()); }
+    GzipStream stream(file);
+    QByteArray header(headerSize, Qt::Uninitialized);
+    stream.read(header.data(), header.size());
+    SavestateSectionLocator::Sections sections;
+    auto const* sectionLocator = findSectionLocator(header, sections);
+    if (sectionLocator == nullptr)
+    { throw QString("Unknown savestate format of file %1.").arg(filePath); }
+    QByteArray psxRamContent(PsxRamConst::SIZE, Qt::Uninitialized);
+    QByteArray psxVRamContent(PsxVRamConst::SIZE, Qt::Uninitialized);
+    struct Section
+    {
+        quint64 offset;
+        QByteArray* content;
+    };
+    Section sectionsInStreamOrder[] = {
+        {sections.psxRamOffset, &psxRamContent},
+        {sections.psxVRamOffset, &psxVRamContent}
+    };
+    std::sort(
+                std::begin(sectionsInStreamOrder),
+                std::end(sectionsInStreamOrder),
+                [](Section const& one, Section const& other) { return one.offset < other.offset; });
+    for (auto const& section : sectionsInStreamOrder)
+    {
+        auto* content = section.content->data();
+        quint64 contentSize = section.content->size();
+        if (section.offset < stream.position())
+        {
+            quint64 alreadyReadSize = std::min(stream.position() - section.offset, contentSize);
+            std::copy_n(header.constData() + section.offset, alreadyReadSize, content);
+            content += alreadyReadSize;
+            contentSize -= alreadyReadSize;
+        }
+        stream.skipTo(section.offset + (content - section.content->data()));
+        stream.read(content, contentSize);
+    }
+    psxRam.fill(psxRamContent.constData());
+    psxVRam = psxVRamContent;
+    return sectionLocator->formatName();
+}
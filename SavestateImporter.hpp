@@ -0,0 +1,28 @@
+#ifndef SAVESTATEIMPORTER_HPP
+#define SAVESTATEIMPORTER_HPP
+
+#include "BufferedPsxRam.hpp"
+#include "SavestateSectionLocator.hpp"
+#include <QFile>
+#include <memory>
+#include <vector>
+
+class SavestateImporter
+{
+public:
+    SavestateImporter();
+
+    void addSectionLocator(std::unique_ptr<SavestateSectionLocator> sectionLocator);
+    QString import(QString const& filePath, BufferedPsxRam& psxRam, QByteArray& psxVRam) const;
+    // Reads from the current position of an open file, so callers can tell its read errors from bad contents.
+    QString import(QFile& file, BufferedPsxRam& psxRam, QByteArray& psxVRam) const;
+
+private:
+    SavestateSectionLocator const* findSectionLocator(
+            QByteArray const& header,
+            SavestateSectionLocator::Sections& sections) const;
+
+    std::vector<std::unique_ptr<SavestateSectionLocator>> sectionLocators_;
+};
+
+#endif // SAVESTATEIMPORTER_HPP
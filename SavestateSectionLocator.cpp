@@ -0,0 +1,51 @@
+#include "PsxRamConst.hpp"
+#include "SavestateSectionLocator.hpp"
+
+namespace PcsxReloaded
+{
+
+static QByteArray const HEADER_MAGIC("STv4 PCSX");
+static constexpr quint64 const HEADER_SIZE = 32;
+static constexpr quint64 const VERSION_SIZE = 4;
+static constexpr quint64 const HLE_FLAG_SIZE = 1;
+static constexpr quint64 const THUMBNAIL_SIZE = 128 * 96 * 3;
+static constexpr quint64 const BIOS_SIZE = 0x80000;
+static constexpr quint64 const SCRATCHPAD_AND_HARDWARE_SIZE = 0x10000;
+static constexpr quint64 const CPU_REGISTERS_SIZE = 8988;
+static constexpr quint64 const GPU_FREEZE_HEADER_SIZE = 4 + 4 + 256 * 4;
+static constexpr quint64 const PSX_RAM_OFFSET = HEADER_SIZE + VERSION_SIZE + HLE_FLAG_SIZE + THUMBNAIL_SIZE;
+static constexpr quint64 const PSX_VRAM_OFFSET =
+        PSX_RAM_OFFSET + PsxRamConst::SIZE + BIOS_SIZE + SCRATCHPAD_AND_HARDWARE_SIZE +
+        CPU_REGISTERS_SIZE + GPU_FREEZE_HEADER_SIZE;
+
+}
+
+QString PcsxReloadedSectionLocator::formatName() const
+{ return "PCSX-Reloaded"; }
+
+int PcsxReloadedSectionLocator::headerSize() const
+{ return PcsxReloaded::HEADER_SIZE; }
+
+bool PcsxReloadedSectionLocator::locate(QByteArray const& header, Sections& sections) const
+{
+    if (!header.startsWith(PcsxReloaded::HEADER_MAGIC))
+    { return false; }
+    sections.psxRamOffset = PcsxReloaded::PSX_RAM_OFFSET;
+    sections.psxVRamOffset = PcsxReloaded::PSX_VRAM_OFFSET;
+    return true;
+}
+
+QString RawDumpSectionLocator::formatName() const
+{ return "Compressed AD 3D model"; }
+
+int RawDumpSectionLocator::headerSize() const
+{ return PsxRamConst::PSX_RAM_PATTERN.size(); }
+
+bool RawDumpSectionLocator::locate(QByteArray const& header, Sections& sections) const
+{
+    if (!header.startsWith(PsxRamConst::PSX_RAM_PATTERN))
+    { return false; }
+    sections.psxRamOffset = 0;
+    sections.psxVRamOffset = PsxRamConst::SIZE;
+    return true;
+}
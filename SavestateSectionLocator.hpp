@@ -0,0 +1,39 @@
+#ifndef SAVESTATESECTIONLOCATOR_HPP
+#define SAVESTATESECTIONLOCATOR_HPP
+
+#include <QByteArray>
+#include <QString>
+
+class SavestateSectionLocator
+{
+public:
+    struct Sections
+    {
+        quint64 psxRamOffset;
+        quint64 psxVRamOffset;
+    };
+
+    virtual ~SavestateSectionLocator() = default;
+
+    virtual QString formatName() const = 0;
+    virtual int headerSize() const = 0;
+    virtual bool locate(QByteArray const& header, Sections& sections) const = 0;
+};
+
+class PcsxReloadedSectionLocator : public SavestateSectionLocator
+{
+public:
+    QString formatName() const override;
+    int headerSize() const override;
+    bool locate(QByteArray const& header, Sections& sections) const override;
+};
+
+class RawDumpSectionLocator : public SavestateSectionLocator
+{
+public:
+    QString formatName() const override;
+    int headerSize() const override;
+    bool locate(QByteArray const& header, Sections& sections) const override;
+};
+
+#endif // SAVESTATESECTIONLOCATOR_HPP
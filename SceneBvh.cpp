@@ -0,0 +1,323 @@
+#include "SceneBvh.hpp"
+#include <QVarLengthArray>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+
+static constexpr uint32_t const MAX_LEAF_QUADS = 4;
+static constexpr uint8_t const BINS_NUMBER = 16;
+static constexpr uint8_t const PARALLEL_BUILD_DEPTH = 4;
+static constexpr float const EPSILON = 1e-7f;
+static constexpr float const DETERMINANT_EPSILON = 1e-12f;
+
+static QVector3D componentsMin(QVector3D const& one, QVector3D const& other)
+{
+    return QVector3D(
+                qMin(one.x(), other.x()),
+                qMin(one.y(), other.y()),
+                qMin(one.z(), other.z()));
+}
+
+static QVector3D componentsMax(QVector3D const& one, QVector3D const& other)
+{
+    return QVector3D(
+                qMax(one.x(), other.x()),
+                qMax(one.y(), other.y()),
+                qMax(one.z(), other.z()));
+}
+
+SceneBvh::Bounds SceneBvh::Bounds::empty()
+{ return {QVector3D(FLT_MAX, FLT_MAX, FLT_MAX), QVector3D(-FLT_MAX, -FLT_MAX, -FLT_MAX)}; }
+
+void SceneBvh::Bounds::extend(QVector3D const& point)
+{
+    min = componentsMin(min, point);
+    max = componentsMax(max, point);
+}
+
+void SceneBvh::Bounds::extend(Bounds const& other)
+{
+    min = componentsMin(min, other.min);
+    max = componentsMax(max, other.max);
+}
+
+float SceneBvh::Bounds::surfaceArea() const
+{
+    auto extent = componentsMax(max - min, QVector3D());
+    return 2.0f * (extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x());
+}
+
+void SceneBvh::clear()
+{
+    quads_.clear();
+    quadsBounds_.clear();
+    quadsCenters_.clear();
+    quadsIndices_.clear();
+    nodes_.clear();
+}
+
+void SceneBvh::build(QVector<Quad> const& quads)
+{
+    clear();
+    if (quads.isEmpty())
+    { return; }
+    quads_ = quads;
+    quadsBounds_.resize(quads_.size());
+    quadsCenters_.resize(quads_.size());
+    quadsIndices_.resize(quads_.size());
+    std::iota(quadsIndices_.begin(), quadsIndices_.end(), 0u);
+    auto const* quadIt = quads_.constData();
+    auto* boundsIt = quadsBounds_.data();
+    auto* centerIt = quadsCenters_.data();
+    QtConcurrent::blockingMap(quadsIndices_, [quadIt, boundsIt, centerIt](uint32_t& quadIndex) {
+        auto bounds = Bounds::empty();
+        for (auto const& vertex : quadIt[quadIndex].vertices)
+        { bounds.extend(vertex); }
+        boundsIt[quadIndex] = bounds;
+        centerIt[quadIndex] = bounds.center();
+    });
+    nodes_.reserve(2 * (quads_.size() / MAX_LEAF_QUADS + 1));
+    nodes_.append(Node{});
+    QVector<BuildTask> parallelTasks;
+    buildNode(nodes_, 0, 0, quads_.size(), 0, &parallelTasks);
+    QtConcurrent::blockingMap(parallelTasks, [this](BuildTask& task) { buildSubtree(task); });
+    for (auto const& task : parallelTasks)
+    { attachSubtree(task); }
+}
+
+SceneBvh::Bounds SceneBvh::rangeBounds(uint32_t first, uint32_t count) const
+{
+    auto bounds = Bounds::empty();
+    for (auto index = first; index < first + count; ++index)
+    { bounds.extend(quadsBounds_[quadsIndices_[index]]); }
+    return bounds;
+}
+
+void SceneBvh::buildNode(
+        QVector<Node>& nodes,
+        uint32_t nodeIndex,
+        uint32_t first,
+        uint32_t count,
+        uint8_t depth,
+        QVector<BuildTask>* parallelTasks)
+{
+    auto bounds = rangeBounds(first, count);
+    nodes[nodeIndex].bounds = bounds;
+    uint32_t splitIndex;
+    if (count <= MAX_LEAF_QUADS || !findSplit(first, count, splitIndex))
+    {
+        nodes[nodeIndex].first = first;
+        nodes[nodeIndex].count = count;
+        return;
+    }
+    uint32_t leftChildIndex = nodes.size();
+    nodes.append(Node{});
+    nodes.append(Node{});
+    nodes[nodeIndex].first = leftChildIndex;
+    nodes[nodeIndex].count = 0;
+    uint32_t leftCount = splitIndex - first;
+    uint32_t rightCount = count - leftCount;
+    if (parallelTasks != nullptr && depth + 1 == PARALLEL_BUILD_DEPTH)
+    {
+        parallelTasks->append({leftChildIndex, first, leftCount, {}});
+        parallelTasks->append({leftChildIndex + 1, splitIndex, rightCount, {}});
+        return;
+    }
+    buildNode(nodes, leftChildIndex, first, leftCount, depth + 1, parallelTasks);
+    buildNode(nodes, leftChildIndex + 1, splitIndex, rightCount, depth + 1, parallelTasks);
+}
+
+bool SceneBvh::findSplit(uint32_t first, uint32_t count, uint32_t& splitIndex)
+{
+    auto centersBounds = Bounds::empty();
+    for (auto index = first; index < first + count; ++index)
+    { centersBounds.extend(quadsCenters_[quadsIndices_[index]]); }
+    auto extent = centersBounds.max - centersBounds.min;
+    int axis = 0;
+    if (extent.y() > extent[axis])
+    { axis = 1; }
+    if (extent.z() > extent[axis])
+    { axis = 2; }
+    if (extent[axis] < EPSILON)
+    {
+        splitIndex = first + count / 2;
+        return true;
+    }
+    float binScale = BINS_NUMBER / extent[axis];
+    float axisMin = centersBounds.min[axis];
+    auto binOf = [this, axis, axisMin, binScale](uint32_t quadIndex) {
+        int bin = static_cast<int>((quadsCenters_[quadIndex][axis] - axisMin) * binScale);
+        return qBound(0, bin, BINS_NUMBER - 1);
+    };
+    std::array<Bounds, BINS_NUMBER> binsBounds;
+    std::array<uint32_t, BINS_NUMBER> binsCounts{};
+    binsBounds.fill(Bounds::empty());
+    for (auto index = first; index < first + count; ++index)
+    {
+        auto quadIndex = quadsIndices_[index];
+        auto bin = binOf(quadIndex);
+        binsBounds[bin].extend(quadsBounds_[quadIndex]);
+        ++binsCounts[bin];
+    }
+    std::array<float, BINS_NUMBER - 1> leftCosts;
+    auto leftBounds = Bounds::empty();
+    uint32_t leftCount = 0;
+    for (int bin = 0; bin < BINS_NUMBER - 1; ++bin)
+    {
+        leftBounds.extend(binsBounds[bin]);
+        leftCount += binsCounts[bin];
+        leftCosts[bin] = leftCount > 0 ? leftBounds.surfaceArea() * leftCount : 0.0f;
+    }
+    auto rightBounds = Bounds::empty();
+    uint32_t rightCount = 0;
+    float bestCost = FLT_MAX;
+    int bestBin = -1;
+    for (int bin = BINS_NUMBER - 1; bin > 0; --bin)
+    {
+        rightBounds.extend(binsBounds[bin]);
+        rightCount += binsCounts[bin];
+        if (rightCount == 0 || rightCount == count)
+        { continue; }
+        float cost = leftCosts[bin - 1] + rightBounds.surfaceArea() * rightCount;
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestBin = bin - 1;
+        }
+    }
+    if (bestBin < 0)
+    {
+        splitIndex = first + count / 2;
+        return true;
+    }
+    auto* firstIndexIt = quadsIndices_.data() + first;
+    auto* splitIt = std::partition(firstIndexIt, firstIndexIt + count, [&binOf, bestBin](uint32_t quadIndex) {
+        return binOf(quadIndex) <= bestBin;
+    });
+    splitIndex = first + static_cast<uint32_t>(splitIt - firstIndexIt);
+    return true;
+}
+
+void SceneBvh::buildSubtree(BuildTask& task)
+{
+    task.nodes.append(Node{});
+    buildNode(task.nodes, 0, task.first, task.count, 0, nullptr);
+}
+
+void SceneBvh::attachSubtree(BuildTask const& task)
+{
+    uint32_t offset = nodes_.size() - 1;
+    auto relocated = [offset](Node node) {
+        if (!node.isLeaf())
+        { node.first += offset; }
+        return node;
+    };
+    nodes_[task.nodeIndex] = relocated(task.nodes.first());
+    for (auto nodeIt = task.nodes.cbegin() + 1; nodeIt != task.nodes.cend(); ++nodeIt)
+    { nodes_.append(relocated(*nodeIt)); }
+}
+
+bool SceneBvh::intersect(QVector3D const& origin, QVector3D const& direction, Hit& hit, float maxDistance) const
+{
+    if (isEmpty())
+    { return false; }
+    QVector3D inverseDirection(1.0f / direction.x(), 1.0f / direction.y(), 1.0f / direction.z());
+    float closestDistance = maxDistance;
+    bool isHit = false;
+    QVarLengthArray<uint32_t, 64> nodesStack;
+    nodesStack.append(0);
+    while (!nodesStack.isEmpty())
+    {
+        auto const& node = nodes_[nodesStack.last()];
+        nodesStack.removeLast();
+        if (!intersectBounds(node.bounds, origin, inverseDirection, closestDistance))
+        { continue; }
+        if (!node.isLeaf())
+        {
+            nodesStack.append(node.first + 1);
+            nodesStack.append(node.first);
+            continue;
+        }
+        for (auto index = node.first; index < node.first + node.count; ++index)
+        {
+            auto quadIndex = quadsIndices_[index];
+            float distance;
+            if (intersectQuad(quads_[quadIndex], origin, direction, distance) && distance < closestDistance)
+            {
+                closestDistance = distance;
+                hit.quadIndex = quadIndex;
+                hit.distance = distance;
+                isHit = true;
+            }
+        }
+    }
+    return isHit;
+}
+
+bool SceneBvh::intersectBounds(
+        Bounds const& bounds,
+        QVector3D const& origin,
+        QVector3D const& inverseDirection,
+        float maxDistance) const
+{
+    float nearDistance = 0.0f;
+    float farDistance = maxDistance;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float distance1 = (bounds.min[axis] - origin[axis]) * inverseDirection[axis];
+        float distance2 = (bounds.max[axis] - origin[axis]) * inverseDirection[axis];
+        if (distance1 > distance2)
+        { std::swap(distance1, distance2); }
+        nearDistance = qMax(nearDistance, distance1);
+        farDistance = qMin(farDistance, distance2);
+        if (nearDistance > farDistance)
+        { return false; }
+    }
+    return true;
+}
+
+bool SceneBvh::intersectQuad(
+        Quad const& quad,
+        QVector3D const& origin,
+        QVector3D const& direction,
+        float& distance) const
+{
+    // Both triangles are tested, a ray can cross both of a non-planar quad.
+    auto const& vertices = quad.vertices;
+    float firstDistance;
+    float secondDistance;
+    bool isFirstHit = intersectTriangle(vertices[0], vertices[1], vertices[2], origin, direction, firstDistance);
+    bool isSecondHit = intersectTriangle(vertices[2], vertices[1], vertices[3], origin, direction, secondDistance);
+    if (!isFirstHit && !isSecondHit)
+    { return false; }
+    distance = !isSecondHit || (isFirstHit && firstDistance < secondDistance) ? firstDistance : secondDistance;
+    return true;
+}
+
+bool SceneBvh::intersectTriangle(
+        QVector3D const& vertex1,
+        QVector3D const& vertex2,
+        QVector3D const& vertex3,
+        QVector3D const& origin,
+        QVector3D const& direction,
+        float& distance)
+{
+    auto edge1 = vertex2 - vertex1;
+    auto edge2 = vertex3 - vertex1;
+    auto p = QVector3D::crossProduct(direction, edge2);
+    float determinant = QVector3D::dotProduct(edge1, p);
+    if (qAbs(determinant) < DETERMINANT_EPSILON)
+    { return false; }
+    float inverseDeterminant = 1.0f / determinant;
+    auto t = origin - vertex1;
+    float u = QVector3D::dotProduct(t, p) * inverseDeterminant;
+    if (u < 0.0f || u > 1.0f)
+    { return false; }
+    auto q = QVector3D::crossProduct(t, edge1);
+    float v = QVector3D::dotProduct(direction, q) * inverseDeterminant;
+    if (v < 0.0f || u + v > 1.0f)
+    { return false; }
+    distance = QVector3D::dotProduct(edge2, q) * inverseDeterminant;
+    return distance > 0.0f;
+}
@@ -0,0 +1,102 @@
+#ifndef SCENEBVH_HPP
+#define SCENEBVH_HPP
+
+#include <QVector>
+#include <QVector3D>
+#include <array>
+#include <cfloat>
+
+class SceneBvh
+{
+public:
+    struct Quad
+    {
+        std::array<QVector3D, 4> vertices;
+    };
+
+    struct Hit
+    {
+        uint32_t quadIndex;
+        float distance;
+    };
+
+    void clear();
+    void build(QVector<Quad> const& quads);
+    bool isEmpty() const
+    { return nodes_.isEmpty(); }
+    // Closest quad hit closer than maxDistance.
+    bool intersect(
+            QVector3D const& origin,
+            QVector3D const& direction,
+            Hit& hit,
+            float maxDistance = FLT_MAX) const;
+
+private:
+    struct Bounds
+    {
+        QVector3D min;
+        QVector3D max;
+
+        static Bounds empty();
+        void extend(QVector3D const& point);
+        void extend(Bounds const& other);
+        float surfaceArea() const;
+        QVector3D center() const
+        { return (min + max) * 0.5f; }
+    };
+
+    struct Node
+    {
+        Bounds bounds;
+        uint32_t first;
+        uint32_t count;
+
+        bool isLeaf() const
+        { return count != 0; }
+    };
+
+    struct BuildTask
+    {
+        uint32_t nodeIndex;
+        uint32_t first;
+        uint32_t count;
+        QVector<Node> nodes;
+    };
+
+    Bounds rangeBounds(uint32_t first, uint32_t count) const;
+    void buildNode(
+            QVector<Node>& nodes,
+            uint32_t nodeIndex,
+            uint32_t first,
+            uint32_t count,
+            uint8_t depth,
+            QVector<BuildTask>* parallelTasks);
+    bool findSplit(uint32_t first, uint32_t count, uint32_t& splitIndex);
+    void buildSubtree(BuildTask& task);
+    void attachSubtree(BuildTask const& task);
+    bool intersectBounds(
+            Bounds const& bounds,
+            QVector3D const& origin,
+            QVector3D const& inverseDirection,
+            float maxDistance) const;
+    bool intersectQuad(
+            Quad const& quad,
+            QVector3D const& origin,
+            QVector3D const& direction,
+            float& distance) const;
+    static bool intersectTriangle(
+            QVector3D const& vertex1,
+            QVector3D const& vertex2,
+            QVector3D const& vertex3,
+            QVector3D const& origin,
+            QVector3D const& direction,
+            float& distance);
+
+    QVector<Quad> quads_;
+    QVector<Bounds> quadsBounds_;
+    QVector<QVector3D> quadsCenters_;
+    QVector<uint32_t> quadsIndices_;
+    QVector<Node> nodes_;
+};
+
+#endif // SCENEBVH_HPP
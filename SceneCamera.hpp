@@ -0,0 +1,65 @@
+#ifndef SCENECAMERA_HPP
+#define SCENECAMERA_HPP
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMatrix4x4>
+#include <QString>
+#include <QVector3D>
+#include <QtMath>
+#include <cmath>
+
+// Camera of an offscreen scene view. Uses the same conventions and defaults as SceneGLRenderer, but angles
+// are in degrees.
+struct SceneCamera
+{
+    QVector3D position{0.0f, 0.5f, -1.5f};
+    float yaw{90.0f};
+    float pitch{-20.0f};
+    float fieldOfView{45.0f};
+
+    QVector3D front() const
+    {
+        auto yawRad = qDegreesToRadians(yaw);
+        auto pitchRad = qDegreesToRadians(pitch);
+        return QVector3D(
+                    std::cos(yawRad) * std::cos(pitchRad),
+                    std::sin(pitchRad),
+                    std::sin(yawRad) * std::cos(pitchRad)).normalized();
+    }
+
+    QMatrix4x4 viewMatrix() const
+    {
+        QMatrix4x4 matrix;
+        matrix.lookAt(position, position + front(), QVector3D(0.0f, 1.0f, 0.0f));
+        return matrix;
+    }
+
+    QMatrix4x4 projectionMatrix(float aspectRatio) const
+    {
+        QMatrix4x4 matrix;
+        matrix.perspective(fieldOfView, aspectRatio, 0.001f, 100.0f);
+        return matrix;
+    }
+
+    // Reads the position, yaw, pitch and fov fields of a JSON object; missing fields keep the defaults.
+    static SceneCamera fromJson(QJsonObject const& cameraObject)
+    {
+        SceneCamera camera;
+        if (cameraObject.contains("position"))
+        {
+            auto position = cameraObject.value("position").toArray();
+            if (position.size() != 3)
+            { throw QString("Camera position has to have 3 coordinates."); }
+            camera.position = QVector3D(position[0].toDouble(), position[1].toDouble(), position[2].toDouble());
+        }
+        camera.yaw = cameraObject.value("yaw").toDouble(camera.yaw);
+        camera.pitch = cameraObject.value("pitch").toDouble(camera.pitch);
+        camera.fieldOfView = cameraObject.value("fov").toDouble(camera.fieldOfView);
+        if (camera.fieldOfView <= 0.0f || camera.fieldOfView >= 180.0f)
+        { throw QString("Field of view %1 is out of range.").arg(camera.fieldOfView); }
+        return camera;
+    }
+};
+
+#endif // SCENECAMERA_HPP
@@ -1,7 +1,10 @@
-#include "PsxVRamConst.hpp"
 #include "SceneGLRenderer.hpp"
-#include <QOpenGLPixelTransferOptions>
+#include "SceneMeshBuilder.hpp"
+#include <QFile>
+#include <QPainter>
+#include <QtConcurrent>
 #include <cmath>
+#include <cstring>
 
 static constexpr float RAD = M_PI / 180.0f;
 
@@ -11,204 +14,177 @@ static constexpr float toRad(float angle)
 SceneGLRenderer::SceneGLRenderer(QWidget* parent)
     : QOpenGLWidget(parent),
       aspectRatio_{1.0f},
-      vbo_(QOpenGLBuffer::VertexBuffer),
-      opaquePolygonsEbo_(QOpenGLBuffer::IndexBuffer),
-      semiTransparentPolygonsEbo_(QOpenGLBuffer::IndexBuffer),
-      opaquePolygonsIndicesNumber_{0},
-      semiTransparentPolygonsIndicesNumber_{0},
+      residencyManager_(std::make_shared<SceneResidencyManager>()),
+      vramUnpackBuffer_(QOpenGLBuffer::PixelUnpackBuffer),
       cameraPosition_(0.0f, 0.5f, -1.5f),
       cameraFront_(0.0f, 0.0f, -1.0f),
       cameraUp_(0.0f, 1.0f, 0.0f),
       cameraYaw_{toRad(90.0f)},
       cameraPitch_{toRad(-20.0f)},
       drawOpaques_{true},
-      drawSemiTransparent_{true}
+      drawSemiTransparent_{true},
+      occlusionCulling_{true},
+      lod_{true},
+      lodVoxelsChunksNumber_{0},
+      pvsCulling_{true},
+      pvsCellIndex_{-1},
+      pvsCulledVoxelsChunksNumber_{0},
+      minimapEnabled_{true},
+      overdrawHeatmapEnabled_{false},
+      frameTimeMs_{0.0f},
+      sceneLoadTimeMs_{0.0f},
+      dynamicResolutionEnabled_{false}
 { resetCamera(); }
 
 SceneGLRenderer::~SceneGLRenderer()
 {
     makeCurrent();
     clear();
+    if (vramUnpackBuffer_.isCreated())
+    { vramUnpackBuffer_.destroy(); }
+    occlusionCuller_.destroy();
+    minimap_.destroy();
+    overdrawHeatmap_.destroy();
+    frameTimer_.destroy();
+    frameCapturer_.destroy();
+    renderTarget_.reset();
     doneCurrent();
 }
 
 void SceneGLRenderer::clear()
 {
-    if (vbo_.isCreated())
-    { vbo_.destroy(); }
-    if (opaquePolygonsEbo_.isCreated())
-    { opaquePolygonsEbo_.destroy(); }
-    if (opaquePolygonsVao_.isCreated())
-    { opaquePolygonsVao_.destroy(); }
-    if (semiTransparentPolygonsVao_.isCreated())
-    { semiTransparentPolygonsVao_.destroy(); }
-    if (vramTexture_ != nullptr)
-    {
-        if (vramTexture_->isCreated())
-        { vramTexture_->destroy(); }
-        vramTexture_.reset();
-    }
+    scene_.reset();
+    sceneKey_.clear();
+    vertexArrays_.destroy();
+    semiTransparentOrder_.invalidate();
+    minimap_.invalidate();
+    if (residencyManager_.use_count() == 1)
+    { residencyManager_->clear(); }
 }
 
-AD::Point3D operator+(AD::Point3D const& one, AD::Point3D const& other)
+void SceneGLRenderer::shareScenes(SceneGLRenderer const& renderer)
 {
-    AD::Point3D result;
-    result.x = one.x + other.x;
-    result.y = one.y + other.y;
-    result.z = one.z + other.z;
-    return result;
+    makeCurrent();
+    clear();
+    doneCurrent();
+    residencyManager_ = renderer.residencyManager_;
+    if (renderer.isSceneLoaded())
+    { activateScene(renderer.sceneKey()); }
 }
 
-QVector3D toVector3D(AD::Point3D const& adVertex)
+void SceneGLRenderer::copyView(SceneGLRenderer const& renderer)
 {
-    static constexpr int FRACTIONAL_SIZE = 12;
-    static constexpr float DENOMINATOR = 1 << FRACTIONAL_SIZE;
-    return QVector3D(-adVertex.x / DENOMINATOR, -adVertex.z / DENOMINATOR, -adVertex.y / DENOMINATOR);
+    fieldOfView_ = renderer.fieldOfView_;
+    cameraPosition_ = renderer.cameraPosition_;
+    cameraYaw_ = renderer.cameraYaw_;
+    cameraPitch_ = renderer.cameraPitch_;
+    drawOpaques_ = renderer.drawOpaques_;
+    drawSemiTransparent_ = renderer.drawSemiTransparent_;
+    lod_ = renderer.lod_;
+    pvsCulling_ = renderer.pvsCulling_;
+    minimapEnabled_ = renderer.minimapEnabled_;
+    calculateProjectionMatrix();
+    calculateCameraFront();
+    updateViewMatrix();
+    update();
 }
 
-void SceneGLRenderer::loadScene(ADScene const& adScene)
+void SceneGLRenderer::loadScene(ADScene const& adScene, QString const& sceneKey)
 {
-    auto addPolygonIndices = [](QVector<GLuint>& indices, GLuint firstVertexIndex) {
-        indices.append(firstVertexIndex + 0);
-        indices.append(firstVertexIndex + 1);
-        indices.append(firstVertexIndex + 2);
-        indices.append(firstVertexIndex + 2);
-        indices.append(firstVertexIndex + 1);
-        indices.append(firstVertexIndex + 3);
-    };
+    sceneLoadTimer_.start();
+    makeCurrent();
+    // The VRAM is copied into a mapped unpack buffer while the geometry is built, so the texture upload
+    // only queues a transfer from it.
+    QFuture<void> vramCopy;
+    auto isVramStaged = stageVram(adScene.rawVRam(), vramCopy);
+    // Every loaded scene owns its mesh, so the buffers are allocated here once per load.
+    SceneMesh mesh;
+    SceneMeshBuilder::build(adScene, mesh);
+    auto scene = std::make_shared<SceneGLResources>(std::move(mesh), adScene.rawVRam());
+    insertScene(sceneKey, std::move(scene), isVramStaged, vramCopy);
+}
 
-    clear();
-    QVector<Vertex> vertices;
-    QVector<GLuint> opaquePolygonsIndices;
-    QVector<GLuint> semiTransparentPolygonsIndices;
-    AD::Point3D voxelTranslation;
-    voxelTranslation.y = -0x20 * adScene.height();
-    voxelTranslation.z = 0;
-    GLuint nextVertexIndex = 0;
-    for (auto voxelY = 0u; voxelY < adScene.height(); ++voxelY)
+void SceneGLRenderer::loadScene(SceneMesh mesh, QByteArray const& vram, QString const& sceneKey)
+{
+    sceneLoadTimer_.start();
+    makeCurrent();
+    QFuture<void> vramCopy;
+    auto isVramStaged = stageVram(vram, vramCopy);
+    insertScene(sceneKey, std::make_shared<SceneGLResources>(std::move(mesh), vram), isVramStaged, vramCopy);
+}
+
+void SceneGLRenderer::insertScene(
+        QString const& sceneKey,
+        std::shared_ptr<SceneGLResources> scene,
+        bool isVramStaged,
+        QFuture<void>& vramCopy)
+{
+    if (isVramStaged)
     {
-        auto const* voxelIt = adScene.yAxisVoxels(voxelY);
-        voxelTranslation.x = -0x20 * adScene.width();
-        for (auto voxelX = 0u; voxelX < adScene.width(); ++voxelX, ++voxelIt)
-        {
-            auto const& voxel = *voxelIt;
-            auto const* polygonDescriptorIt = voxel.polygonsDescriptors.begin();
-            while (polygonDescriptorIt != voxel.polygonsDescriptors.end())
-            {
-                auto const& polygonDescriptor = *polygonDescriptorIt;
-                auto const& adVertex1 = adScene.adVertex(polygonDescriptor.vertex1Index);
-                auto const& adVertex2 = adScene.adVertex(polygonDescriptor.vertex2Index);
-                auto const& adVertex3 = adScene.adVertex(polygonDescriptor.vertex3Index);
-                auto const& adVertex4 = adScene.adVertex(polygonDescriptor.vertex4Index);
-                vertices.append(
-                            toVertex(polygonDescriptor, adVertex1 + voxelTranslation, polygonDescriptor.texCoord1));
-                vertices.append(
-                            toVertex(polygonDescriptor, adVertex2 + voxelTranslation, polygonDescriptor.texCoord2()));
-                vertices.append(
-                            toVertex(polygonDescriptor, adVertex3 + voxelTranslation, polygonDescriptor.texCoord3));
-                vertices.append(
-                            toVertex(polygonDescriptor, adVertex4 + voxelTranslation, polygonDescriptor.texCoord4));
-
-                addPolygonIndices(
-                            polygonDescriptor.flags.isSemiTransparent() ?
-                                semiTransparentPolygonsIndices :
-                                opaquePolygonsIndices,
-                            nextVertexIndex);
-                ++polygonDescriptorIt;
-                nextVertexIndex += 4;
-            }
-            voxelTranslation.x += 0x40;
-        }
-        voxelTranslation.y += 0x40;
+        vramCopy.waitForFinished();
+        vramUnpackBuffer_.bind();
+        if (vramUnpackBuffer_.unmap())
+        { scene->setVramUnpackBuffer(&vramUnpackBuffer_); }
+        vramUnpackBuffer_.release();
     }
-    prepareBuffers(vertices, opaquePolygonsIndices, semiTransparentPolygonsIndices);
-    makeCurrent();
-    vramTexture_ = std::make_unique<QOpenGLTexture>(QOpenGLTexture::TargetRectangle);
-    vramTexture_->setFormat(QOpenGLTexture::RG8U);
-    vramTexture_->setSize(PsxVRamConst::PIXELS_PER_LINE, PsxVRamConst::HEIGHT);
-    vramTexture_->setMinificationFilter(QOpenGLTexture::Linear);
-    vramTexture_->setMagnificationFilter(QOpenGLTexture::Linear);
-    vramTexture_->allocateStorage(QOpenGLTexture::RG, QOpenGLTexture::UInt8);
-    QOpenGLPixelTransferOptions transferOptions;
-    transferOptions.setAlignment(1);
-    vramTexture_->setData(
-                0,
-                QOpenGLTexture::RG_Integer,
-                QOpenGLTexture::UInt8,
-                adScene.rawVRam().constData(),
-                &transferOptions);
-    shaderProgram_.bind();
-    shaderProgram_.setUniformValue("vramSampler", 0);
-    shaderProgram_.release();
+    scene_.reset();
+    setScene(sceneKey, residencyManager_->insert(sceneKey, std::move(scene)));
     doneCurrent();
     update();
 }
 
-SceneGLRenderer::Vertex SceneGLRenderer::toVertex(
-        AD::PolygonDescriptor const& polygonDescriptor,
-        AD::Point3D const& adVertex,
-        GpuTexCoord const& texCoord)
+bool SceneGLRenderer::stageVram(QByteArray const& vram, QFuture<void>& vramCopy)
 {
-    SceneGLRenderer::Vertex vertex;
-    vertex.pos = toVector3D(adVertex);
-    auto const& gpuTexpage = polygonDescriptor.texCoord2AndTexPage.fields.texpage;
-    auto const& gpuClut = polygonDescriptor.clut;
-    vertex.texturePos = QVector2D(texCoord.x, texCoord.y);
-    vertex.texpage = QVector3D(gpuTexpage.x, gpuTexpage.y, gpuTexpage.texpageBpp);
-    vertex.clut = QVector2D(gpuClut.x, gpuClut.y);
-    return vertex;
+    if (!vramUnpackBuffer_.isCreated())
+    {
+        vramUnpackBuffer_.create();
+        vramUnpackBuffer_.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    }
+    vramUnpackBuffer_.bind();
+    // Allocating again orphans the storage a previous upload may still be reading.
+    vramUnpackBuffer_.allocate(vram.size());
+    auto* stagingData = vramUnpackBuffer_.mapRange(
+                0,
+                vram.size(),
+                QOpenGLBuffer::RangeWrite | QOpenGLBuffer::RangeInvalidateBuffer);
+    vramUnpackBuffer_.release();
+    if (stagingData == nullptr)
+    { return false; }
+    vramCopy = QtConcurrent::run([stagingData, vram]() { std::memcpy(stagingData, vram.constData(), vram.size()); });
+    return true;
 }
 
-void SceneGLRenderer::prepareBuffers(
-        QVector<Vertex> const& vertices,
-        QVector<GLuint> const& opaquePolygonsIndices,
-        QVector<GLuint> const& semiTransparentPolygonsIndices)
+bool SceneGLRenderer::activateScene(QString const& sceneKey)
 {
+    if (!residencyManager_->contains(sceneKey))
+    { return false; }
     makeCurrent();
-    shaderProgram_.bind();
-    vbo_.create();
-    vbo_.setUsagePattern(QOpenGLBuffer::StaticDraw);
-    vbo_.bind();
-    vbo_.allocate(vertices.constData(), vertices.count() * sizeof(Vertex));
-    {
-        QOpenGLVertexArrayObject::Binder vaoBinder(&opaquePolygonsVao_);
-        shaderProgram_.setAttributeBuffer(0, GL_FLOAT, offsetof(Vertex, pos), 3, sizeof(Vertex));
-        shaderProgram_.setAttributeBuffer(1, GL_FLOAT, offsetof(Vertex, texturePos), 2, sizeof(Vertex));
-        shaderProgram_.setAttributeBuffer(2, GL_FLOAT, offsetof(Vertex, texpage), 3, sizeof(Vertex));
-        shaderProgram_.setAttributeBuffer(3, GL_FLOAT, offsetof(Vertex, clut), 2, sizeof(Vertex));
-        shaderProgram_.enableAttributeArray(0);
-        shaderProgram_.enableAttributeArray(1);
-        shaderProgram_.enableAttributeArray(2);
-        shaderProgram_.enableAttributeArray(3);
-        opaquePolygonsEbo_.create();
-        opaquePolygonsEbo_.setUsagePattern(QOpenGLBuffer::StaticDraw);
-        opaquePolygonsEbo_.bind();
-        opaquePolygonsIndicesNumber_ = opaquePolygonsIndices.count();
-        opaquePolygonsEbo_.allocate(opaquePolygonsIndices.constData(), opaquePolygonsIndicesNumber_ * sizeof(GLuint));
-    }
-    opaquePolygonsEbo_.release();
-    {
-        QOpenGLVertexArrayObject::Binder vaoBinder(&semiTransparentPolygonsVao_);
-        shaderProgram_.setAttributeBuffer(0, GL_FLOAT, offsetof(Vertex, pos), 3, sizeof(Vertex));
-        shaderProgram_.setAttributeBuffer(1, GL_FLOAT, offsetof(Vertex, texturePos), 2, sizeof(Vertex));
-        shaderProgram_.setAttributeBuffer(2, GL_FLOAT, offsetof(Vertex, texpage), 3, sizeof(Vertex));
-        shaderProgram_.setAttributeBuffer(3, GL_FLOAT, offsetof(Vertex, clut), 2, sizeof(Vertex));
-        shaderProgram_.enableAttributeArray(0);
-        shaderProgram_.enableAttributeArray(1);
-        shaderProgram_.enableAttributeArray(2);
-        shaderProgram_.enableAttributeArray(3);
-        semiTransparentPolygonsEbo_.create();
-        semiTransparentPolygonsEbo_.setUsagePattern(QOpenGLBuffer::StaticDraw);
-        semiTransparentPolygonsEbo_.bind();
-        semiTransparentPolygonsIndicesNumber_ = semiTransparentPolygonsIndices.count();
-        semiTransparentPolygonsEbo_.allocate(
-                    semiTransparentPolygonsIndices.constData(),
-                    semiTransparentPolygonsIndicesNumber_ * sizeof(GLuint));
-    }
-    semiTransparentPolygonsEbo_.release();
-    vbo_.release();
-    shaderProgram_.release();
+    scene_.reset();
+    setScene(sceneKey, residencyManager_->acquire(sceneKey));
     doneCurrent();
+    update();
+    return true;
+}
+
+void SceneGLRenderer::setSceneMemoryBudget(size_t sceneMemoryBudget)
+{
+    makeCurrent();
+    residencyManager_->setGpuMemoryBudget(sceneMemoryBudget);
+    doneCurrent();
+}
+
+void SceneGLRenderer::setScene(QString const& sceneKey, std::shared_ptr<SceneGLResources> scene)
+{
+    scene_ = std::move(scene);
+    sceneKey_ = sceneKey;
+    semiTransparentOrder_.invalidate();
+    minimap_.invalidate();
+    QVector<OcclusionCuller::Box> voxelsChunksBoxes;
+    voxelsChunksBoxes.reserve(scene_->voxelsChunks().count());
+    for (auto const& voxelsChunk : scene_->voxelsChunks())
+    { voxelsChunksBoxes.append({toVector3D(voxelsChunk.boundsMin), toVector3D(voxelsChunk.boundsMax)}); }
+    occlusionCuller_.setBoxes(voxelsChunksBoxes);
+    emit sceneChanged(sceneKey_);
 }
 
 void SceneGLRenderer::resetCamera()
@@ -361,19 +337,166 @@ void SceneGLRenderer::setDrawSemiTransparent(bool enabled)
     update();
 }
 
+void SceneGLRenderer::setOcclusionCulling(bool enabled)
+{
+    occlusionCulling_ = enabled;
+    update();
+}
+
+void SceneGLRenderer::setLod(bool enabled)
+{
+    lod_ = enabled;
+    update();
+}
+
+bool SceneGLRenderer::setScenePvs(ScenePvs pvs)
+{
+    if (!isSceneLoaded() || !scene_->setPvs(std::move(pvs)))
+    { return false; }
+    update();
+    return true;
+}
+
+void SceneGLRenderer::setPvsCulling(bool enabled)
+{
+    pvsCulling_ = enabled;
+    update();
+}
+
+void SceneGLRenderer::setMinimap(bool enabled)
+{
+    minimapEnabled_ = enabled;
+    update();
+}
+
+void SceneGLRenderer::setOverdrawHeatmap(bool enabled)
+{
+    overdrawHeatmapEnabled_ = enabled;
+    update();
+}
+
+void SceneGLRenderer::setDynamicResolution(bool enabled)
+{
+    dynamicResolutionEnabled_ = enabled;
+    dynamicResolution_.reset();
+    if (!dynamicResolutionEnabled_)
+    {
+        makeCurrent();
+        renderTarget_.reset();
+        doneCurrent();
+    }
+    update();
+}
+
+void SceneGLRenderer::setFrameTimeBudget(float frameTimeBudgetMs)
+{
+    dynamicResolution_.setFrameTimeBudget(frameTimeBudgetMs);
+    update();
+}
+
+void SceneGLRenderer::setResolutionScaleRange(float minScale, float maxScale)
+{
+    dynamicResolution_.setScaleRange(minScale, maxScale);
+    update();
+}
+
+void SceneGLRenderer::captureScreenshot(QString const& filePath)
+{
+    frameCapturer_.requestScreenshot(filePath);
+    update();
+}
+
+void SceneGLRenderer::startFramesRecording(QString const& directoryPath)
+{
+    frameCapturer_.startRecording(directoryPath);
+    update();
+}
+
+void SceneGLRenderer::stopFramesRecording()
+{
+    frameCapturer_.stopRecording();
+    makeCurrent();
+    frameCapturer_.flush();
+    doneCurrent();
+}
+
+bool SceneGLRenderer::pickPolygon(QPoint const& position, ScenePolygonSource& polygonSource)
+{
+    if (!isSceneLoaded())
+    { return false; }
+    float ndcX = 2.0f * position.x() / width() - 1.0f;
+    float ndcY = 1.0f - 2.0f * position.y() / height();
+    auto inverseViewProjectionMatrix = (projectionMatrix_ * viewMatrix_).inverted();
+    auto nearPoint = inverseViewProjectionMatrix * QVector4D(ndcX, ndcY, -1.0f, 1.0f);
+    auto farPoint = inverseViewProjectionMatrix * QVector4D(ndcX, ndcY, 1.0f, 1.0f);
+    auto origin = nearPoint.toVector3DAffine();
+    auto direction = (farPoint.toVector3DAffine() - origin).normalized();
+    SceneBvh::Hit hit;
+    if (!scene_->sceneBvh().intersect(origin, direction, hit))
+    { return false; }
+    polygonSource = scene_->polygonsSources()[hit.quadIndex];
+    return true;
+}
+
 void SceneGLRenderer::initializeGL()
 {
     initializeOpenGLFunctions();
     glClearColor(0.0f, 0.0f, 0.2f, 1.0f);
     glEnable(GL_DEPTH_TEST);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/vertexShader.vsh");
-    shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/fragmentShader.fsh");
-    shaderProgram_.link();
+    // Compile or link failures are reported instead of thrown: this runs inside Qt's event dispatch.
+    glError_ = initializeShaders();
+    if (!glError_.isEmpty())
+    {
+        qWarning("%s", qUtf8Printable(glError_));
+        emit glInitializationFailed(glError_);
+    }
+    minimap_.initialize();
+    frameTimer_.initialize();
+    frameCapturer_.initialize();
+}
+
+QString SceneGLRenderer::initializeShaders()
+{
+    // Both are initialized even if the other fails, setScene() uses the culler's queries.
+    auto occlusionCullerError = occlusionCuller_.initialize();
+    auto overdrawHeatmapError = overdrawHeatmap_.initialize();
+    if (!occlusionCullerError.isEmpty())
+    { return occlusionCullerError; }
+    if (!overdrawHeatmapError.isEmpty())
+    { return overdrawHeatmapError; }
+    if (!shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/vertexShader.vsh")
+            || !shaderProgram_.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/fragmentShader.fsh")
+            || !shaderProgram_.link())
+    { return QString("Could not build scene shaders: %1").arg(shaderProgram_.log()); }
     shaderProgram_.bind();
     projectionMatrixLocation_ = shaderProgram_.uniformLocation("projectionMatrix");
     viewMatrixLocation_ = shaderProgram_.uniformLocation("viewMatrix");
+    overdrawCountingLocation_ = shaderProgram_.uniformLocation("overdrawCounting");
+    overdrawChannelLocation_ = shaderProgram_.uniformLocation("overdrawChannel");
+    shaderProgram_.setUniformValue("vramSampler", 0);
     shaderProgram_.release();
+    // The same shaders with the discard of transparent texels compiled out, for fully opaque polygons.
+    QFile fragmentShaderFile(":/fragmentShader.fsh");
+    if (!fragmentShaderFile.open(QFile::ReadOnly))
+    { return QString("Could not open file %1.").arg(fragmentShaderFile.fileName()); }
+    auto fragmentShaderSource = fragmentShaderFile.readAll();
+    // The define has to follow the #version line.
+    auto versionLineEnd = fragmentShaderSource.indexOf('\n');
+    if (!fragmentShaderSource.startsWith("#version") || versionLineEnd < 0)
+    { return QString("File %1 does not start with a #version line.").arg(fragmentShaderFile.fileName()); }
+    fragmentShaderSource.insert(versionLineEnd + 1, "#define FULLY_OPAQUE\n");
+    if (!fullyOpaqueShaderProgram_.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/vertexShader.vsh")
+            || !fullyOpaqueShaderProgram_.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource)
+            || !fullyOpaqueShaderProgram_.link())
+    { return QString("Could not build fully opaque scene shaders: %1").arg(fullyOpaqueShaderProgram_.log()); }
+    fullyOpaqueShaderProgram_.bind();
+    fullyOpaqueProjectionMatrixLocation_ = fullyOpaqueShaderProgram_.uniformLocation("projectionMatrix");
+    fullyOpaqueViewMatrixLocation_ = fullyOpaqueShaderProgram_.uniformLocation("viewMatrix");
+    fullyOpaqueShaderProgram_.setUniformValue("overdrawCounting", false);
+    fullyOpaqueShaderProgram_.setUniformValue("vramSampler", 0);
+    fullyOpaqueShaderProgram_.release();
+    return {};
 }
 
 void SceneGLRenderer::resizeGL(int w, int h)
@@ -390,25 +513,336 @@ void SceneGLRenderer::calculateProjectionMatrix()
 
 void SceneGLRenderer::paintGL()
 {
+    if (!glError_.isEmpty())
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        return;
+    }
+    updateFrameTime();
+    bool isMinimapShown = minimapEnabled_ && isSceneLoaded();
+    if (isMinimapShown && !minimap_.isValid())
+    { renderMinimap(); }
+    bool isOverdrawHeatmapShown = overdrawHeatmapEnabled_ && isSceneLoaded();
+    bool isRenderTargetUsed = dynamicResolutionEnabled_ && isSceneLoaded() && !isOverdrawHeatmapShown;
+    if (isOverdrawHeatmapShown)
+    { overdrawHeatmap_.begin(pixelSize()); }
+    else if (isRenderTargetUsed)
+    { bindRenderTarget(); }
+    frameTimer_.begin();
+    renderScene();
+    frameTimer_.end();
+    if (isOverdrawHeatmapShown)
+    {
+        overdrawHeatmap_.present(defaultFramebufferObject(), pixelSize());
+        QPainter painter(this);
+        overdrawHeatmap_.drawStatistics(painter, rect());
+    }
+    else if (isRenderTargetUsed)
+    { presentRenderTarget(); }
+    if (isMinimapShown)
+    { presentMinimap(); }
+    if (sceneLoadTimer_.isValid() && isSceneLoaded())
+    {
+        // Waits for the frame, so the time includes the transfers it depended on.
+        glFinish();
+        sceneLoadTimeMs_ = sceneLoadTimer_.nsecsElapsed() / 1e6f;
+        sceneLoadTimer_.invalidate();
+    }
+    if (frameCapturer_.isRecording() || frameCapturer_.isCapturePending())
+    {
+        frameCapturer_.captureFrame(defaultFramebufferObject(), pixelSize());
+        if (!frameCapturer_.isRecording() && frameCapturer_.isCapturePending())
+        { update(); }
+    }
+    emit frameRendered();
+}
+
+QSize SceneGLRenderer::pixelSize() const
+{ return QSize(qRound(width() * devicePixelRatioF()), qRound(height() * devicePixelRatioF())); }
+
+void SceneGLRenderer::updateFrameTime()
+{
+    float frameTimeMs;
+    if (!frameTimer_.takeFrameTime(frameTimeMs))
+    { return; }
+    frameTimeMs_ = frameTimeMs;
+    if (dynamicResolutionEnabled_)
+    { dynamicResolution_.addFrameTime(frameTimeMs_); }
+}
+
+void SceneGLRenderer::bindRenderTarget()
+{
+    auto scale = dynamicResolution_.scale();
+    QSize renderTargetSize(
+                qMax(1, qRound(width() * devicePixelRatioF() * scale)),
+                qMax(1, qRound(height() * devicePixelRatioF() * scale)));
+    if (renderTarget_ == nullptr || renderTarget_->size() != renderTargetSize)
+    {
+        renderTarget_ = std::make_unique<QOpenGLFramebufferObject>(
+                    renderTargetSize,
+                    QOpenGLFramebufferObject::CombinedDepthStencil);
+    }
+    renderTarget_->bind();
+    glViewport(0, 0, renderTargetSize.width(), renderTargetSize.height());
+}
+
+void SceneGLRenderer::presentRenderTarget()
+{
+    auto widgetSize = pixelSize();
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderTarget_->handle());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, defaultFramebufferObject());
+    glBlitFramebuffer(
+                0, 0, renderTarget_->width(), renderTarget_->height(),
+                0, 0, widgetSize.width(), widgetSize.height(),
+                GL_COLOR_BUFFER_BIT,
+                GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+    glViewport(0, 0, widgetSize.width(), widgetSize.height());
+}
+
+void SceneGLRenderer::renderScene()
+{
+    // The heatmap overlay is drawn with QPainter, which does not restore the state set in initializeGL().
+    if (overdrawHeatmapEnabled_)
+    { glClearColor(0.0f, 0.0f, 0.0f, 0.0f); }
+    else
+    { glClearColor(0.0f, 0.0f, 0.2f, 1.0f); }
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     if (!isSceneLoaded())
     { return; }
-    vramTexture_->bind(0);
+    if (occlusionCulling_)
+    { occlusionCuller_.collectResults(); }
+    pvsCellIndex_ = pvsCulling_ ?
+                scene_->pvs().cellIndex(
+                    scene_->voxelsGrid(), cameraPosition_.x(), cameraPosition_.y(), cameraPosition_.z()) :
+                -1;
+    vertexArrays_.update(*scene_, shaderProgram_);
+    scene_->vramTexture().bind(0);
     shaderProgram_.bind();
     shaderProgram_.setUniformValue(projectionMatrixLocation_, projectionMatrix_);
     shaderProgram_.setUniformValue(viewMatrixLocation_, viewMatrix_);
+    shaderProgram_.setUniformValue(overdrawCountingLocation_, false);
     if (drawOpaques_)
     {
-        QOpenGLVertexArrayObject::Binder vaoBinder(&opaquePolygonsVao_);
-        glDrawElements(GL_TRIANGLES, opaquePolygonsIndicesNumber_, GL_UNSIGNED_INT, nullptr);
+        shaderProgram_.setUniformValue(overdrawChannelLocation_, QVector4D(1.0f, 0.0f, 0.0f, 0.0f));
+        QOpenGLVertexArrayObject::Binder vaoBinder(&vertexArrays_.opaquePolygons());
+        drawOpaquePolygons();
+    }
+    if (occlusionCulling_)
+    {
+        occlusionCuller_.issueQueries(projectionMatrix_ * viewMatrix_, cameraPosition_);
+        shaderProgram_.bind();
     }
     if (drawSemiTransparent_)
+    {
+        shaderProgram_.setUniformValue(overdrawChannelLocation_, QVector4D(0.0f, 1.0f, 0.0f, 0.0f));
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+        QOpenGLVertexArrayObject::Binder vaoBinder(&vertexArrays_.semiTransparentPolygons());
+        drawSemiTransparentPolygons();
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+    scene_->vramTexture().release(0);
+    shaderProgram_.release();
+}
+
+void SceneGLRenderer::renderMinimap()
+{
+    // Full detail polygons without culling, the map is drawn once per scene.
+    minimap_.begin(scene_->voxelsChunks());
+    vertexArrays_.update(*scene_, shaderProgram_);
+    scene_->vramTexture().bind(0);
+    shaderProgram_.bind();
+    shaderProgram_.setUniformValue(projectionMatrixLocation_, minimap_.projectionMatrix());
+    shaderProgram_.setUniformValue(viewMatrixLocation_, minimap_.viewMatrix());
+    shaderProgram_.setUniformValue(overdrawCountingLocation_, false);
+    {
+        QOpenGLVertexArrayObject::Binder vaoBinder(&vertexArrays_.opaquePolygons());
+        glDrawElements(GL_TRIANGLES, scene_->opaquePolygonsIndicesNumber(), GL_UNSIGNED_INT, nullptr);
+    }
+    auto const& semiTransparentFirstIndices = scene_->voxelsGrid().semiTransparentFirstIndices;
+    if (!semiTransparentFirstIndices.isEmpty())
     {
         glEnable(GL_BLEND);
-        QOpenGLVertexArrayObject::Binder vaoBinder(&semiTransparentPolygonsVao_);
-        glDrawElements(GL_TRIANGLES, semiTransparentPolygonsIndicesNumber_, GL_UNSIGNED_INT, nullptr);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+        QOpenGLVertexArrayObject::Binder vaoBinder(&vertexArrays_.semiTransparentPolygons());
+        glDrawElements(GL_TRIANGLES, semiTransparentFirstIndices.last(), GL_UNSIGNED_INT, nullptr);
+        glDepthMask(GL_TRUE);
         glDisable(GL_BLEND);
     }
-    vramTexture_->release(0);
+    scene_->vramTexture().release(0);
     shaderProgram_.release();
+    minimap_.end(defaultFramebufferObject(), pixelSize());
+}
+
+void SceneGLRenderer::presentMinimap()
+{
+    static constexpr int MARGIN = 8;
+    static constexpr int SIZE = 160;
+    QRect area(width() - MARGIN - SIZE, MARGIN, SIZE, SIZE);
+    auto scale = devicePixelRatioF();
+    QRect pixelArea(
+                qRound(area.left() * scale),
+                qRound(area.top() * scale),
+                qRound(area.width() * scale),
+                qRound(area.height() * scale));
+    minimap_.present(pixelArea, pixelSize().height());
+    auto horizontalFieldOfView = 2.0f * std::atan(std::tan(toRad(fieldOfView_) * 0.5f) * aspectRatio_);
+    QPainter painter(this);
+    minimap_.drawCamera(painter, area, cameraPosition_, cameraFront_, horizontalFieldOfView);
+}
+
+void SceneGLRenderer::drawOpaquePolygons()
+{
+    opaqueRanges_.clear();
+    lodVoxelsChunksNumber_ = 0;
+    pvsCulledVoxelsChunksNumber_ = 0;
+    auto const& voxelsChunks = scene_->voxelsChunks();
+    for (int voxelsChunkIndex = 0; voxelsChunkIndex < voxelsChunks.count(); ++voxelsChunkIndex)
+    {
+        auto const& voxelsChunk = voxelsChunks[voxelsChunkIndex];
+        if (voxelsChunk.opaqueIndicesNumber == 0)
+        { continue; }
+        if (!isPotentiallyVisible(voxelsChunkIndex))
+        {
+            ++pvsCulledVoxelsChunksNumber_;
+            continue;
+        }
+        if (occlusionCulling_ && !occlusionCuller_.isVisible(voxelsChunkIndex))
+        { continue; }
+        if (lod_ && voxelsChunk.lodOpaqueIndicesNumber < voxelsChunk.opaqueIndicesNumber
+                && distanceToVoxelsChunk(voxelsChunk) > LOD_DISTANCE)
+        {
+            opaqueRanges_.append({
+                        voxelsChunk.firstLodOpaqueIndex,
+                        voxelsChunk.lodOpaqueIndicesNumber,
+                        voxelsChunk.lodAlphaTestedIndicesNumber});
+            ++lodVoxelsChunksNumber_;
+            continue;
+        }
+        opaqueRanges_.append({
+                    voxelsChunk.firstOpaqueIndex,
+                    voxelsChunk.opaqueIndicesNumber,
+                    voxelsChunk.alphaTestedIndicesNumber});
+    }
+    // The overdraw heatmap counts discarded fragments, so everything goes through the alpha-testing shader.
+    if (overdrawHeatmapEnabled_)
+    {
+        drawOpaqueRanges(true, true);
+        return;
+    }
+    fullyOpaqueShaderProgram_.bind();
+    fullyOpaqueShaderProgram_.setUniformValue(fullyOpaqueProjectionMatrixLocation_, projectionMatrix_);
+    fullyOpaqueShaderProgram_.setUniformValue(fullyOpaqueViewMatrixLocation_, viewMatrix_);
+    drawOpaqueRanges(true, false);
+    shaderProgram_.bind();
+    drawOpaqueRanges(false, true);
+}
+
+void SceneGLRenderer::drawOpaqueRanges(bool drawFullyOpaque, bool drawAlphaTested)
+{
+    uint32_t rangeFirstIndex = 0;
+    uint32_t rangeIndicesNumber = 0;
+    for (auto const& opaqueRange : opaqueRanges_)
+    {
+        auto fullyOpaqueIndicesNumber = opaqueRange.indicesNumber - opaqueRange.alphaTestedIndicesNumber;
+        auto firstIndex = drawFullyOpaque ?
+                    opaqueRange.firstIndex :
+                    opaqueRange.firstIndex + fullyOpaqueIndicesNumber;
+        auto indicesNumber = (drawFullyOpaque ? fullyOpaqueIndicesNumber : 0)
+                + (drawAlphaTested ? opaqueRange.alphaTestedIndicesNumber : 0);
+        if (indicesNumber == 0)
+        { continue; }
+        if (rangeFirstIndex + rangeIndicesNumber == firstIndex)
+        {
+            rangeIndicesNumber += indicesNumber;
+            continue;
+        }
+        drawIndicesRange(rangeFirstIndex, rangeIndicesNumber, false);
+        rangeFirstIndex = firstIndex;
+        rangeIndicesNumber = indicesNumber;
+    }
+    drawIndicesRange(rangeFirstIndex, rangeIndicesNumber, false);
+}
+
+float SceneGLRenderer::distanceToVoxelsChunk(VoxelsChunk const& voxelsChunk) const
+{
+    auto boundsMin = toVector3D(voxelsChunk.boundsMin);
+    auto boundsMax = toVector3D(voxelsChunk.boundsMax);
+    QVector3D offset(
+                qMax(qMax(boundsMin.x() - cameraPosition_.x(), 0.0f), cameraPosition_.x() - boundsMax.x()),
+                qMax(qMax(boundsMin.y() - cameraPosition_.y(), 0.0f), cameraPosition_.y() - boundsMax.y()),
+                qMax(qMax(boundsMin.z() - cameraPosition_.z(), 0.0f), cameraPosition_.z() - boundsMax.z()));
+    return offset.length();
+}
+
+void SceneGLRenderer::drawSemiTransparentPolygons()
+{
+    semiTransparentOrder_.update(scene_->voxelsGrid(), cameraPosition_.x(), cameraPosition_.z());
+    uint32_t rangeFirstIndex = 0;
+    uint32_t rangeIndicesNumber = 0;
+    for (auto const& range : semiTransparentOrder_.ranges())
+    {
+        if (!isPotentiallyVisible(range.voxelsChunkIndex))
+        { continue; }
+        if (occlusionCulling_ && !occlusionCuller_.isVisible(range.voxelsChunkIndex))
+        { continue; }
+        if (rangeFirstIndex + rangeIndicesNumber == range.firstIndex)
+        {
+            rangeIndicesNumber += range.indicesNumber;
+            continue;
+        }
+        drawIndicesRange(rangeFirstIndex, rangeIndicesNumber, true);
+        rangeFirstIndex = range.firstIndex;
+        rangeIndicesNumber = range.indicesNumber;
+    }
+    drawIndicesRange(rangeFirstIndex, rangeIndicesNumber, true);
+}
+
+void SceneGLRenderer::drawIndicesRange(uint32_t firstIndex, uint32_t indicesNumber, bool isSemiTransparent)
+{
+    if (indicesNumber == 0)
+    { return; }
+    if (overdrawHeatmapEnabled_)
+    {
+        drawCountedIndicesRange(firstIndex, indicesNumber, isSemiTransparent);
+        return;
+    }
+    glDrawElements(
+                GL_TRIANGLES,
+                indicesNumber,
+                GL_UNSIGNED_INT,
+                reinterpret_cast<void const*>(firstIndex * sizeof(GLuint)));
+}
+
+void SceneGLRenderer::drawCountedIndicesRange(uint32_t firstIndex, uint32_t indicesNumber, bool isSemiTransparent)
+{
+    // Every fragment passing the depth test so far is counted first, including fragments of transparent texels.
+    // Opaque ranges are then drawn again by the regular shader to write their depth; semi-transparent ones
+    // write none, the same as without the heatmap. The pass kind tells the GL state, which is not queried.
+    auto const* indicesOffset = reinterpret_cast<void const*>(firstIndex * sizeof(GLuint));
+    shaderProgram_.setUniformValue(overdrawCountingLocation_, true);
+    if (!isSemiTransparent)
+    {
+        glEnable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+    }
+    glBlendFunc(GL_ONE, GL_ONE);
+    glDrawElements(GL_TRIANGLES, indicesNumber, GL_UNSIGNED_INT, indicesOffset);
+    shaderProgram_.setUniformValue(overdrawCountingLocation_, false);
+    if (isSemiTransparent)
+    {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        return;
+    }
+    glDisable(GL_BLEND);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDrawElements(GL_TRIANGLES, indicesNumber, GL_UNSIGNED_INT, indicesOffset);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 }
@@ -2,42 +2,66 @@
 #define SCENEGLRENDERER_HPP
 
 #include "ADScene.hpp"
-#include <QOpenGLFunctions>
+#include "DynamicResolutionController.hpp"
+#include "FrameCapturer.hpp"
+#include "GpuFrameTimer.hpp"
+#include "OcclusionCuller.hpp"
+#include "OverdrawHeatmap.hpp"
+#include "SceneGLResources.hpp"
+#include "SceneGLVertexArrays.hpp"
+#include "SceneMinimap.hpp"
+#include "SceneResidencyManager.hpp"
+#include "SceneSemiTransparentOrder.hpp"
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QOpenGLBuffer>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
 #include <QOpenGLWidget>
 #include <QMatrix4x4>
 #include <QOpenGLShaderProgram>
-#include <QOpenGLBuffer>
-#include <QOpenGLTexture>
-#include <QOpenGLVertexArrayObject>
+#include <QVector>
 #include <QVector3D>
+#include <memory>
 
-struct VertexPlain
-{
-    QVector3D pos;
-};
-
-
-struct VertexTextured
-{
-    QVector3D pos;
-    QVector2D texturePos;
-    QVector3D texpage;
-    QVector2D clut;
-};
-
-class SceneGLRenderer : public QOpenGLWidget, protected QOpenGLFunctions
+class SceneGLRenderer : public QOpenGLWidget, protected QOpenGLExtraFunctions
 {
     Q_OBJECT
 
-    using Vertex = VertexTextured;
-
 public:
+    // Chunks farther than this from the camera are drawn with their merged quads.
+    static constexpr float const LOD_DISTANCE = 0.5f;
+
     SceneGLRenderer(QWidget* parent = nullptr);
     ~SceneGLRenderer();
 
     bool isSceneLoaded() const
-    { return vramTexture_ != nullptr; }
-    void loadScene(ADScene const& adScene);
+    { return scene_ != nullptr; }
+    // Set when the shaders could not be built; nothing is rendered then.
+    QString const& glError() const
+    { return glError_; }
+    void loadScene(ADScene const& adScene, QString const& sceneKey);
+    // Only uploads an already built mesh, e.g. one prefetched on a background thread.
+    void loadScene(SceneMesh mesh, QByteArray const& vram, QString const& sceneKey);
+    // Uses the scenes of the given renderer, whose context has to be in the same share group, and shows
+    // its current scene. Only the VAOs are created again; call once this widget is shown.
+    void shareScenes(SceneGLRenderer const& renderer);
+    void copyView(SceneGLRenderer const& renderer);
+    bool activateScene(QString const& sceneKey);
+    QString const& sceneKey() const
+    { return sceneKey_; }
+    QStringList sceneKeys() const
+    { return residencyManager_->keys(); }
+    bool isSceneResident(QString const& sceneKey) const
+    { return residencyManager_->isResident(sceneKey); }
+    size_t sceneMemoryBudget() const
+    { return residencyManager_->gpuMemoryBudget(); }
+    void setSceneMemoryBudget(size_t sceneMemoryBudget);
+    size_t residentScenesMemorySize() const
+    { return residencyManager_->residentGpuMemorySize(); }
+    // Host buffers of the current scene mesh, allocated once when the scene was built.
+    size_t sceneMeshMemorySize() const
+    { return isSceneLoaded() ? scene_->meshMemorySize() : 0; }
     QVector3D const& cameraPosition() const
     { return cameraPosition_; }
     QVector3D const& cameraFront() const
@@ -67,6 +91,70 @@ public:
     void toggleDrawSemiTransparent()
     { setDrawSemiTransparent(!drawSemiTransparent_); }
     void setDrawSemiTransparent(bool enabled);
+    void toggleOcclusionCulling()
+    { setOcclusionCulling(!occlusionCulling_); }
+    void setOcclusionCulling(bool enabled);
+    uint32_t voxelsChunksNumber() const
+    { return isSceneLoaded() ? scene_->voxelsChunks().count() : 0; }
+    uint32_t culledVoxelsChunksNumber() const
+    { return occlusionCulling_ ? occlusionCuller_.occludedBoxesNumber() : 0; }
+    void toggleLod()
+    { setLod(!lod_); }
+    void setLod(bool enabled);
+    uint32_t lodVoxelsChunksNumber() const
+    { return lod_ ? lodVoxelsChunksNumber_ : 0; }
+    // Attaches the precomputed PVS to the current scene; false if it belongs to another scene.
+    bool setScenePvs(ScenePvs pvs);
+    bool hasScenePvs() const
+    { return isSceneLoaded() && !scene_->pvs().isEmpty(); }
+    void togglePvsCulling()
+    { setPvsCulling(!pvsCulling_); }
+    void setPvsCulling(bool enabled);
+    uint32_t pvsCulledVoxelsChunksNumber() const
+    { return pvsCellIndex_ >= 0 ? pvsCulledVoxelsChunksNumber_ : 0; }
+    void toggleMinimap()
+    { setMinimap(!minimapEnabled_); }
+    void setMinimap(bool enabled);
+    void toggleOverdrawHeatmap()
+    { setOverdrawHeatmap(!overdrawHeatmapEnabled_); }
+    void setOverdrawHeatmap(bool enabled);
+    OverdrawHeatmap::Statistics const& overdrawStatistics() const
+    { return overdrawHeatmap_.statistics(); }
+    bool isDynamicResolutionEnabled() const
+    { return dynamicResolutionEnabled_; }
+    void setDynamicResolution(bool enabled);
+    float frameTimeBudget() const
+    { return dynamicResolution_.frameTimeBudget(); }
+    void setFrameTimeBudget(float frameTimeBudgetMs);
+    float minResolutionScale() const
+    { return dynamicResolution_.minScale(); }
+    float maxResolutionScale() const
+    { return dynamicResolution_.maxScale(); }
+    void setResolutionScaleRange(float minScale, float maxScale);
+    float resolutionScale() const
+    { return dynamicResolutionEnabled_ ? dynamicResolution_.scale() : 1.0f; }
+    float frameTime() const
+    { return frameTimeMs_; }
+    // From the start of the last loadScene() to the end of the first frame showing the scene.
+    float sceneLoadTime() const
+    { return sceneLoadTimeMs_; }
+    void captureScreenshot(QString const& filePath);
+    bool isRecordingFrames() const
+    { return frameCapturer_.isRecording(); }
+    uint32_t recordedFramesNumber() const
+    { return frameCapturer_.recordedFramesNumber(); }
+    uint32_t droppedFramesNumber() const
+    { return frameCapturer_.droppedFramesNumber(); }
+    uint32_t failedFrameWritesNumber() const
+    { return frameCapturer_.failedWritesNumber(); }
+    void startFramesRecording(QString const& directoryPath);
+    void stopFramesRecording();
+    bool pickPolygon(QPoint const& position, ScenePolygonSource& polygonSource);
+
+signals:
+    void frameRendered();
+    void sceneChanged(QString const& sceneKey);
+    void glInitializationFailed(QString const& error);
 
 protected:
     void initializeGL() override;
@@ -75,34 +163,65 @@ protected:
 
 private:
     void clear();
-    Vertex toVertex(
-            AD::PolygonDescriptor const& polygonDescriptor,
-            AD::Point3D const& adVertex,
-            GpuTexCoord const& texCoord);
-    void prepareBuffers(
-            QVector<Vertex> const& vertices,
-            QVector<GLuint> const& opaquePolygonsIndices,
-            QVector<GLuint> const& semiTransparentPolygonsIndices);
+    // Returns an error if a shader cannot be built.
+    QString initializeShaders();
+    void setScene(QString const& sceneKey, std::shared_ptr<SceneGLResources> scene);
+    bool stageVram(QByteArray const& vram, QFuture<void>& vramCopy);
+    void insertScene(
+            QString const& sceneKey,
+            std::shared_ptr<SceneGLResources> scene,
+            bool isVramStaged,
+            QFuture<void>& vramCopy);
     QVector3D cameraRight() const;
     void calculateCameraFront();
     void updateViewMatrix();
     void calculateProjectionMatrix();
+    QSize pixelSize() const;
+    void updateFrameTime();
+    void bindRenderTarget();
+    void presentRenderTarget();
+    void renderScene();
+    void renderMinimap();
+    void presentMinimap();
+    // Fully opaque polygons of every visible chunk first, with the shader variant without discard, then the
+    // alpha-tested ones.
+    void drawOpaquePolygons();
+    void drawOpaqueRanges(bool drawFullyOpaque, bool drawAlphaTested);
+    float distanceToVoxelsChunk(VoxelsChunk const& voxelsChunk) const;
+    bool isPotentiallyVisible(int voxelsChunkIndex) const
+    { return pvsCellIndex_ < 0 || scene_->pvs().isVisible(pvsCellIndex_, voxelsChunkIndex); }
+    void drawSemiTransparentPolygons();
+    // Semi-transparent ranges are drawn blended without depth writes, opaque ones the other way round.
+    void drawIndicesRange(uint32_t firstIndex, uint32_t indicesNumber, bool isSemiTransparent);
+    void drawCountedIndicesRange(uint32_t firstIndex, uint32_t indicesNumber, bool isSemiTransparent);
+
+    struct OpaqueRange
+    {
+        uint32_t firstIndex;
+        uint32_t indicesNumber;
+        uint32_t alphaTestedIndicesNumber;
+    };
 
     float aspectRatio_;
     QMatrix4x4 pMatrix_;
     QOpenGLShaderProgram shaderProgram_;
-    QOpenGLVertexArrayObject opaquePolygonsVao_;
-    QOpenGLVertexArrayObject semiTransparentPolygonsVao_;
-    QOpenGLBuffer vbo_;
-    QOpenGLBuffer opaquePolygonsEbo_;
-    QOpenGLBuffer semiTransparentPolygonsEbo_;
-    std::unique_ptr<QOpenGLTexture> vramTexture_;
-    uint32_t opaquePolygonsIndicesNumber_;
-    uint32_t semiTransparentPolygonsIndicesNumber_;
+    QOpenGLShaderProgram fullyOpaqueShaderProgram_;
+    int fullyOpaqueProjectionMatrixLocation_;
+    int fullyOpaqueViewMatrixLocation_;
+    // Opaque indices ranges of the visible chunks, collected every frame.
+    QVector<OpaqueRange> opaqueRanges_;
+    std::shared_ptr<SceneResidencyManager> residencyManager_;
+    std::shared_ptr<SceneGLResources> scene_;
+    QOpenGLBuffer vramUnpackBuffer_;
+    SceneGLVertexArrays vertexArrays_;
+    SceneSemiTransparentOrder semiTransparentOrder_;
+    QString sceneKey_;
     QMatrix4x4 projectionMatrix_;
     int projectionMatrixLocation_;
     QMatrix4x4 viewMatrix_;
     int viewMatrixLocation_;
+    int overdrawCountingLocation_;
+    int overdrawChannelLocation_;
     float fieldOfView_;
     QVector3D cameraPosition_;
     QVector3D cameraFront_;
@@ -111,6 +230,27 @@ private:
     float cameraPitch_;
     bool drawOpaques_;
     bool drawSemiTransparent_;
+    bool occlusionCulling_;
+    OcclusionCuller occlusionCuller_;
+    bool lod_;
+    uint32_t lodVoxelsChunksNumber_;
+    bool pvsCulling_;
+    // Cell of the camera in the scene PVS, -1 when PVS culling does not apply.
+    int pvsCellIndex_;
+    uint32_t pvsCulledVoxelsChunksNumber_;
+    bool minimapEnabled_;
+    SceneMinimap minimap_;
+    bool overdrawHeatmapEnabled_;
+    OverdrawHeatmap overdrawHeatmap_;
+    GpuFrameTimer frameTimer_;
+    float frameTimeMs_;
+    QElapsedTimer sceneLoadTimer_;
+    float sceneLoadTimeMs_;
+    QString glError_;
+    bool dynamicResolutionEnabled_;
+    DynamicResolutionController dynamicResolution_;
+    std::unique_ptr<QOpenGLFramebufferObject> renderTarget_;
+    FrameCapturer frameCapturer_;
 };
 
 #endif // SCENEGLRENDERER_HPP
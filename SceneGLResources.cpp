@@ -0,0 +1,212 @@
+#include "PsxVRamConst.hpp"
+#include "SceneGLResources.hpp"
+#include "SceneVRamLayout.hpp"
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QtConcurrent>
+#include <atomic>
+
+namespace
+{
+std::atomic<uint64_t> lastUploadId{0};
+}
+
+SceneGLResources::SceneGLResources(SceneMesh mesh, QByteArray const& vram)
+    : mesh_(std::move(mesh)),
+      vram_(vram),
+      vbo_(QOpenGLBuffer::VertexBuffer),
+      opaquePolygonsEbo_(QOpenGLBuffer::IndexBuffer),
+      semiTransparentPolygonsEbo_(QOpenGLBuffer::IndexBuffer),
+      vramUnpackBuffer_{nullptr},
+      uploadId_{0}
+{ buildSceneBvh(); }
+
+SceneGLResources::~SceneGLResources()
+{ sceneBvhBuild_.waitForFinished(); }
+
+void SceneGLResources::buildSceneBvh()
+{
+    // Only the full detail quads, which match the polygons sources.
+    QVector<SceneBvh::Quad> quads(mesh_.polygonsSources.count());
+    auto const* vertexIt = mesh_.vertices.constData();
+    for (auto& quad : quads)
+    {
+        for (auto& quadVertex : quad.vertices)
+        { quadVertex = toVector3D((vertexIt++)->pos); }
+    }
+    sceneBvhBuild_ = QtConcurrent::run([this, quads]() { sceneBvh_.build(quads); });
+}
+
+SceneBvh const& SceneGLResources::sceneBvh() const
+{
+    sceneBvhBuild_.waitForFinished();
+    return sceneBvh_;
+}
+
+bool SceneGLResources::setPvs(ScenePvs pvs)
+{
+    if (pvs.chunksNumber() != mesh_.voxelsChunks.count() || pvs.sceneHash() != ScenePvs::sceneHash(mesh_))
+    { return false; }
+    pvs_ = std::move(pvs);
+    return true;
+}
+
+void SceneGLResources::upload()
+{
+    if (isResident())
+    { return; }
+    vbo_.create();
+    vbo_.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    vbo_.bind();
+    vbo_.allocate(mesh_.vertices.constData(), mesh_.vertices.count() * sizeof(Vertex));
+    vbo_.release();
+    uploadIndices(opaquePolygonsEbo_, mesh_.opaquePolygonsIndices);
+    uploadIndices(semiTransparentPolygonsEbo_, mesh_.semiTransparentPolygonsIndices);
+    if (reusedVramTexture_ != nullptr)
+    {
+        vramTexture_ = std::move(reusedVramTexture_);
+        uploadVramRects(changedVramRects_);
+    }
+    else
+    {
+        vramTexture_ = std::make_unique<QOpenGLTexture>(QOpenGLTexture::TargetRectangle);
+        vramTexture_->setFormat(QOpenGLTexture::RG8U);
+        vramTexture_->setSize(qMax<int>(1, mesh_.vramTextureWidth), qMax<int>(1, mesh_.vramTextureHeight));
+        vramTexture_->setMinificationFilter(QOpenGLTexture::Linear);
+        vramTexture_->setMagnificationFilter(QOpenGLTexture::Linear);
+        vramTexture_->allocateStorage(QOpenGLTexture::RG, QOpenGLTexture::UInt8);
+        uploadVramRects(mesh_.vramRects);
+    }
+    changedVramRects_.clear();
+    vramUnpackBuffer_ = nullptr;
+    uploadId_ = ++lastUploadId;
+}
+
+void SceneGLResources::uploadVramRects(QVector<SceneVRamRect> const& vramRects)
+{
+    auto* functions = QOpenGLContext::currentContext()->functions();
+    // Sourced from an unpack buffer, pixels are given as offsets into it and the transfer does not block.
+    if (vramUnpackBuffer_ != nullptr)
+    { vramUnpackBuffer_->bind(); }
+    vramTexture_->bind();
+    functions->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    functions->glPixelStorei(GL_UNPACK_ROW_LENGTH, PsxVRamConst::PIXELS_PER_LINE);
+    for (auto const& vramRect : vramRects)
+    {
+        auto vramOffset = (vramRect.y * PsxVRamConst::PIXELS_PER_LINE + vramRect.x) * PsxVRamConst::PIXEL_SIZE;
+        auto const* pixels = vramUnpackBuffer_ != nullptr ?
+                    reinterpret_cast<char const*>(static_cast<size_t>(vramOffset)) :
+                    vram_.constData() + vramOffset;
+        functions->glTexSubImage2D(
+                    GL_TEXTURE_RECTANGLE,
+                    0,
+                    vramRect.textureX,
+                    vramRect.textureY,
+                    vramRect.width,
+                    vramRect.height,
+                    GL_RG_INTEGER,
+                    GL_UNSIGNED_BYTE,
+                    pixels);
+    }
+    functions->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    functions->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    vramTexture_->release();
+    if (vramUnpackBuffer_ != nullptr)
+    { vramUnpackBuffer_->release(); }
+}
+
+void SceneGLResources::reuseVramTexture(SceneGLResources& previous)
+{
+    if (!previous.isResident()
+            || previous.vram_.size() != vram_.size()
+            || previous.mesh_.vramTextureWidth != mesh_.vramTextureWidth
+            || previous.mesh_.vramTextureHeight != mesh_.vramTextureHeight
+            || previous.mesh_.vramRects != mesh_.vramRects)
+    { return; }
+    changedVramRects_.clear();
+    for (auto const& vramRect : mesh_.vramRects)
+    {
+        if (!SceneVRamLayout::isRectEqual(vram_, previous.vram_, vramRect))
+        { changedVramRects_.append(vramRect); }
+    }
+    reusedVramTexture_ = std::move(previous.vramTexture_);
+}
+
+void SceneGLResources::uploadIndices(QOpenGLBuffer& ebo, QVector<uint32_t> const& indices)
+{
+    ebo.create();
+    ebo.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    ebo.bind();
+    ebo.allocate(indices.constData(), indices.count() * sizeof(uint32_t));
+    ebo.release();
+}
+
+void SceneGLResources::setupVao(
+        QOpenGLShaderProgram& shaderProgram,
+        QOpenGLVertexArrayObject& vao,
+        QOpenGLBuffer& ebo)
+{
+    if (!vao.isCreated())
+    { vao.create(); }
+    shaderProgram.bind();
+    vbo_.bind();
+    {
+        QOpenGLVertexArrayObject::Binder vaoBinder(&vao);
+        shaderProgram.setAttributeBuffer(0, GL_FLOAT, offsetof(Vertex, pos), 3, sizeof(Vertex));
+        shaderProgram.setAttributeBuffer(1, GL_FLOAT, offsetof(Vertex, texturePos), 2, sizeof(Vertex));
+        shaderProgram.setAttributeBuffer(2, GL_FLOAT, offsetof(Vertex, texpage), 3, sizeof(Vertex));
+        shaderProgram.setAttributeBuffer(3, GL_FLOAT, offsetof(Vertex, clut), 2, sizeof(Vertex));
+        shaderProgram.setAttributeBuffer(4, GL_UNSIGNED_BYTE, offsetof(Vertex, textureWindow), 4, sizeof(Vertex));
+        shaderProgram.enableAttributeArray(0);
+        shaderProgram.enableAttributeArray(1);
+        shaderProgram.enableAttributeArray(2);
+        shaderProgram.enableAttributeArray(3);
+        shaderProgram.enableAttributeArray(4);
+        ebo.bind();
+    }
+    ebo.release();
+    vbo_.release();
+    shaderProgram.release();
+}
+
+void SceneGLResources::release()
+{
+    if (vbo_.isCreated())
+    { vbo_.destroy(); }
+    if (opaquePolygonsEbo_.isCreated())
+    { opaquePolygonsEbo_.destroy(); }
+    if (semiTransparentPolygonsEbo_.isCreated())
+    { semiTransparentPolygonsEbo_.destroy(); }
+    for (auto* vramTexture : {&vramTexture_, &reusedVramTexture_})
+    {
+        if (*vramTexture != nullptr)
+        {
+            if ((*vramTexture)->isCreated())
+            { (*vramTexture)->destroy(); }
+            vramTexture->reset();
+        }
+    }
+}
+
+int SceneGLResources::opaquePolygonsIndicesNumber() const
+{
+    if (mesh_.voxelsChunks.isEmpty())
+    { return 0; }
+    auto const& lastVoxelsChunk = mesh_.voxelsChunks.last();
+    return lastVoxelsChunk.firstOpaqueIndex + lastVoxelsChunk.opaqueIndicesNumber;
+}
+
+size_t SceneGLResources::gpuMemorySize() const
+{
+    return mesh_.vertices.count() * sizeof(Vertex)
+            + (mesh_.opaquePolygonsIndices.count() + mesh_.semiTransparentPolygonsIndices.count())
+                * sizeof(uint32_t)
+            + mesh_.vramTextureWidth * mesh_.vramTextureHeight * PsxVRamConst::PIXEL_SIZE;
+}
+
+size_t SceneGLResources::cpuMemorySize() const
+{
+    return mesh_.memorySize()
+            + pvs_.memorySize()
+            + vram_.size();
+}
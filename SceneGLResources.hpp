@@ -0,0 +1,92 @@
+#ifndef SCENEGLRESOURCES_HPP
+#define SCENEGLRESOURCES_HPP
+
+#include "SceneBvh.hpp"
+#include "SceneMesh.hpp"
+#include "ScenePvs.hpp"
+#include <QByteArray>
+#include <QFuture>
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+#include <QOpenGLVertexArrayObject>
+#include <QVector>
+#include <QVector3D>
+#include <cstdint>
+#include <memory>
+
+inline QVector3D toVector3D(SceneMeshVector3 const& vector)
+{ return QVector3D(vector.x, vector.y, vector.z); }
+
+// Geometry and VRAM of one scene. The CPU copy is kept for the whole lifetime so the GPU objects can be
+// released under memory pressure and uploaded again without reparsing the scene. The buffers and the
+// texture can be shared by all views of a context share group; VAOs cannot, so every view sets up its own
+// with setupOpaquePolygonsVao() and setupSemiTransparentPolygonsVao().
+class SceneGLResources
+{
+public:
+    using Vertex = SceneMeshVertex;
+
+    SceneGLResources(SceneMesh mesh, QByteArray const& vram);
+    ~SceneGLResources();
+
+    bool isResident() const
+    { return vramTexture_ != nullptr; }
+    // Takes over the VRAM texture of a resident previous version of the same scene if the VRAM layout
+    // did not change, so the next upload() only updates the rectangles whose contents differ.
+    void reuseVramTexture(SceneGLResources& previous);
+    // The next upload reads the VRAM from the bound range of this pixel unpack buffer, which holds the
+    // whole PSX VRAM unmapped, instead of the CPU copy.
+    void setVramUnpackBuffer(QOpenGLBuffer* vramUnpackBuffer)
+    { vramUnpackBuffer_ = vramUnpackBuffer; }
+    void upload();
+    void release();
+    // Changes with every upload, so views can tell their VAOs refer to released buffers.
+    uint64_t uploadId() const
+    { return uploadId_; }
+    void setupOpaquePolygonsVao(QOpenGLShaderProgram& shaderProgram, QOpenGLVertexArrayObject& vao)
+    { setupVao(shaderProgram, vao, opaquePolygonsEbo_); }
+    void setupSemiTransparentPolygonsVao(QOpenGLShaderProgram& shaderProgram, QOpenGLVertexArrayObject& vao)
+    { setupVao(shaderProgram, vao, semiTransparentPolygonsEbo_); }
+    size_t gpuMemorySize() const;
+    size_t cpuMemorySize() const;
+    size_t meshMemorySize() const
+    { return mesh_.memorySize(); }
+    QOpenGLTexture& vramTexture()
+    { return *vramTexture_; }
+    // Full detail opaque indices, which come before the LOD ones.
+    int opaquePolygonsIndicesNumber() const;
+    QVector<VoxelsChunk> const& voxelsChunks() const
+    { return mesh_.voxelsChunks; }
+    QVector<ScenePolygonSource> const& polygonsSources() const
+    { return mesh_.polygonsSources; }
+    SceneVoxelsGrid const& voxelsGrid() const
+    { return mesh_.voxelsGrid; }
+    SceneBvh const& sceneBvh() const;
+    // Rejects a PVS computed for another version of the scene.
+    bool setPvs(ScenePvs pvs);
+    ScenePvs const& pvs() const
+    { return pvs_; }
+
+private:
+    void buildSceneBvh();
+    void uploadIndices(QOpenGLBuffer& ebo, QVector<uint32_t> const& indices);
+    void uploadVramRects(QVector<SceneVRamRect> const& vramRects);
+    void setupVao(QOpenGLShaderProgram& shaderProgram, QOpenGLVertexArrayObject& vao, QOpenGLBuffer& ebo);
+
+    SceneMesh mesh_;
+    QByteArray vram_;
+    SceneBvh sceneBvh_;
+    mutable QFuture<void> sceneBvhBuild_;
+    ScenePvs pvs_;
+    QOpenGLBuffer vbo_;
+    QOpenGLBuffer opaquePolygonsEbo_;
+    QOpenGLBuffer semiTransparentPolygonsEbo_;
+    std::unique_ptr<QOpenGLTexture> vramTexture_;
+    std::unique_ptr<QOpenGLTexture> reusedVramTexture_;
+    QVector<SceneVRamRect> changedVramRects_;
+    QOpenGLBuffer* vramUnpackBuffer_;
+    uint64_t uploadId_;
+};
+
+#endif // SCENEGLRESOURCES_HPP
@@ -0,0 +1,23 @@
+#include "SceneGLVertexArrays.hpp"
+
+SceneGLVertexArrays::SceneGLVertexArrays()
+    : uploadId_{0}
+{}
+
+void SceneGLVertexArrays::update(SceneGLResources& scene, QOpenGLShaderProgram& shaderProgram)
+{
+    if (scene.uploadId() == uploadId_)
+    { return; }
+    scene.setupOpaquePolygonsVao(shaderProgram, opaquePolygonsVao_);
+    scene.setupSemiTransparentPolygonsVao(shaderProgram, semiTransparentPolygonsVao_);
+    uploadId_ = scene.uploadId();
+}
+
+void SceneGLVertexArrays::destroy()
+{
+    if (opaquePolygonsVao_.isCreated())
+    { opaquePolygonsVao_.destroy(); }
+    if (semiTransparentPolygonsVao_.isCreated())
+    { semiTransparentPolygonsVao_.destroy(); }
+    uploadId_ = 0;
+}
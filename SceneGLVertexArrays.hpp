@@ -0,0 +1,29 @@
+#ifndef SCENEGLVERTEXARRAYS_HPP
+#define SCENEGLVERTEXARRAYS_HPP
+
+#include "SceneGLResources.hpp"
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <cstdint>
+
+// VAOs of one view of a scene. The scene buffers may be shared with other contexts, the VAOs never are,
+// so every view keeps its own and sets them up again whenever the scene or its upload changes.
+class SceneGLVertexArrays
+{
+public:
+    SceneGLVertexArrays();
+
+    void update(SceneGLResources& scene, QOpenGLShaderProgram& shaderProgram);
+    void destroy();
+    QOpenGLVertexArrayObject& opaquePolygons()
+    { return opaquePolygonsVao_; }
+    QOpenGLVertexArrayObject& semiTransparentPolygons()
+    { return semiTransparentPolygonsVao_; }
+
+private:
+    uint64_t uploadId_;
+    QOpenGLVertexArrayObject opaquePolygonsVao_;
+    QOpenGLVertexArrayObject semiTransparentPolygonsVao_;
+};
+
+#endif // SCENEGLVERTEXARRAYS_HPP
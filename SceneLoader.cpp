@@ -0,0 +1,85 @@
+#include "PsxVRamConst.hpp"
+#include "SavestateImporter.hpp"
+#include "SceneLoader.hpp"
+#include "SceneMeshBuilder.hpp"
+#include <QFile>
+#include <new>
+
+SceneLoader::SceneLoader()
+    : psxRam_(std::make_unique<BufferedPsxRam>()),
+      isSceneRead_{false}
+{}
+
+CoreError SceneLoader::loadDump(QString const& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly))
+    { return {CoreErrorCode::FILE_OPEN_FAILED, QString("Could not open file %1.").arg(filePath)}; }
+    // Mapped rather than read; setMemory() copies the RAM into the buffered RAM and only the VRAM to the heap.
+    auto const* dump = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    if (dump == nullptr)
+    {
+        if (file.size() > 0)
+        { return {CoreErrorCode::FILE_READ_FAILED, QString("Could not read file %1.").arg(filePath)}; }
+        return setMemory({});
+    }
+    return setMemory(QByteArray::fromRawData(reinterpret_cast<char const*>(dump), static_cast<int>(file.size())));
+}
+
+CoreError SceneLoader::loadSavestate(QString const& filePath)
+{
+    isSceneRead_ = false;
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly))
+    { return {CoreErrorCode::FILE_OPEN_FAILED, QString("Could not open file %1.").arg(filePath)}; }
+    try
+    { SavestateImporter().import(file, *psxRam_, psxVRam_); }
+    catch (QString const& error)
+    {
+        if (file.error() == QFileDevice::ReadError)
+        { return {CoreErrorCode::FILE_READ_FAILED, QString("Could not read file %1.").arg(filePath)}; }
+        return {CoreErrorCode::UNSUPPORTED_FORMAT, error};
+    }
+    catch (std::bad_alloc const&)
+    { return {CoreErrorCode::OUT_OF_MEMORY, "Out of memory while importing savestate."}; }
+    return CoreError::ok();
+}
+
+CoreError SceneLoader::setMemory(QByteArray const& dump)
+{
+    isSceneRead_ = false;
+    int expectedSize = PsxRamConst::SIZE + PsxVRamConst::SIZE;
+    if (dump.size() != expectedSize)
+    {
+        return {
+            CoreErrorCode::INVALID_DUMP_SIZE,
+            QString("File size %1 is different than expected %2.").arg(dump.size()).arg(expectedSize)};
+    }
+    psxRam_->fill(dump.constData());
+    psxVRam_ = dump.mid(PsxRamConst::SIZE);
+    return CoreError::ok();
+}
+
+CoreError SceneLoader::readScene()
+{
+    isSceneRead_ = false;
+    try
+    { scene_.read(*psxRam_, psxVRam_); }
+    catch (QString const& error)
+    { return {CoreErrorCode::SCENE_READ_FAILED, error}; }
+    catch (std::bad_alloc const&)
+    { return {CoreErrorCode::OUT_OF_MEMORY, "Out of memory while reading scene."}; }
+    isSceneRead_ = true;
+    return CoreError::ok();
+}
+
+CoreError SceneLoader::buildMesh(SceneMesh& mesh) const
+{
+    if (!isSceneRead_)
+    { return {CoreErrorCode::SCENE_NOT_READ, "Scene was not read."}; }
+    try
+    { SceneMeshBuilder::build(scene_, mesh); }
+    catch (std::bad_alloc const&)
+    { return {CoreErrorCode::OUT_OF_MEMORY, "Out of memory while building scene mesh."}; }
+    return CoreError::ok();
+}
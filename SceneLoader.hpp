@@ -0,0 +1,38 @@
+#ifndef SCENELOADER_HPP
+#define SCENELOADER_HPP
+
+#include "ADScene.hpp"
+#include "BufferedPsxRam.hpp"
+#include "CoreError.hpp"
+#include "SceneMesh.hpp"
+#include <memory>
+
+// Non-throwing entry point of the core library: loads PSX memory, parses the scene and builds its mesh.
+// Every call reports failures as a CoreError instead of an exception.
+class SceneLoader
+{
+public:
+    SceneLoader();
+
+    CoreError loadDump(QString const& filePath);
+    CoreError loadSavestate(QString const& filePath);
+    CoreError setMemory(QByteArray const& dump);
+    CoreError readScene();
+    CoreError buildMesh(SceneMesh& mesh) const;
+    BufferedPsxRam const& psxRam() const
+    { return *psxRam_; }
+    QByteArray const& psxVRam() const
+    { return psxVRam_; }
+    ADScene const& scene() const
+    { return scene_; }
+    bool isSceneRead() const
+    { return isSceneRead_; }
+
+private:
+    std::unique_ptr<BufferedPsxRam> psxRam_;
+    QByteArray psxVRam_;
+    ADScene scene_;
+    bool isSceneRead_;
+};
+
+#endif // SCENELOADER_HPP
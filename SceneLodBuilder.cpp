@@ -0,0 +1,312 @@
+#include "SceneLodBuilder.hpp"
+#include <QMultiHash>
+#include <cmath>
+
+namespace
+{
+constexpr float const DIRECTION_EPSILON = 1e-4f;
+// Positions are multiples of 1/4096 and texture coordinates whole texels.
+constexpr float const POSITION_EPSILON = 1e-5f;
+constexpr float const TEXEL_EPSILON = 1e-2f;
+constexpr float const POSITION_KEY_SCALE = 4096.0f;
+// Corner permutations of the 8 symmetries of a quad, which keep 0 and 1 on one edge and 2 and 3 on the
+// opposite one.
+constexpr int const ORIENTATIONS[8][4] = {
+    {0, 1, 2, 3}, {1, 0, 3, 2}, {2, 3, 0, 1}, {3, 2, 1, 0},
+    {0, 2, 1, 3}, {2, 0, 3, 1}, {1, 3, 0, 2}, {3, 1, 2, 0}};
+
+struct Quad
+{
+    SceneMeshVertex corners[4];
+    uint32_t firstVertexIndex;
+    bool isAlphaTested;
+    bool isMerged;
+    bool isAlive;
+};
+
+SceneMeshVector3 operator-(SceneMeshVector3 const& one, SceneMeshVector3 const& other)
+{ return {one.x - other.x, one.y - other.y, one.z - other.z}; }
+
+SceneMeshVector2 operator-(SceneMeshVector2 const& one, SceneMeshVector2 const& other)
+{ return {one.x - other.x, one.y - other.y}; }
+
+float length(SceneMeshVector3 const& vector)
+{ return std::sqrt(vector.x * vector.x + vector.y * vector.y + vector.z * vector.z); }
+
+bool isNear(SceneMeshVector3 const& one, SceneMeshVector3 const& other)
+{
+    return std::abs(one.x - other.x) <= POSITION_EPSILON
+            && std::abs(one.y - other.y) <= POSITION_EPSILON
+            && std::abs(one.z - other.z) <= POSITION_EPSILON;
+}
+
+bool isNear(SceneMeshVector2 const& one, SceneMeshVector2 const& other)
+{ return std::abs(one.x - other.x) <= TEXEL_EPSILON && std::abs(one.y - other.y) <= TEXEL_EPSILON; }
+
+float texelAxis(SceneMeshVector2 const& texturePos, int axis)
+{ return axis == 0 ? texturePos.x : texturePos.y; }
+
+uint8_t& windowOrigin(SceneMeshTextureWindow& window, int axis)
+{ return axis == 0 ? window.x : window.y; }
+
+uint8_t& windowPeriod(SceneMeshTextureWindow& window, int axis)
+{ return axis == 0 ? window.width : window.height; }
+
+bool hasSameTexture(Quad const& one, Quad const& other)
+{
+    auto const& vertex = one.corners[0];
+    auto const& otherVertex = other.corners[0];
+    return vertex.texpage.x == otherVertex.texpage.x
+            && vertex.texpage.y == otherVertex.texpage.y
+            && vertex.texpage.z == otherVertex.texpage.z
+            && vertex.clut.x == otherVertex.clut.x
+            && vertex.clut.y == otherVertex.clut.y;
+}
+
+bool isParallelogram(Quad const& quad)
+{
+    auto const* corners = quad.corners;
+    return isNear(corners[3].pos - corners[1].pos, corners[2].pos - corners[0].pos)
+            && isNear(corners[3].texturePos - corners[1].texturePos, corners[2].texturePos - corners[0].texturePos);
+}
+
+uint64_t positionKey(SceneMeshVector3 const& position)
+{
+    auto quantize = [](float coordinate) {
+        return static_cast<uint64_t>(qRound64(coordinate * POSITION_KEY_SCALE)) & 0x1fffff;
+    };
+    return (quantize(position.x) << 42) | (quantize(position.y) << 21) | quantize(position.z);
+}
+
+Quad oriented(Quad const& quad, int const* orientation)
+{
+    auto result = quad;
+    for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
+    { result.corners[cornerIndex] = quad.corners[orientation[cornerIndex]]; }
+    return result;
+}
+
+// Merges quad other continuing quad one past its 1-3 edge, which other shares as its 0-2 edge.
+bool mergeOriented(Quad const& one, Quad const& other, Quad& merged)
+{
+    auto const* corners = one.corners;
+    auto const* otherCorners = other.corners;
+    auto direction = corners[1].pos - corners[0].pos;
+    auto otherDirection = otherCorners[1].pos - otherCorners[0].pos;
+    auto directionLength = length(direction);
+    auto otherDirectionLength = length(otherDirection);
+    if (directionLength <= POSITION_EPSILON || otherDirectionLength <= POSITION_EPSILON)
+    { return false; }
+    auto cosine = (direction.x * otherDirection.x + direction.y * otherDirection.y + direction.z * otherDirection.z)
+            / (directionLength * otherDirectionLength);
+    if (cosine < 1.0f - DIRECTION_EPSILON)
+    { return false; }
+    // Same texels per unit along the merge direction and the same texture coordinates along the shared edge.
+    auto texelsStep = corners[1].texturePos - corners[0].texturePos;
+    auto scale = otherDirectionLength / directionLength;
+    SceneMeshVector2 scaledTexelsStep{texelsStep.x * scale, texelsStep.y * scale};
+    if (!isNear(otherCorners[1].texturePos - otherCorners[0].texturePos, scaledTexelsStep)
+            || !isNear(
+                corners[3].texturePos - corners[1].texturePos,
+                otherCorners[2].texturePos - otherCorners[0].texturePos))
+    { return false; }
+
+    // Along every axis the merged quad repeats the tile of whichever quad has a window on it; a quad without
+    // one has to fit in the tile then. Quads with different windows are not merged.
+    auto window = corners[0].textureWindow;
+    auto otherWindow = otherCorners[0].textureWindow;
+    auto fitsWindow = [](Quad const& quad, int axis, float origin, float period) {
+        for (auto const& corner : quad.corners)
+        {
+            auto texel = texelAxis(corner.texturePos, axis);
+            if (texel < origin - TEXEL_EPSILON || texel > origin + period + TEXEL_EPSILON)
+            { return false; }
+        }
+        return true;
+    };
+    for (int axis : {0, 1})
+    {
+        if (windowPeriod(otherWindow, axis) == 0)
+        {
+            if (windowPeriod(window, axis) != 0
+                    && !fitsWindow(other, axis, windowOrigin(window, axis), windowPeriod(window, axis)))
+            { return false; }
+        }
+        else if (windowPeriod(window, axis) == 0)
+        {
+            if (!fitsWindow(one, axis, windowOrigin(otherWindow, axis), windowPeriod(otherWindow, axis)))
+            { return false; }
+            windowOrigin(window, axis) = windowOrigin(otherWindow, axis);
+            windowPeriod(window, axis) = windowPeriod(otherWindow, axis);
+        }
+        else if (windowOrigin(window, axis) != windowOrigin(otherWindow, axis)
+                 || windowPeriod(window, axis) != windowPeriod(otherWindow, axis))
+        { return false; }
+    }
+    // The texture coordinates either continue across the shared edge or jump by whole tiles along one axis;
+    // two quads repeating without a window get the tile spanned by the first one.
+    auto delta = otherCorners[0].texturePos - corners[1].texturePos;
+    if (!isNear(delta, {0.0f, 0.0f}))
+    {
+        int axis = std::abs(delta.x) > TEXEL_EPSILON ? 0 : 1;
+        if (std::abs(texelAxis(delta, 1 - axis)) > TEXEL_EPSILON)
+        { return false; }
+        if (windowPeriod(window, axis) == 0)
+        {
+            auto origin = qMin(texelAxis(corners[0].texturePos, axis), texelAxis(corners[1].texturePos, axis));
+            auto period = std::abs(texelAxis(texelsStep, axis));
+            if (period < 1.0f || period > 255.0f || origin < 0.0f || origin > 255.0f
+                    || !fitsWindow(one, axis, origin, period) || !fitsWindow(other, axis, origin, period))
+            { return false; }
+            windowOrigin(window, axis) = static_cast<uint8_t>(std::round(origin));
+            windowPeriod(window, axis) = static_cast<uint8_t>(std::round(period));
+        }
+        float period = windowPeriod(window, axis);
+        auto periods = texelAxis(delta, axis) / period;
+        if (std::abs(periods - std::round(periods)) * period > TEXEL_EPSILON)
+        { return false; }
+    }
+    merged = one;
+    merged.corners[1] = otherCorners[1];
+    merged.corners[3] = otherCorners[3];
+    for (int cornerIndex : {1, 3})
+    {
+        merged.corners[cornerIndex].texturePos.x -= delta.x;
+        merged.corners[cornerIndex].texturePos.y -= delta.y;
+    }
+    for (auto& corner : merged.corners)
+    { corner.textureWindow = window; }
+    merged.isMerged = true;
+    return true;
+}
+
+bool merge(Quad const& one, Quad const& other, Quad& merged)
+{
+    if (one.isAlphaTested != other.isAlphaTested
+            || !hasSameTexture(one, other)
+            || !isParallelogram(one)
+            || !isParallelogram(other))
+    { return false; }
+    for (auto const* orientation : ORIENTATIONS)
+    {
+        auto orientedOne = oriented(one, orientation);
+        for (auto const* otherOrientation : ORIENTATIONS)
+        {
+            auto orientedOther = oriented(other, otherOrientation);
+            if (isNear(orientedOne.corners[1].pos, orientedOther.corners[0].pos)
+                    && isNear(orientedOne.corners[3].pos, orientedOther.corners[2].pos)
+                    && mergeOriented(orientedOne, orientedOther, merged))
+            { return true; }
+        }
+    }
+    return false;
+}
+
+void insertCorners(QMultiHash<uint64_t, int>& cornersQuads, Quad const& quad, int quadIndex)
+{
+    for (auto const& corner : quad.corners)
+    { cornersQuads.insert(positionKey(corner.pos), quadIndex); }
+}
+
+void removeCorners(QMultiHash<uint64_t, int>& cornersQuads, Quad const& quad, int quadIndex)
+{
+    for (auto const& corner : quad.corners)
+    { cornersQuads.remove(positionKey(corner.pos), quadIndex); }
+}
+
+void buildChunkLod(SceneMesh& mesh, VoxelsChunk& chunk)
+{
+    auto& indices = mesh.opaquePolygonsIndices;
+    QVector<Quad> quads;
+    quads.reserve(chunk.opaqueIndicesNumber / 6);
+    QMultiHash<uint64_t, int> cornersQuads;
+    auto firstAlphaTestedIndex = chunk.firstOpaqueIndex + chunk.opaqueIndicesNumber - chunk.alphaTestedIndicesNumber;
+    for (auto index = chunk.firstOpaqueIndex; index < chunk.firstOpaqueIndex + chunk.opaqueIndicesNumber; index += 6)
+    {
+        Quad quad;
+        quad.firstVertexIndex = indices[index];
+        quad.isAlphaTested = index >= firstAlphaTestedIndex;
+        for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
+        { quad.corners[cornerIndex] = mesh.vertices[quad.firstVertexIndex + cornerIndex]; }
+        quad.isMerged = false;
+        quad.isAlive = true;
+        insertCorners(cornersQuads, quad, quads.count());
+        quads.append(quad);
+    }
+
+    QVector<int> pendingQuads;
+    pendingQuads.reserve(quads.count());
+    for (int quadIndex = quads.count() - 1; quadIndex >= 0; --quadIndex)
+    { pendingQuads.append(quadIndex); }
+    bool isAnyMerged = false;
+    while (!pendingQuads.isEmpty())
+    {
+        auto quadIndex = pendingQuads.takeLast();
+        auto& quad = quads[quadIndex];
+        if (!quad.isAlive)
+        { continue; }
+        for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
+        {
+            bool isMerged = false;
+            for (auto otherIndex : cornersQuads.values(positionKey(quad.corners[cornerIndex].pos)))
+            {
+                auto& other = quads[otherIndex];
+                Quad merged;
+                if (otherIndex == quadIndex || !other.isAlive || !merge(quad, other, merged))
+                { continue; }
+                removeCorners(cornersQuads, quad, quadIndex);
+                removeCorners(cornersQuads, other, otherIndex);
+                other.isAlive = false;
+                quad = merged;
+                insertCorners(cornersQuads, quad, quadIndex);
+                // Merged again until no neighbour fits.
+                pendingQuads.append(quadIndex);
+                isMerged = true;
+                break;
+            }
+            if (isMerged)
+            {
+                isAnyMerged = true;
+                break;
+            }
+        }
+    }
+
+    if (!isAnyMerged)
+    {
+        chunk.firstLodOpaqueIndex = chunk.firstOpaqueIndex;
+        chunk.lodOpaqueIndicesNumber = chunk.opaqueIndicesNumber;
+        chunk.lodAlphaTestedIndicesNumber = chunk.alphaTestedIndicesNumber;
+        return;
+    }
+    // Quads only merge with quads of the same kind, so the fully opaque ones still come first.
+    chunk.firstLodOpaqueIndex = indices.count();
+    chunk.lodAlphaTestedIndicesNumber = 0;
+    for (auto isAlphaTested : {false, true})
+    {
+        for (auto const& quad : quads)
+        {
+            if (!quad.isAlive || quad.isAlphaTested != isAlphaTested)
+            { continue; }
+            auto firstVertexIndex = quad.firstVertexIndex;
+            if (quad.isMerged)
+            {
+                firstVertexIndex = mesh.vertices.count();
+                for (auto const& corner : quad.corners)
+                { mesh.vertices.append(corner); }
+            }
+            for (auto vertexOffset : {0u, 1u, 2u, 2u, 1u, 3u})
+            { indices.append(firstVertexIndex + vertexOffset); }
+            if (isAlphaTested)
+            { chunk.lodAlphaTestedIndicesNumber += 6; }
+        }
+    }
+    chunk.lodOpaqueIndicesNumber = indices.count() - chunk.firstLodOpaqueIndex;
+}
+}
+
+void SceneLodBuilder::build(SceneMesh& mesh)
+{
+    for (auto& chunk : mesh.voxelsChunks)
+    { buildChunkLod(mesh, chunk); }
+}
@@ -0,0 +1,22 @@
+#ifndef SCENELODBUILDER_HPP
+#define SCENELODBUILDER_HPP
+
+#include "SceneMesh.hpp"
+
+// Builds the distant detail level of every voxels chunk by merging its opaque quads. Two quads are merged
+// when they share an edge, continue each other in one plane, use the same texpage and CLUT, and the merged
+// quad maps the texture exactly as both did: either the texture coordinates continue across the shared
+// edge, or the same tile repeats and the merged quad gets a texture window wrapping its coordinates back
+// into the tile. Only parallelograms with affine texture coordinates are merged, so a merged quad looks
+// the same as its parts apart from T-junction cracks along its edges. Fully opaque and alpha-tested quads
+// are not merged with each other. Semi-transparent quads are kept, they are drawn in voxel order.
+class SceneLodBuilder
+{
+public:
+    SceneLodBuilder() = delete;
+
+    // Appends the merged vertices and the chunks LOD indices to the mesh.
+    static void build(SceneMesh& mesh);
+};
+
+#endif // SCENELODBUILDER_HPP
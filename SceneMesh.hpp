@@ -0,0 +1,155 @@
+#ifndef SCENEMESH_HPP
+#define SCENEMESH_HPP
+
+#include "ADDefinitions.hpp"
+#include "PsxRamAddress.hpp"
+#include <QVector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+struct SceneMeshVector2
+{
+    float x;
+    float y;
+};
+
+struct SceneMeshVector3
+{
+    float x;
+    float y;
+    float z;
+};
+
+// Texture coordinates repeat every width texels from x and every height texels from y; a zero size
+// disables the repetition along that axis. Only quads merged by SceneLodBuilder repeat their texture.
+struct SceneMeshTextureWindow
+{
+    uint8_t x;
+    uint8_t y;
+    uint8_t width;
+    uint8_t height;
+};
+
+// texpage holds the texpage origin and bpp, clut the CLUT origin, both in VRAM texture pixels.
+struct SceneMeshVertex
+{
+    SceneMeshVector3 pos;
+    SceneMeshVector2 texturePos;
+    SceneMeshVector3 texpage;
+    SceneMeshVector2 clut;
+    SceneMeshTextureWindow textureWindow;
+};
+
+struct ScenePolygonSource
+{
+    uint16_t voxelX;
+    uint16_t voxelY;
+    PsxRamAddress address;
+    AD::PolygonDescriptor descriptor;
+};
+
+struct VoxelsChunk
+{
+    SceneMeshVector3 boundsMin;
+    SceneMeshVector3 boundsMax;
+    uint32_t firstOpaqueIndex;
+    uint32_t opaqueIndicesNumber;
+    // Opaque polygons with coplanar quads merged, the same range as above if nothing could be merged.
+    uint32_t firstLodOpaqueIndex;
+    uint32_t lodOpaqueIndicesNumber;
+    // Both ranges end with the polygons sampling transparent texels, which need alpha testing; the fully
+    // opaque polygons before them can be drawn without.
+    uint32_t alphaTestedIndicesNumber;
+    uint32_t lodAlphaTestedIndicesNumber;
+};
+
+// Voxel grid of a scene in mesh coordinates; voxel x grows along -x and voxel y along -z. The
+// semi-transparent polygons indices hold every row twice, first with voxels in ascending x and then, after
+// all rows, with voxels in descending x, so every part of a row on one side of the camera is a single
+// back to front range. semiTransparentFirstIndices holds the first index of every voxel in the ascending
+// layout followed by the number of indices in it. chunksIndices maps every chunk of the grid to its
+// VoxelsChunk, or -1 if the chunk is empty.
+struct SceneVoxelsGrid
+{
+    uint16_t width{0};
+    uint16_t height{0};
+    float originX{0.0f};
+    float originZ{0.0f};
+    float voxelSize{0.0f};
+    QVector<uint32_t> semiTransparentFirstIndices;
+    QVector<int32_t> chunksIndices;
+
+    int voxelX(float x) const
+    { return static_cast<int>(std::floor((originX - x) / voxelSize)); }
+    int voxelY(float z) const
+    { return static_cast<int>(std::floor((originZ - z) / voxelSize)); }
+};
+
+// Rectangle of PSX VRAM referenced by a mesh and its origin in the compact VRAM texture, in VRAM pixels.
+struct SceneVRamRect
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    uint16_t textureX;
+    uint16_t textureY;
+
+    bool operator==(SceneVRamRect const& other) const
+    {
+        return x == other.x && y == other.y && width == other.width && height == other.height
+                && textureX == other.textureX && textureY == other.textureY;
+    }
+};
+
+// Every polygon is a quad of 4 consecutive vertices drawn as triangles (0, 1, 2) and (2, 1, 3). The
+// vertices and opaque indices of the polygons come first, one quad per polygons source, followed by the
+// merged quads and the indices of the voxels chunks LOD. Every loaded scene keeps the mesh it was built into
+// without trimming its buffers, so each load allocates them once.
+struct SceneMesh
+{
+    QVector<SceneMeshVertex> vertices;
+    QVector<uint32_t> opaquePolygonsIndices;
+    QVector<uint32_t> semiTransparentPolygonsIndices;
+    QVector<VoxelsChunk> voxelsChunks;
+    QVector<ScenePolygonSource> polygonsSources;
+    SceneVoxelsGrid voxelsGrid;
+    QVector<SceneVRamRect> vramRects;
+    uint16_t vramTextureWidth{0};
+    uint16_t vramTextureHeight{0};
+
+    // Empties the mesh keeping the capacity of its buffers for the next build.
+    void clear()
+    {
+        vertices.clear();
+        opaquePolygonsIndices.clear();
+        semiTransparentPolygonsIndices.clear();
+        voxelsChunks.clear();
+        polygonsSources.clear();
+        voxelsGrid.semiTransparentFirstIndices.clear();
+        voxelsGrid.chunksIndices.clear();
+        voxelsGrid.width = 0;
+        voxelsGrid.height = 0;
+        voxelsGrid.originX = 0.0f;
+        voxelsGrid.originZ = 0.0f;
+        voxelsGrid.voxelSize = 0.0f;
+        vramRects.clear();
+        vramTextureWidth = 0;
+        vramTextureHeight = 0;
+    }
+
+    // Allocated size of the buffers, which can be above what the mesh uses.
+    size_t memorySize() const
+    {
+        return vertices.capacity() * sizeof(SceneMeshVertex)
+                + (opaquePolygonsIndices.capacity() + semiTransparentPolygonsIndices.capacity()) * sizeof(uint32_t)
+                + voxelsChunks.capacity() * sizeof(VoxelsChunk)
+                + polygonsSources.capacity() * sizeof(ScenePolygonSource)
+                + voxelsGrid.semiTransparentFirstIndices.capacity() * sizeof(uint32_t)
+                + voxelsGrid.chunksIndices.capacity() * sizeof(int32_t)
+                + vramRects.capacity() * sizeof(SceneVRamRect);
+    }
+};
+
+#endif // SCENEMESH_HPP
@@ -0,0 +1,237 @@
+#include "ADSceneConst.hpp"
+#include "PsxVRamConst.hpp"
+#include "SceneLodBuilder.hpp"
+#include "SceneMeshBuilder.hpp"
+#include "SceneVRamLayout.hpp"
+#include <algorithm>
+
+static AD::Point3D operator+(AD::Point3D const& one, AD::Point3D const& other)
+{
+    AD::Point3D result;
+    result.x = one.x + other.x;
+    result.y = one.y + other.y;
+    result.z = one.z + other.z;
+    return result;
+}
+
+void SceneMeshBuilder::build(ADScene const& adScene, SceneMesh& mesh)
+{
+    mesh.clear();
+    auto chunksWidth = (adScene.width() + VOXELS_CHUNK_SIZE - 1) / VOXELS_CHUNK_SIZE;
+    auto chunksHeight = (adScene.height() + VOXELS_CHUNK_SIZE - 1) / VOXELS_CHUNK_SIZE;
+    auto& vertices = mesh.vertices;
+    // Every buffer is allocated once, the polygons were counted while reading the scene. The vertices and
+    // opaque indices also have room for the LOD: a chunk's LOD has at most as many quads as the chunk, and
+    // every merged quad in it replaces at least two opaque quads, so it adds at most 2 vertices per quad.
+    auto polygonsNumber = adScene.polygonsNumber();
+    auto opaquePolygonsNumber = polygonsNumber - adScene.semiTransparentPolygonsNumber();
+    vertices.reserve(polygonsNumber * 4 + opaquePolygonsNumber * 2);
+    mesh.opaquePolygonsIndices.reserve(opaquePolygonsNumber * 6 * 2);
+    mesh.polygonsSources.reserve(polygonsNumber);
+    mesh.voxelsChunks.reserve(chunksWidth * chunksHeight);
+    mesh.voxelsGrid.chunksIndices.fill(-1, chunksWidth * chunksHeight);
+    SceneTextureOpacity textureOpacity(adScene.rawVRam());
+    QVector<uint32_t> alphaTestedFirstVertexIndices;
+    for (auto chunkY = 0u; chunkY < chunksHeight; ++chunkY)
+    {
+        for (auto chunkX = 0u; chunkX < chunksWidth; ++chunkX)
+        {
+            VoxelsChunk chunk;
+            chunk.firstOpaqueIndex = mesh.opaquePolygonsIndices.count();
+            auto firstVertexIndex = vertices.count();
+            auto lastVoxelY = qMin((chunkY + 1) * VOXELS_CHUNK_SIZE, adScene.height());
+            auto lastVoxelX = qMin((chunkX + 1) * VOXELS_CHUNK_SIZE, adScene.width());
+            for (auto voxelY = chunkY * VOXELS_CHUNK_SIZE; voxelY < lastVoxelY; ++voxelY)
+            {
+                for (auto voxelX = chunkX * VOXELS_CHUNK_SIZE; voxelX < lastVoxelX; ++voxelX)
+                { appendVoxel(adScene, voxelX, voxelY, mesh); }
+            }
+            if (vertices.count() == firstVertexIndex)
+            { continue; }
+            chunk.opaqueIndicesNumber = mesh.opaquePolygonsIndices.count() - chunk.firstOpaqueIndex;
+            chunk.alphaTestedIndicesNumber = moveAlphaTestedLast(
+                        mesh, chunk.firstOpaqueIndex, textureOpacity, alphaTestedFirstVertexIndices);
+            chunk.boundsMin = chunk.boundsMax = vertices[firstVertexIndex].pos;
+            for (auto vertexIt = vertices.cbegin() + firstVertexIndex; vertexIt != vertices.cend(); ++vertexIt)
+            {
+                chunk.boundsMin.x = qMin(chunk.boundsMin.x, vertexIt->pos.x);
+                chunk.boundsMin.y = qMin(chunk.boundsMin.y, vertexIt->pos.y);
+                chunk.boundsMin.z = qMin(chunk.boundsMin.z, vertexIt->pos.z);
+                chunk.boundsMax.x = qMax(chunk.boundsMax.x, vertexIt->pos.x);
+                chunk.boundsMax.y = qMax(chunk.boundsMax.y, vertexIt->pos.y);
+                chunk.boundsMax.z = qMax(chunk.boundsMax.z, vertexIt->pos.z);
+            }
+            mesh.voxelsGrid.chunksIndices[chunkY * chunksWidth + chunkX] = mesh.voxelsChunks.count();
+            mesh.voxelsChunks.append(chunk);
+        }
+    }
+    buildVoxelsGrid(adScene, mesh);
+    SceneLodBuilder::build(mesh);
+    SceneVRamLayout::build(mesh);
+}
+
+void SceneMeshBuilder::buildVoxelsGrid(ADScene const& adScene, SceneMesh& mesh)
+{
+    auto& voxelsGrid = mesh.voxelsGrid;
+    voxelsGrid.width = adScene.width();
+    voxelsGrid.height = adScene.height();
+    AD::Point3D gridOrigin;
+    gridOrigin.x = -ADSceneConst::HALF_VOXEL_SIZE * adScene.width();
+    gridOrigin.y = -ADSceneConst::HALF_VOXEL_SIZE * adScene.height();
+    gridOrigin.z = 0;
+    AD::Point3D voxelSize;
+    voxelSize.x = ADSceneConst::VOXEL_SIZE;
+    voxelSize.y = 0;
+    voxelSize.z = 0;
+    voxelsGrid.originX = toMeshVector(gridOrigin).x;
+    voxelsGrid.originZ = toMeshVector(gridOrigin).z;
+    voxelsGrid.voxelSize = -toMeshVector(voxelSize).x;
+
+    // Polygons are bucketed by voxel keeping their order; polygon n is made of vertices 4n to 4n + 3.
+    auto voxelsNumber = adScene.width() * adScene.height();
+    auto& firstIndices = voxelsGrid.semiTransparentFirstIndices;
+    firstIndices.fill(0, voxelsNumber + 1);
+    auto const& polygonsSources = mesh.polygonsSources;
+    for (auto const& polygonSource : polygonsSources)
+    {
+        if (polygonSource.descriptor.flags.isSemiTransparent())
+        { firstIndices[polygonSource.voxelY * adScene.width() + polygonSource.voxelX + 1] += 6; }
+    }
+    for (uint32_t voxelIndex = 0; voxelIndex < voxelsNumber; ++voxelIndex)
+    { firstIndices[voxelIndex + 1] += firstIndices[voxelIndex]; }
+    auto indicesNumber = firstIndices.last();
+    auto& indices = mesh.semiTransparentPolygonsIndices;
+    indices.resize(indicesNumber * 2);
+    // The first indices are advanced while filling, ending at the first index of the next voxel, and
+    // shifted back afterwards.
+    for (int polygonIndex = 0; polygonIndex < polygonsSources.count(); ++polygonIndex)
+    {
+        auto const& polygonSource = polygonsSources[polygonIndex];
+        if (!polygonSource.descriptor.flags.isSemiTransparent())
+        { continue; }
+        auto& nextIndex = firstIndices[polygonSource.voxelY * adScene.width() + polygonSource.voxelX];
+        uint32_t firstVertexIndex = polygonIndex * 4;
+        for (auto vertexOffset : {0u, 1u, 2u, 2u, 1u, 3u})
+        { indices[nextIndex++] = firstVertexIndex + vertexOffset; }
+    }
+    std::copy_backward(firstIndices.begin(), firstIndices.end() - 1, firstIndices.end());
+    firstIndices[0] = 0;
+    auto* descendingIndexIt = indices.begin() + indicesNumber;
+    for (uint32_t voxelY = 0; voxelY < adScene.height(); ++voxelY)
+    {
+        for (auto voxelX = adScene.width(); voxelX-- > 0;)
+        {
+            auto voxelIndex = voxelY * adScene.width() + voxelX;
+            descendingIndexIt = std::copy(
+                        indices.cbegin() + firstIndices[voxelIndex],
+                        indices.cbegin() + firstIndices[voxelIndex + 1],
+                        descendingIndexIt);
+        }
+    }
+}
+
+uint32_t SceneMeshBuilder::moveAlphaTestedLast(
+        SceneMesh& mesh,
+        uint32_t firstIndex,
+        SceneTextureOpacity& textureOpacity,
+        QVector<uint32_t>& alphaTestedFirstVertexIndices)
+{
+    // Fully opaque quads are moved up keeping their order, the alpha-tested ones follow in theirs. The
+    // scratch vector is shared by all chunks, keeping its capacity.
+    auto& indices = mesh.opaquePolygonsIndices;
+    alphaTestedFirstVertexIndices.clear();
+    auto nextIndex = firstIndex;
+    for (auto index = firstIndex; index < static_cast<uint32_t>(indices.count()); index += 6)
+    {
+        auto firstVertexIndex = indices[index];
+        if (textureOpacity.isAlphaTested(mesh.vertices.constData() + firstVertexIndex))
+        {
+            alphaTestedFirstVertexIndices.append(firstVertexIndex);
+            continue;
+        }
+        for (auto vertexOffset : {0u, 1u, 2u, 2u, 1u, 3u})
+        { indices[nextIndex++] = firstVertexIndex + vertexOffset; }
+    }
+    for (auto firstVertexIndex : alphaTestedFirstVertexIndices)
+    {
+        for (auto vertexOffset : {0u, 1u, 2u, 2u, 1u, 3u})
+        { indices[nextIndex++] = firstVertexIndex + vertexOffset; }
+    }
+    return alphaTestedFirstVertexIndices.count() * 6;
+}
+
+void SceneMeshBuilder::appendVoxel(ADScene const& adScene, uint32_t voxelX, uint32_t voxelY, SceneMesh& mesh)
+{
+    auto addPolygonIndices = [](QVector<uint32_t>& indices, uint32_t firstVertexIndex) {
+        indices.append(firstVertexIndex + 0);
+        indices.append(firstVertexIndex + 1);
+        indices.append(firstVertexIndex + 2);
+        indices.append(firstVertexIndex + 2);
+        indices.append(firstVertexIndex + 1);
+        indices.append(firstVertexIndex + 3);
+    };
+
+    AD::Point3D voxelTranslation;
+    voxelTranslation.x = -ADSceneConst::HALF_VOXEL_SIZE * adScene.width() + ADSceneConst::VOXEL_SIZE * voxelX;
+    voxelTranslation.y = -ADSceneConst::HALF_VOXEL_SIZE * adScene.height() + ADSceneConst::VOXEL_SIZE * voxelY;
+    voxelTranslation.z = 0;
+    auto& vertices = mesh.vertices;
+    auto const& voxel = adScene.yAxisVoxels(voxelY)[voxelX];
+    auto const* polygonsDescriptors = adScene.polygonsDescriptors(voxel);
+    auto const* polygonDescriptorIt = polygonsDescriptors;
+    while (polygonDescriptorIt != polygonsDescriptors + voxel.polygonsNumber)
+    {
+        auto const& polygonDescriptor = *polygonDescriptorIt;
+        auto const& adVertex1 = adScene.adVertex(polygonDescriptor.vertex1Index);
+        auto const& adVertex2 = adScene.adVertex(polygonDescriptor.vertex2Index);
+        auto const& adVertex3 = adScene.adVertex(polygonDescriptor.vertex3Index);
+        auto const& adVertex4 = adScene.adVertex(polygonDescriptor.vertex4Index);
+        uint32_t firstVertexIndex = vertices.count();
+        vertices.append(
+                    toVertex(polygonDescriptor, adVertex1 + voxelTranslation, polygonDescriptor.texCoord1));
+        vertices.append(
+                    toVertex(polygonDescriptor, adVertex2 + voxelTranslation, polygonDescriptor.texCoord2()));
+        vertices.append(
+                    toVertex(polygonDescriptor, adVertex3 + voxelTranslation, polygonDescriptor.texCoord3));
+        vertices.append(
+                    toVertex(polygonDescriptor, adVertex4 + voxelTranslation, polygonDescriptor.texCoord4));
+
+        // Semi-transparent polygons are indexed per voxel by buildVoxelsGrid().
+        if (!polygonDescriptor.flags.isSemiTransparent())
+        { addPolygonIndices(mesh.opaquePolygonsIndices, firstVertexIndex); }
+        mesh.polygonsSources.append({
+                    static_cast<uint16_t>(voxelX),
+                    static_cast<uint16_t>(voxelY),
+                    adScene.polygonsDescriptorsAddresses(voxel)[polygonDescriptorIt - polygonsDescriptors],
+                    polygonDescriptor});
+        ++polygonDescriptorIt;
+    }
+}
+
+SceneMeshVector3 SceneMeshBuilder::toMeshVector(AD::Point3D const& adVertex)
+{
+    static constexpr int FRACTIONAL_SIZE = 12;
+    static constexpr float DENOMINATOR = 1 << FRACTIONAL_SIZE;
+    return {-adVertex.x / DENOMINATOR, -adVertex.z / DENOMINATOR, -adVertex.y / DENOMINATOR};
+}
+
+SceneMeshVertex SceneMeshBuilder::toVertex(
+        AD::PolygonDescriptor const& polygonDescriptor,
+        AD::Point3D const& adVertex,
+        GpuTexCoord const& texCoord)
+{
+    SceneMeshVertex vertex;
+    vertex.pos = toMeshVector(adVertex);
+    auto const& gpuTexpage = polygonDescriptor.texCoord2AndTexPage.fields.texpage;
+    auto const& gpuClut = polygonDescriptor.clut;
+    vertex.texturePos = {static_cast<float>(texCoord.x), static_cast<float>(texCoord.y)};
+    vertex.texpage = {
+        static_cast<float>(gpuTexpage.x << PsxVRamConst::TEXTURE_PAGE_X_SHIFT),
+        static_cast<float>(gpuTexpage.y << PsxVRamConst::TEXTURE_PAGE_Y_SHIFT),
+        static_cast<float>(gpuTexpage.texpageBpp)};
+    vertex.clut = {
+        static_cast<float>(gpuClut.x << PsxVRamConst::CLUT_X_SHIFT),
+        static_cast<float>(gpuClut.y << PsxVRamConst::CLUT_Y_SHIFT)};
+    vertex.textureWindow = {0, 0, 0, 0};
+    return vertex;
+}
@@ -0,0 +1,32 @@
+#ifndef SCENEMESHBUILDER_HPP
+#define SCENEMESHBUILDER_HPP
+
+#include "ADScene.hpp"
+#include "SceneMesh.hpp"
+#include "SceneTextureOpacity.hpp"
+
+class SceneMeshBuilder
+{
+public:
+    static constexpr uint32_t const VOXELS_CHUNK_SIZE = 4;
+
+    SceneMeshBuilder() = delete;
+
+    static void build(ADScene const& adScene, SceneMesh& mesh);
+    static SceneMeshVector3 toMeshVector(AD::Point3D const& adVertex);
+
+private:
+    static void appendVoxel(ADScene const& adScene, uint32_t voxelX, uint32_t voxelY, SceneMesh& mesh);
+    static void buildVoxelsGrid(ADScene const& adScene, SceneMesh& mesh);
+    static uint32_t moveAlphaTestedLast(
+            SceneMesh& mesh,
+            uint32_t firstIndex,
+            SceneTextureOpacity& textureOpacity,
+            QVector<uint32_t>& alphaTestedFirstVertexIndices);
+    static SceneMeshVertex toVertex(
+            AD::PolygonDescriptor const& polygonDescriptor,
+            AD::Point3D const& adVertex,
+            GpuTexCoord const& texCoord);
+};
+
+#endif // SCENEMESHBUILDER_HPP
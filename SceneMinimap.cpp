@@ -0,0 +1,130 @@
+#include "SceneMinimap.hpp"
+#include <cfloat>
+#include <cmath>
+
+static constexpr float const EYE_HEIGHT = 1.0f;
+static constexpr float const MIN_HALF_EXTENT = 0.01f;
+static constexpr float const VIEW_CONE_LENGTH = 24.0f;
+
+SceneMinimap::SceneMinimap()
+    : centerX_{0.0f},
+      centerZ_{0.0f},
+      halfExtent_{1.0f},
+      isValid_{false}
+{}
+
+void SceneMinimap::initialize()
+{ initializeOpenGLFunctions(); }
+
+void SceneMinimap::destroy()
+{
+    mapTarget_.reset();
+    isValid_ = false;
+}
+
+void SceneMinimap::begin(QVector<VoxelsChunk> const& voxelsChunks)
+{
+    QVector3D boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    QVector3D boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (auto const& voxelsChunk : voxelsChunks)
+    {
+        boundsMin.setX(qMin(boundsMin.x(), voxelsChunk.boundsMin.x));
+        boundsMin.setY(qMin(boundsMin.y(), voxelsChunk.boundsMin.y));
+        boundsMin.setZ(qMin(boundsMin.z(), voxelsChunk.boundsMin.z));
+        boundsMax.setX(qMax(boundsMax.x(), voxelsChunk.boundsMax.x));
+        boundsMax.setY(qMax(boundsMax.y(), voxelsChunk.boundsMax.y));
+        boundsMax.setZ(qMax(boundsMax.z(), voxelsChunk.boundsMax.z));
+    }
+    if (voxelsChunks.isEmpty())
+    { boundsMin = boundsMax = QVector3D(); }
+    centerX_ = (boundsMin.x() + boundsMax.x()) * 0.5f;
+    centerZ_ = (boundsMin.z() + boundsMax.z()) * 0.5f;
+    halfExtent_ = qMax(MIN_HALF_EXTENT, qMax(boundsMax.x() - boundsMin.x(), boundsMax.z() - boundsMin.z()) * 0.5f);
+    // Looking down with -z up on the map, so x grows to the right and z downwards.
+    viewMatrix_.setToIdentity();
+    viewMatrix_.lookAt(
+                QVector3D(centerX_, boundsMax.y() + EYE_HEIGHT, centerZ_),
+                QVector3D(centerX_, boundsMin.y(), centerZ_),
+                QVector3D(0.0f, 0.0f, -1.0f));
+    projectionMatrix_.setToIdentity();
+    projectionMatrix_.ortho(
+                -halfExtent_, halfExtent_,
+                -halfExtent_, halfExtent_,
+                EYE_HEIGHT * 0.5f, boundsMax.y() - boundsMin.y() + EYE_HEIGHT * 1.5f);
+    if (mapTarget_ == nullptr)
+    {
+        mapTarget_ = std::make_unique<QOpenGLFramebufferObject>(
+                    MAP_SIZE,
+                    MAP_SIZE,
+                    QOpenGLFramebufferObject::Depth);
+    }
+    mapTarget_->bind();
+    glViewport(0, 0, MAP_SIZE, MAP_SIZE);
+    glClearColor(0.0f, 0.0f, 0.1f, 1.0f);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void SceneMinimap::end(GLuint framebuffer, QSize const& size)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, size.width(), size.height());
+    isValid_ = true;
+}
+
+void SceneMinimap::present(QRect const& area, int framebufferHeight)
+{
+    if (!isValid_)
+    { return; }
+    GLint drawFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mapTarget_->handle());
+    glBlitFramebuffer(
+                0, 0, MAP_SIZE, MAP_SIZE,
+                area.left(), framebufferHeight - area.bottom() - 1,
+                area.right() + 1, framebufferHeight - area.top(),
+                GL_COLOR_BUFFER_BIT,
+                GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, drawFramebuffer);
+}
+
+QPointF SceneMinimap::mapPoint(QRect const& area, float x, float z) const
+{
+    return QPointF(
+                area.left() + (0.5f + (x - centerX_) / (2.0f * halfExtent_)) * area.width(),
+                area.top() + (0.5f + (z - centerZ_) / (2.0f * halfExtent_)) * area.height());
+}
+
+void SceneMinimap::drawCamera(
+        QPainter& painter,
+        QRect const& area,
+        QVector3D const& position,
+        QVector3D const& front,
+        float horizontalFieldOfView) const
+{
+    if (!isValid_)
+    { return; }
+    painter.save();
+    painter.setClipRect(area);
+    painter.setRenderHint(QPainter::Antialiasing);
+    auto cameraPoint = mapPoint(area, position.x(), position.z());
+    // Map directions match the scene ones, z pointing down.
+    auto direction = std::atan2(front.z(), front.x());
+    auto halfAngle = horizontalFieldOfView * 0.5f;
+    QPolygonF viewCone;
+    viewCone << cameraPoint
+             << cameraPoint + VIEW_CONE_LENGTH * QPointF(
+                    std::cos(direction - halfAngle), std::sin(direction - halfAngle))
+             << cameraPoint + VIEW_CONE_LENGTH * QPointF(
+                    std::cos(direction + halfAngle), std::sin(direction + halfAngle));
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(255, 255, 0, 96));
+    painter.drawPolygon(viewCone);
+    painter.setBrush(Qt::yellow);
+    painter.drawEllipse(cameraPoint, 3.0, 3.0);
+    painter.setPen(QColor(255, 255, 255, 160));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(area.adjusted(0, 0, -1, -1));
+    painter.restore();
+}
@@ -0,0 +1,59 @@
+#ifndef SCENEMINIMAP_HPP
+#define SCENEMINIMAP_HPP
+
+#include "SceneMesh.hpp"
+#include <QMatrix4x4>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QPainter>
+#include <QRect>
+#include <QVector3D>
+#include <memory>
+
+// Orthographic top-down view of a scene, rendered once into a texture whenever the scene changes. Every
+// frame only blits the texture into a corner of the view and paints the camera over it, so the minimap
+// costs no scene geometry per frame. The map is square and centered on the scene, with x to the right and
+// z downwards.
+class SceneMinimap : protected QOpenGLExtraFunctions
+{
+public:
+    static constexpr int const MAP_SIZE = 256;
+
+    SceneMinimap();
+
+    void initialize();
+    void destroy();
+    bool isValid() const
+    { return isValid_; }
+    void invalidate()
+    { isValid_ = false; }
+    // Binds the map target and sets up the matrices to draw the scene whose chunks are given with.
+    void begin(QVector<VoxelsChunk> const& voxelsChunks);
+    // Marks the map valid and binds the framebuffer again.
+    void end(GLuint framebuffer, QSize const& size);
+    QMatrix4x4 const& projectionMatrix() const
+    { return projectionMatrix_; }
+    QMatrix4x4 const& viewMatrix() const
+    { return viewMatrix_; }
+    // area is in pixels of the bound framebuffer, whose height is framebufferHeight, from the top left.
+    void present(QRect const& area, int framebufferHeight);
+    void drawCamera(
+            QPainter& painter,
+            QRect const& area,
+            QVector3D const& position,
+            QVector3D const& front,
+            float horizontalFieldOfView) const;
+
+private:
+    QPointF mapPoint(QRect const& area, float x, float z) const;
+
+    std::unique_ptr<QOpenGLFramebufferObject> mapTarget_;
+    QMatrix4x4 projectionMatrix_;
+    QMatrix4x4 viewMatrix_;
+    float centerX_;
+    float centerZ_;
+    float halfExtent_;
+    bool isValid_;
+};
+
+#endif // SCENEMINIMAP_HPP
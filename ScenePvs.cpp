@@ -0,0 +1,140 @@
+#include "DumpCatalog.hpp"
+#include "ScenePvs.hpp"
+#include <QFile>
+#include <QSaveFile>
+#include <cfloat>
+#include <cstring>
+
+QByteArray const ScenePvs::MAGIC("VMPVS002", 8);
+QString const ScenePvs::FILE_SUFFIX(".vmpvs");
+
+ScenePvs::ScenePvs()
+{ clear(); }
+
+void ScenePvs::clear()
+{
+    width_ = 0;
+    height_ = 0;
+    chunksNumber_ = 0;
+    wordsPerCell_ = 0;
+    minY_ = 0.0f;
+    maxY_ = 0.0f;
+    sceneHash_ = 0;
+    visibility_.clear();
+}
+
+void ScenePvs::reset(SceneMesh const& mesh)
+{
+    width_ = mesh.voxelsGrid.width;
+    height_ = mesh.voxelsGrid.height;
+    chunksNumber_ = mesh.voxelsChunks.count();
+    wordsPerCell_ = (chunksNumber_ + 63) / 64;
+    minY_ = FLT_MAX;
+    maxY_ = -FLT_MAX;
+    for (auto const& voxelsChunk : mesh.voxelsChunks)
+    {
+        minY_ = qMin(minY_, voxelsChunk.boundsMin.y);
+        maxY_ = qMax(maxY_, voxelsChunk.boundsMax.y);
+    }
+    if (mesh.voxelsChunks.isEmpty())
+    { minY_ = maxY_ = 0.0f; }
+    sceneHash_ = sceneHash(mesh);
+    visibility_.fill(0, cellsNumber() * wordsPerCell_);
+}
+
+int ScenePvs::visibleChunksNumber(int cellIndex) const
+{
+    int visibleChunksNumber = 0;
+    for (int chunkIndex = 0; chunkIndex < static_cast<int>(chunksNumber_); ++chunkIndex)
+    {
+        if (isVisible(cellIndex, chunkIndex))
+        { ++visibleChunksNumber; }
+    }
+    return visibleChunksNumber;
+}
+
+int ScenePvs::cellIndex(SceneVoxelsGrid const& voxelsGrid, float x, float y, float z) const
+{
+    if (isEmpty() || voxelsGrid.width != width_ || voxelsGrid.height != height_ || y < minY_ || y > maxY_)
+    { return -1; }
+    auto voxelX = voxelsGrid.voxelX(x);
+    auto voxelY = voxelsGrid.voxelY(z);
+    if (voxelX < 0 || voxelX >= width_ || voxelY < 0 || voxelY >= height_)
+    { return -1; }
+    return voxelY * width_ + voxelX;
+}
+
+uint64_t ScenePvs::sceneHash(SceneMesh const& mesh)
+{
+    uint16_t gridSize[] = {mesh.voxelsGrid.width, mesh.voxelsGrid.height};
+    auto hash = DumpCatalog::hash(gridSize, sizeof(gridSize));
+    auto fullDetailVerticesNumber = qMin(mesh.polygonsSources.count() * 4, mesh.vertices.count());
+    for (int vertexIndex = 0; vertexIndex < fullDetailVerticesNumber; ++vertexIndex)
+    {
+        auto const& position = mesh.vertices[vertexIndex].pos;
+        hash = DumpCatalog::hash(&position, sizeof(position), hash);
+    }
+    return hash;
+}
+
+void ScenePvs::load(QString const& filePath)
+{
+    clear();
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly))
+    { throw QString("Could not open file %1.").arg(filePath); }
+    auto header = file.read(HEADER_SIZE);
+    if (header.size() != static_cast<int>(HEADER_SIZE) || !header.startsWith(MAGIC.left(5)))
+    { throw QString("File %1 is not a PVS file.").arg(filePath); }
+    if (!header.startsWith(MAGIC))
+    { throw QString("PVS file %1 is from an older version, rebuild it with PvsBuilder.").arg(filePath); }
+    auto const* headerData = header.constData();
+    uint16_t width;
+    uint16_t height;
+    uint32_t chunksNumber;
+    std::memcpy(&width, headerData + 8, 2);
+    std::memcpy(&height, headerData + 10, 2);
+    std::memcpy(&chunksNumber, headerData + 12, 4);
+    std::memcpy(&minY_, headerData + 16, 4);
+    std::memcpy(&maxY_, headerData + 20, 4);
+    std::memcpy(&sceneHash_, headerData + 24, 8);
+    int wordsPerCell = (chunksNumber + 63) / 64;
+    auto visibilitySize = static_cast<qint64>(width) * height * wordsPerCell * sizeof(uint64_t);
+    if (file.size() != HEADER_SIZE + visibilitySize)
+    {
+        clear();
+        throw QString("PVS file %1 is damaged.").arg(filePath);
+    }
+    width_ = width;
+    height_ = height;
+    chunksNumber_ = chunksNumber;
+    wordsPerCell_ = wordsPerCell;
+    visibility_.resize(cellsNumber() * wordsPerCell_);
+    if (file.read(reinterpret_cast<char*>(visibility_.data()), visibilitySize) != visibilitySize)
+    {
+        clear();
+        throw QString("Could not read file %1.").arg(filePath);
+    }
+}
+
+void ScenePvs::save(QString const& filePath) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QFile::WriteOnly))
+    { throw QString("Could not open file %1 for writing.").arg(filePath); }
+    QByteArray header(HEADER_SIZE, '\0');
+    auto* headerData = header.data();
+    std::memcpy(headerData, MAGIC.constData(), MAGIC.size());
+    std::memcpy(headerData + 8, &width_, 2);
+    std::memcpy(headerData + 10, &height_, 2);
+    std::memcpy(headerData + 12, &chunksNumber_, 4);
+    std::memcpy(headerData + 16, &minY_, 4);
+    std::memcpy(headerData + 20, &maxY_, 4);
+    std::memcpy(headerData + 24, &sceneHash_, 8);
+    file.write(header);
+    file.write(
+                reinterpret_cast<char const*>(visibility_.constData()),
+                visibility_.count() * sizeof(uint64_t));
+    if (!file.commit())
+    { throw QString("Could not write file %1.").arg(filePath); }
+}
@@ -0,0 +1,69 @@
+#ifndef SCENEPVS_HPP
+#define SCENEPVS_HPP
+
+#include "SceneMesh.hpp"
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+// Potentially visible set of a scene: for every voxel cell, the voxels chunks which can be seen from
+// somewhere inside it. Cells span the height of the scene geometry; a camera above or below it, or
+// outside the grid, is not covered and sees everything. Stored in a cache file next to the dump and
+// tied to the scene it was computed for by a hash of the mesh.
+//
+// File layout, little endian: magic, grid width (u16), grid height (u16), chunks number (u32),
+// min y (f32), max y (f32), scene hash (u64), then one bit per chunk for every cell, in 64 bit words.
+class ScenePvs
+{
+public:
+    static QByteArray const MAGIC;
+    static QString const FILE_SUFFIX;
+    static constexpr uint32_t const HEADER_SIZE = 8 + 2 + 2 + 4 + 4 + 4 + 8;
+
+    ScenePvs();
+
+    bool isEmpty() const
+    { return visibility_.isEmpty(); }
+    void reset(SceneMesh const& mesh);
+    void clear();
+    uint64_t sceneHash() const
+    { return sceneHash_; }
+    int cellsNumber() const
+    { return width_ * height_; }
+    int chunksNumber() const
+    { return chunksNumber_; }
+    float minY() const
+    { return minY_; }
+    float maxY() const
+    { return maxY_; }
+    // Cells are written by one thread each, so a PVS can be filled in parallel.
+    void setVisible(int cellIndex, int chunkIndex)
+    { visibility_[cellIndex * wordsPerCell_ + chunkIndex / 64] |= uint64_t(1) << (chunkIndex % 64); }
+    bool isVisible(int cellIndex, int chunkIndex) const
+    { return (visibility_[cellIndex * wordsPerCell_ + chunkIndex / 64] >> (chunkIndex % 64)) & 1; }
+    int visibleChunksNumber(int cellIndex) const;
+    size_t memorySize() const
+    { return visibility_.count() * sizeof(uint64_t); }
+    // Cell containing the position, -1 if the PVS does not cover it.
+    int cellIndex(SceneVoxelsGrid const& voxelsGrid, float x, float y, float z) const;
+    void load(QString const& filePath);
+    void save(QString const& filePath) const;
+
+    static QString filePath(QString const& dumpPath)
+    { return dumpPath + FILE_SUFFIX; }
+    // Hash of the grid and the full detail geometry, which is all the PVS depends on.
+    static uint64_t sceneHash(SceneMesh const& mesh);
+
+private:
+    uint16_t width_;
+    uint16_t height_;
+    uint32_t chunksNumber_;
+    int wordsPerCell_;
+    float minY_;
+    float maxY_;
+    uint64_t sceneHash_;
+    QVector<uint64_t> visibility_;
+};
+
+#endif // SCENEPVS_HPP
@@ -0,0 +1,119 @@
+#include "SceneBvh.hpp"
+#include "SceneMeshBuilder.hpp"
+#include "ScenePvsBuilder.hpp"
+#include <QtConcurrent>
+#include <numeric>
+#include <random>
+
+namespace
+{
+// Rays stop this much before their target so the target quad itself never occludes it.
+constexpr float const TARGET_EPSILON = 1e-4f;
+
+QVector3D toVector3D(SceneMeshVector3 const& vector)
+{ return QVector3D(vector.x, vector.y, vector.z); }
+
+int polygonVoxelsChunkIndex(SceneMesh const& mesh, ScenePolygonSource const& polygonSource)
+{
+    int chunkSize = SceneMeshBuilder::VOXELS_CHUNK_SIZE;
+    auto chunksWidth = (mesh.voxelsGrid.width + chunkSize - 1) / chunkSize;
+    return mesh.voxelsGrid.chunksIndices[
+            polygonSource.voxelY / chunkSize * chunksWidth + polygonSource.voxelX / chunkSize];
+}
+}
+
+void ScenePvsBuilder::build(SceneMesh const& mesh, ScenePvs& pvs, int samplesPerChunk)
+{
+    pvs.reset(mesh);
+    auto const& voxelsGrid = mesh.voxelsGrid;
+    if (pvs.isEmpty() || pvs.chunksNumber() == 0)
+    { return; }
+    // Polygon n is the quad of vertices 4n to 4n + 3.
+    auto polygonsNumber = mesh.polygonsSources.count();
+    QVector<QVector<int>> chunksPolygons(pvs.chunksNumber());
+    for (int polygonIndex = 0; polygonIndex < polygonsNumber; ++polygonIndex)
+    {
+        chunksPolygons[polygonVoxelsChunkIndex(mesh, mesh.polygonsSources[polygonIndex])].append(polygonIndex);
+    }
+    QVector<SceneBvh::Quad> occluders;
+    QVector<int> occludersChunksIndices;
+    for (int chunkIndex = 0; chunkIndex < pvs.chunksNumber(); ++chunkIndex)
+    {
+        // Alpha-tested quads, ending the range, can be seen through and occlude nothing.
+        auto const& voxelsChunk = mesh.voxelsChunks[chunkIndex];
+        for (auto index = voxelsChunk.firstOpaqueIndex;
+             index < voxelsChunk.firstOpaqueIndex + voxelsChunk.opaqueIndicesNumber
+                - voxelsChunk.alphaTestedIndicesNumber;
+             index += 6)
+        {
+            auto firstVertexIndex = mesh.opaquePolygonsIndices[index] / 4 * 4;
+            SceneBvh::Quad quad;
+            for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
+            { quad.vertices[cornerIndex] = toVector3D(mesh.vertices[firstVertexIndex + cornerIndex].pos); }
+            occluders.append(quad);
+            occludersChunksIndices.append(chunkIndex);
+        }
+    }
+    SceneBvh bvh;
+    bvh.build(occluders);
+    int chunkSize = SceneMeshBuilder::VOXELS_CHUNK_SIZE;
+    auto chunksWidth = (voxelsGrid.width + chunkSize - 1) / chunkSize;
+    auto chunksHeight = (voxelsGrid.height + chunkSize - 1) / chunkSize;
+    QVector<int> cellsIndices(pvs.cellsNumber());
+    std::iota(cellsIndices.begin(), cellsIndices.end(), 0);
+    QtConcurrent::blockingMap(cellsIndices, [&](int cellIndex) {
+        std::mt19937 randomEngine(cellIndex);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        auto voxelX = cellIndex % voxelsGrid.width;
+        auto voxelY = cellIndex / voxelsGrid.width;
+        for (auto chunkY = qMax(0, (voxelY - 1) / chunkSize);
+             chunkY <= qMin(chunksHeight - 1, (voxelY + 1) / chunkSize);
+             ++chunkY)
+        {
+            for (auto chunkX = qMax(0, (voxelX - 1) / chunkSize);
+                 chunkX <= qMin(chunksWidth - 1, (voxelX + 1) / chunkSize);
+                 ++chunkX)
+            {
+                auto chunkIndex = voxelsGrid.chunksIndices[chunkY * chunksWidth + chunkX];
+                if (chunkIndex >= 0)
+                { pvs.setVisible(cellIndex, chunkIndex); }
+            }
+        }
+        for (int chunkIndex = 0; chunkIndex < pvs.chunksNumber(); ++chunkIndex)
+        {
+            auto const& chunkPolygons = chunksPolygons.at(chunkIndex);
+            if (pvs.isVisible(cellIndex, chunkIndex) || chunkPolygons.isEmpty())
+            { continue; }
+            for (int sampleIndex = 0; sampleIndex < samplesPerChunk; ++sampleIndex)
+            {
+                QVector3D origin(
+                            voxelsGrid.originX - (voxelX + unit(randomEngine)) * voxelsGrid.voxelSize,
+                            pvs.minY() + (pvs.maxY() - pvs.minY()) * unit(randomEngine),
+                            voxelsGrid.originZ - (voxelY + unit(randomEngine)) * voxelsGrid.voxelSize);
+                auto polygonIndex = chunkPolygons[
+                        std::min<int>(unit(randomEngine) * chunkPolygons.count(), chunkPolygons.count() - 1)];
+                auto const* corners = mesh.vertices.constData() + polygonIndex * 4;
+                auto u = unit(randomEngine);
+                auto v = unit(randomEngine);
+                auto target = (toVector3D(corners[0].pos) * (1.0f - u) + toVector3D(corners[1].pos) * u)
+                        * (1.0f - v)
+                        + (toVector3D(corners[2].pos) * (1.0f - u) + toVector3D(corners[3].pos) * u) * v;
+                auto direction = target - origin;
+                auto targetDistance = direction.length();
+                if (targetDistance <= TARGET_EPSILON)
+                {
+                    pvs.setVisible(cellIndex, chunkIndex);
+                    break;
+                }
+                direction /= targetDistance;
+                SceneBvh::Hit hit;
+                if (!bvh.intersect(origin, direction, hit, targetDistance - TARGET_EPSILON)
+                        || occludersChunksIndices.at(hit.quadIndex) == chunkIndex)
+                {
+                    pvs.setVisible(cellIndex, chunkIndex);
+                    break;
+                }
+            }
+        }
+    });
+}
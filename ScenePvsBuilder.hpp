@@ -0,0 +1,22 @@
+#ifndef SCENEPVSBUILDER_HPP
+#define SCENEPVSBUILDER_HPP
+
+#include "SceneMesh.hpp"
+#include "ScenePvs.hpp"
+
+// Computes the PVS of a scene by casting rays from random points of every voxel cell, over the height
+// of the scene, to random points on the quads of every voxels chunk. A chunk is visible from a cell once
+// a ray reaches it before any opaque quad of another chunk; chunks around the cell are always visible.
+// Only full detail fully opaque quads occlude; semi-transparent and alpha-tested ones do not. Sampling
+// can miss chunks seen through small gaps, so more samples trade build time for fewer popping chunks.
+class ScenePvsBuilder
+{
+public:
+    static constexpr int const DEFAULT_SAMPLES_PER_CHUNK = 16;
+
+    ScenePvsBuilder() = delete;
+
+    static void build(SceneMesh const& mesh, ScenePvs& pvs, int samplesPerChunk = DEFAULT_SAMPLES_PER_CHUNK);
+};
+
+#endif // SCENEPVSBUILDER_HPP
@@ -0,0 +1,135 @@
+#include "SceneResidencyManager.hpp"
+
+SceneResidencyManager::SceneResidencyManager()
+    : gpuMemoryBudget_{DEFAULT_GPU_MEMORY_BUDGET},
+      cpuMemoryBudget_{DEFAULT_CPU_MEMORY_BUDGET}
+{}
+
+void SceneResidencyManager::setGpuMemoryBudget(size_t gpuMemoryBudget)
+{
+    gpuMemoryBudget_ = gpuMemoryBudget;
+    evict();
+}
+
+void SceneResidencyManager::setCpuMemoryBudget(size_t cpuMemoryBudget)
+{
+    cpuMemoryBudget_ = cpuMemoryBudget;
+    evict();
+}
+
+size_t SceneResidencyManager::residentGpuMemorySize() const
+{
+    size_t size = 0;
+    for (auto const& entry : entries_)
+    {
+        if (entry.resources->isResident())
+        { size += entry.resources->gpuMemorySize(); }
+    }
+    return size;
+}
+
+size_t SceneResidencyManager::cpuMemorySize() const
+{
+    size_t size = 0;
+    for (auto const& entry : entries_)
+    { size += entry.resources->cpuMemorySize(); }
+    return size;
+}
+
+bool SceneResidencyManager::isResident(QString const& key) const
+{
+    auto entryIndex = findEntry(key);
+    return entryIndex >= 0 && entries_[entryIndex].resources->isResident();
+}
+
+QStringList SceneResidencyManager::keys() const
+{
+    QStringList keys;
+    for (auto const& entry : entries_)
+    { keys.append(entry.key); }
+    return keys;
+}
+
+std::shared_ptr<SceneGLResources> SceneResidencyManager::insert(
+        QString const& key,
+        std::shared_ptr<SceneGLResources> resources)
+{
+    auto entryIndex = findEntry(key);
+    if (entryIndex >= 0)
+    {
+        resources->reuseVramTexture(*entries_[entryIndex].resources);
+        entries_[entryIndex].resources->release();
+        entries_.removeAt(entryIndex);
+    }
+    entries_.prepend({key, std::move(resources)});
+    evict();
+    entries_.first().resources->upload();
+    return entries_.first().resources;
+}
+
+std::shared_ptr<SceneGLResources> SceneResidencyManager::acquire(QString const& key)
+{
+    auto entryIndex = findEntry(key);
+    if (entryIndex < 0)
+    { return nullptr; }
+    entries_.move(entryIndex, 0);
+    evict();
+    entries_.first().resources->upload();
+    return entries_.first().resources;
+}
+
+void SceneResidencyManager::clear()
+{
+    for (auto& entry : entries_)
+    { entry.resources->release(); }
+    entries_.clear();
+}
+
+int SceneResidencyManager::findEntry(QString const& key) const
+{
+    for (int entryIndex = 0; entryIndex < entries_.count(); ++entryIndex)
+    {
+        if (entries_[entryIndex].key == key)
+        { return entryIndex; }
+    }
+    return -1;
+}
+
+void SceneResidencyManager::evict()
+{
+    if (entries_.isEmpty())
+    { return; }
+    // The front scene is about to be drawn, so its memory is reserved before any other scene.
+    auto gpuMemorySize = entries_.first().resources->gpuMemorySize();
+    auto cpuMemorySize = entries_.first().resources->cpuMemorySize();
+    for (int entryIndex = 1; entryIndex < entries_.count();)
+    {
+        auto& resources = *entries_[entryIndex].resources;
+        if (entries_[entryIndex].resources.use_count() > 1)
+        {
+            cpuMemorySize += resources.cpuMemorySize();
+            if (resources.isResident())
+            { gpuMemorySize += resources.gpuMemorySize(); }
+            ++entryIndex;
+            continue;
+        }
+        cpuMemorySize += resources.cpuMemorySize();
+        if (cpuMemorySize > cpuMemoryBudget_)
+        {
+            cpuMemorySize -= resources.cpuMemorySize();
+            resources.release();
+            entries_.removeAt(entryIndex);
+            continue;
+        }
+        if (resources.isResident())
+        {
+            gpuMemorySize += resources.gpuMemorySize();
+            if (gpuMemorySize > gpuMemoryBudget_)
+            {
+                gpuMemorySize -= resources.gpuMemorySize();
+                resources.release();
+            }
+        }
+        ++entryIndex;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SCENERESIDENCYMANAGER_HPP
+#define SCENERESIDENCYMANAGER_HPP
+
+#include "SceneGLResources.hpp"
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+// Keeps scenes keyed by their source in least recently used order. Scenes exceeding the GPU budget have
+// their GPU objects released and scenes exceeding the CPU budget are forgotten. The most recently used
+// scene and scenes still referenced outside the manager, i.e. shown by some view, are never evicted.
+// All calls touching GPU objects require a context of the scenes share group to be current.
+class SceneResidencyManager
+{
+public:
+    static constexpr size_t const DEFAULT_GPU_MEMORY_BUDGET = 256 << 20;
+    static constexpr size_t const DEFAULT_CPU_MEMORY_BUDGET = 1024 << 20;
+
+    SceneResidencyManager();
+
+    size_t gpuMemoryBudget() const
+    { return gpuMemoryBudget_; }
+    void setGpuMemoryBudget(size_t gpuMemoryBudget);
+    size_t cpuMemoryBudget() const
+    { return cpuMemoryBudget_; }
+    void setCpuMemoryBudget(size_t cpuMemoryBudget);
+    size_t residentGpuMemorySize() const;
+    size_t cpuMemorySize() const;
+    bool contains(QString const& key) const
+    { return findEntry(key) >= 0; }
+    bool isResident(QString const& key) const;
+    QStringList keys() const;
+    std::shared_ptr<SceneGLResources> insert(QString const& key, std::shared_ptr<SceneGLResources> resources);
+    std::shared_ptr<SceneGLResources> acquire(QString const& key);
+    void clear();
+
+private:
+    struct Entry
+    {
+        QString key;
+        std::shared_ptr<SceneGLResources> resources;
+    };
+
+    int findEntry(QString const& key) const;
+    void evict();
+
+    QList<Entry> entries_;
+    size_t gpuMemoryBudget_;
+    size_t cpuMemoryBudget_;
+};
+
+#endif // SCENERESIDENCYMANAGER_HPP
@@ -0,0 +1,95 @@
+#include "SceneMeshBuilder.hpp"
+#include "SceneSemiTransparentOrder.hpp"
+
+SceneSemiTransparentOrder::SceneSemiTransparentOrder()
+    : isValid_{false},
+      cameraVoxelX_{0},
+      cameraVoxelY_{0}
+{}
+
+void SceneSemiTransparentOrder::invalidate()
+{
+    isValid_ = false;
+    ranges_.clear();
+}
+
+void SceneSemiTransparentOrder::update(SceneVoxelsGrid const& voxelsGrid, float cameraX, float cameraZ)
+{
+    // A camera outside the grid orders it the same as one in the nearest voxel just outside.
+    int gridWidth = voxelsGrid.width;
+    int gridHeight = voxelsGrid.height;
+    auto cameraVoxelX = qBound(-1, voxelsGrid.voxelX(cameraX), gridWidth);
+    auto cameraVoxelY = qBound(-1, voxelsGrid.voxelY(cameraZ), gridHeight);
+    if (isValid_ && cameraVoxelX == cameraVoxelX_ && cameraVoxelY == cameraVoxelY_)
+    { return; }
+    isValid_ = true;
+    cameraVoxelX_ = cameraVoxelX;
+    cameraVoxelY_ = cameraVoxelY;
+    ranges_.clear();
+    if (voxelsGrid.semiTransparentFirstIndices.isEmpty() || voxelsGrid.semiTransparentFirstIndices.last() == 0)
+    { return; }
+    for (auto distance = qMax(cameraVoxelY, gridHeight - 1 - cameraVoxelY); distance > 0; --distance)
+    {
+        if (cameraVoxelY - distance >= 0)
+        { appendRowRanges(voxelsGrid, cameraVoxelY - distance); }
+        if (cameraVoxelY + distance < gridHeight)
+        { appendRowRanges(voxelsGrid, cameraVoxelY + distance); }
+    }
+    if (cameraVoxelY >= 0 && cameraVoxelY < gridHeight)
+    { appendRowRanges(voxelsGrid, cameraVoxelY); }
+}
+
+void SceneSemiTransparentOrder::appendRowRanges(SceneVoxelsGrid const& voxelsGrid, int voxelY)
+{
+    int chunkSize = SceneMeshBuilder::VOXELS_CHUNK_SIZE;
+    int gridWidth = voxelsGrid.width;
+    auto const* firstIndices = voxelsGrid.semiTransparentFirstIndices.constData() + voxelY * gridWidth;
+    auto descendingOffset = voxelsGrid.semiTransparentFirstIndices.last();
+    // Voxels left of the camera in ascending x, split at chunk boundaries for occlusion culling.
+    auto leftEnd = qMin(cameraVoxelX_, gridWidth);
+    for (int voxelX = 0; voxelX < leftEnd; voxelX = (voxelX / chunkSize + 1) * chunkSize)
+    {
+        auto rangeEnd = qMin((voxelX / chunkSize + 1) * chunkSize, leftEnd);
+        appendRange(voxelsGrid, voxelY, voxelX, firstIndices[voxelX], firstIndices[rangeEnd]);
+    }
+    // Voxels right of the camera in descending x, taken from the descending copy of the row, where the
+    // voxels from x onwards start (row end - first index of x) indices after the row start.
+    auto rightBegin = qMax(cameraVoxelX_ + 1, 0);
+    auto rowBegin = firstIndices[0];
+    auto rowEnd = firstIndices[gridWidth];
+    for (int voxelEnd = gridWidth; voxelEnd > rightBegin; voxelEnd = (voxelEnd - 1) / chunkSize * chunkSize)
+    {
+        auto rangeBegin = qMax((voxelEnd - 1) / chunkSize * chunkSize, rightBegin);
+        auto descendingFirstIndex = descendingOffset + rowBegin + rowEnd - firstIndices[voxelEnd];
+        appendRange(
+                    voxelsGrid,
+                    voxelY,
+                    rangeBegin,
+                    descendingFirstIndex,
+                    descendingFirstIndex + firstIndices[voxelEnd] - firstIndices[rangeBegin]);
+    }
+    if (cameraVoxelX_ >= 0 && cameraVoxelX_ < gridWidth)
+    {
+        appendRange(
+                    voxelsGrid,
+                    voxelY,
+                    cameraVoxelX_,
+                    firstIndices[cameraVoxelX_],
+                    firstIndices[cameraVoxelX_ + 1]);
+    }
+}
+
+void SceneSemiTransparentOrder::appendRange(
+        SceneVoxelsGrid const& voxelsGrid,
+        int voxelY,
+        int voxelX,
+        uint32_t firstIndex,
+        uint32_t end)
+{
+    if (firstIndex == end)
+    { return; }
+    int chunkSize = SceneMeshBuilder::VOXELS_CHUNK_SIZE;
+    auto chunksWidth = (voxelsGrid.width + chunkSize - 1) / chunkSize;
+    auto voxelsChunkIndex = voxelsGrid.chunksIndices[voxelY / chunkSize * chunksWidth + voxelX / chunkSize];
+    ranges_.append({firstIndex, end - firstIndex, voxelsChunkIndex});
+}
@@ -0,0 +1,40 @@
+#ifndef SCENESEMITRANSPARENTORDER_HPP
+#define SCENESEMITRANSPARENTORDER_HPP
+
+#include "SceneMesh.hpp"
+#include <QVector>
+#include <cstdint>
+
+// Back to front order of the semi-transparent polygons of a scene, at voxel granularity. Rows are visited
+// from the farthest to the camera row and every row from both ends towards the camera voxel, so a voxel
+// is always drawn after the voxels behind it. The order only depends on the camera voxel and is rebuilt
+// only when the camera enters another one. Polygons within a voxel keep their scene order.
+class SceneSemiTransparentOrder
+{
+public:
+    struct Range
+    {
+        uint32_t firstIndex;
+        uint32_t indicesNumber;
+        int32_t voxelsChunkIndex;
+    };
+
+    SceneSemiTransparentOrder();
+
+    void update(SceneVoxelsGrid const& voxelsGrid, float cameraX, float cameraZ);
+    // Has to be called when the scene changes.
+    void invalidate();
+    QVector<Range> const& ranges() const
+    { return ranges_; }
+
+private:
+    void appendRowRanges(SceneVoxelsGrid const& voxelsGrid, int voxelY);
+    void appendRange(SceneVoxelsGrid const& voxelsGrid, int voxelY, int voxelX, uint32_t firstIndex, uint32_t end);
+
+    bool isValid_;
+    int cameraVoxelX_;
+    int cameraVoxelY_;
+    QVector<Range> ranges_;
+};
+
+#endif // SCENESEMITRANSPARENTORDER_HPP
@@ -0,0 +1,106 @@
+#include "PsxVRamConst.hpp"
+#include "SceneTextureOpacity.hpp"
+#include <QtGlobal>
+#include <cmath>
+
+SceneTextureOpacity::SceneTextureOpacity(QByteArray const& vram)
+    : vram_(vram)
+{}
+
+bool SceneTextureOpacity::isAlphaTested(SceneMeshVertex const* corners)
+{
+    if (static_cast<uint32_t>(vram_.size()) < PsxVRamConst::SIZE)
+    { return true; }
+    auto const& texpage = corners[0].texpage;
+    auto const& clut = corners[0].clut;
+    auto texpageX = static_cast<uint32_t>(texpage.x);
+    auto texpageY = static_cast<uint32_t>(texpage.y);
+    auto bpp = static_cast<uint32_t>(texpage.z);
+    auto clutX = static_cast<uint32_t>(clut.x);
+    auto clutY = static_cast<uint32_t>(clut.y);
+    if (bpp > 1)
+    { return true; }
+    if (!hasTransparentColor(clutX, clutY, bpp))
+    { return false; }
+    // Texture coordinates are whole texels within the texpage; the bounds are inclusive, so texels touched
+    // only by the far edges count as well.
+    auto minU = 255.0f;
+    auto minV = 255.0f;
+    auto maxU = 0.0f;
+    auto maxV = 0.0f;
+    for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
+    {
+        auto const& texturePos = corners[cornerIndex].texturePos;
+        minU = qMin(minU, texturePos.x);
+        minV = qMin(minV, texturePos.y);
+        maxU = qMax(maxU, texturePos.x);
+        maxV = qMax(maxV, texturePos.y);
+    }
+    auto toTexel = [](float coordinate) { return static_cast<uint32_t>(qBound(0.0f, std::floor(coordinate), 255.0f)); };
+    uint64_t footprintKey = (static_cast<uint64_t>(texpageX >> PsxVRamConst::TEXTURE_PAGE_X_SHIFT) << 50)
+            | (static_cast<uint64_t>(texpageY >> PsxVRamConst::TEXTURE_PAGE_Y_SHIFT) << 49)
+            | (static_cast<uint64_t>(bpp) << 47)
+            | (static_cast<uint64_t>(clutX >> PsxVRamConst::CLUT_X_SHIFT) << 41)
+            | (static_cast<uint64_t>(clutY) << 32)
+            | (toTexel(minU) << 24) | (toTexel(minV) << 16) | (toTexel(maxU) << 8) | toTexel(maxV);
+    auto footprintIt = footprintsTransparency_.constFind(footprintKey);
+    if (footprintIt != footprintsTransparency_.cend())
+    { return footprintIt.value(); }
+    auto isAlphaTested = hasTransparentTexel(
+                texpageX, texpageY, bpp, clutX, clutY, toTexel(minU), toTexel(minV), toTexel(maxU), toTexel(maxV));
+    footprintsTransparency_.insert(footprintKey, isAlphaTested);
+    return isAlphaTested;
+}
+
+uint16_t SceneTextureOpacity::vramPixel(uint32_t x, uint32_t y) const
+{
+    auto const* pixel = reinterpret_cast<uint8_t const*>(vram_.constData())
+            + (y * PsxVRamConst::PIXELS_PER_LINE + x) * PsxVRamConst::PIXEL_SIZE;
+    return pixel[0] | (pixel[1] << 8);
+}
+
+bool SceneTextureOpacity::hasTransparentColor(uint32_t clutX, uint32_t clutY, uint32_t bpp)
+{
+    auto clutKey = (clutY << 16) | (clutX << 1) | bpp;
+    auto clutIt = clutsTransparency_.constFind(clutKey);
+    if (clutIt != clutsTransparency_.cend())
+    { return clutIt.value(); }
+    uint32_t colorsNumber = bpp == 0 ? PsxVRamConst::CLUT_4_BPP_WIDTH : PsxVRamConst::CLUT_8_BPP_WIDTH;
+    // Colors past the end of the VRAM line are not sampled the same way by the compact texture.
+    bool hasTransparentColor = clutX + colorsNumber > PsxVRamConst::PIXELS_PER_LINE
+            || clutY >= PsxVRamConst::HEIGHT;
+    for (uint32_t colorIndex = 0; !hasTransparentColor && colorIndex < colorsNumber; ++colorIndex)
+    { hasTransparentColor = vramPixel(clutX + colorIndex, clutY) == 0; }
+    clutsTransparency_.insert(clutKey, hasTransparentColor);
+    return hasTransparentColor;
+}
+
+bool SceneTextureOpacity::hasTransparentTexel(
+        uint32_t texpageX,
+        uint32_t texpageY,
+        uint32_t bpp,
+        uint32_t clutX,
+        uint32_t clutY,
+        uint32_t minU,
+        uint32_t minV,
+        uint32_t maxU,
+        uint32_t maxV) const
+{
+    // The same decoding as the fragment shader: a VRAM pixel packs 4 or 2 CLUT indices, lowest bits first.
+    uint32_t pixelsInTexel = 1u << (2 - bpp);
+    uint32_t bitsPerColorIndex = 4u << bpp;
+    uint32_t colorMask = (1u << bitsPerColorIndex) - 1;
+    if (texpageX + maxU / pixelsInTexel >= PsxVRamConst::PIXELS_PER_LINE || texpageY + maxV >= PsxVRamConst::HEIGHT)
+    { return true; }
+    for (auto v = minV; v <= maxV; ++v)
+    {
+        for (auto u = minU; u <= maxU; ++u)
+        {
+            auto colorIndices = vramPixel(texpageX + u / pixelsInTexel, texpageY + v);
+            auto colorIndex = (colorIndices >> ((u % pixelsInTexel) * bitsPerColorIndex)) & colorMask;
+            if (vramPixel(clutX + colorIndex, clutY) == 0)
+            { return true; }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,41 @@
+#ifndef SCENETEXTUREOPACITY_HPP
+#define SCENETEXTUREOPACITY_HPP
+
+#include "SceneMesh.hpp"
+#include <QByteArray>
+#include <QHash>
+#include <cstdint>
+
+// Tells quads sampling only opaque texels from quads that may sample a transparent one, i.e. a texel whose
+// CLUT color is 0 and which the fragment shader discards. The texels are decoded the way the shader does,
+// over the bounds of the quad texture coordinates. Results are cached by texpage, CLUT and those bounds,
+// which repeat across most quads of a scene, and CLUTs without transparent colors skip the texels entirely.
+class SceneTextureOpacity
+{
+public:
+    explicit SceneTextureOpacity(QByteArray const& vram);
+
+    // Expects the 4 corners of a quad with texpage and CLUT origins in VRAM pixels, as SceneMeshBuilder
+    // writes them before SceneVRamLayout moves them. 16bpp texpages are always alpha-tested.
+    bool isAlphaTested(SceneMeshVertex const* corners);
+
+private:
+    uint16_t vramPixel(uint32_t x, uint32_t y) const;
+    bool hasTransparentColor(uint32_t clutX, uint32_t clutY, uint32_t bpp);
+    bool hasTransparentTexel(
+            uint32_t texpageX,
+            uint32_t texpageY,
+            uint32_t bpp,
+            uint32_t clutX,
+            uint32_t clutY,
+            uint32_t minU,
+            uint32_t minV,
+            uint32_t maxU,
+            uint32_t maxV) const;
+
+    QByteArray vram_;
+    QHash<uint32_t, bool> clutsTransparency_;
+    QHash<uint64_t, bool> footprintsTransparency_;
+};
+
+#endif // SCENETEXTUREOPACITY_HPP
@@ -0,0 +1,178 @@
+#include "GpuTypes.hpp"
+#include "SceneVRamLayout.hpp"
+#include <QMap>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+constexpr int const TEXPAGE_COLUMNS_PER_LINE = PsxVRamConst::PIXELS_PER_LINE / SceneVRamLayout::TEXPAGE_COLUMN_WIDTH;
+constexpr int const TEXPAGE_LINES = PsxVRamConst::HEIGHT / PsxVRamConst::TEXTURE_PAGE_HEIGHT;
+
+struct ClutSegment
+{
+    int begin;
+    int end;
+    int rectIndex;
+};
+
+int texpageWidth(GpuTexpageBpp bpp)
+{
+    switch (bpp)
+    {
+    case GpuTexpageBpp::BPP_4:
+        return PsxVRamConst::TEXTURE_4BPP_PAGE_WIDTH;
+    case GpuTexpageBpp::BPP_8:
+        return PsxVRamConst::TEXTURE_8BPP_PAGE_WIDTH;
+    default:
+        return PsxVRamConst::TEXTURE_16BPP_PAGE_WIDTH;
+    }
+}
+
+// The fragment shader looks up the CLUT for 15 bpp texpages as well, so they get the 8 bpp width.
+int clutWidth(GpuTexpageBpp bpp)
+{ return bpp == GpuTexpageBpp::BPP_4 ? PsxVRamConst::CLUT_4_BPP_WIDTH : PsxVRamConst::CLUT_8_BPP_WIDTH; }
+}
+
+void SceneVRamLayout::build(SceneMesh& mesh)
+{
+    mesh.vramRects.clear();
+    bool usedTexpageColumns[TEXPAGE_LINES][TEXPAGE_COLUMNS_PER_LINE] = {};
+    QMap<int, QVector<ClutSegment>> clutSegments;
+    // The 4 vertices of a quad share texpage and CLUT.
+    for (int vertexIndex = 0; vertexIndex < mesh.vertices.count(); vertexIndex += 4)
+    {
+        auto const& vertex = mesh.vertices[vertexIndex];
+        auto bpp = static_cast<GpuTexpageBpp>(static_cast<int>(vertex.texpage.z));
+        int texpageX = vertex.texpage.x;
+        int texpageLine = static_cast<int>(vertex.texpage.y) / PsxVRamConst::TEXTURE_PAGE_HEIGHT;
+        int lastColumn = qMin(
+                    TEXPAGE_COLUMNS_PER_LINE,
+                    (texpageX + texpageWidth(bpp) + TEXPAGE_COLUMN_WIDTH - 1) / TEXPAGE_COLUMN_WIDTH);
+        for (int column = texpageX / TEXPAGE_COLUMN_WIDTH; column < lastColumn; ++column)
+        { usedTexpageColumns[texpageLine][column] = true; }
+        int clutX = vertex.clut.x;
+        clutSegments[static_cast<int>(vertex.clut.y)].append(
+                    {clutX, qMin(static_cast<int>(PsxVRamConst::PIXELS_PER_LINE), clutX + clutWidth(bpp)), -1});
+    }
+
+    int texpageColumnRects[TEXPAGE_LINES][TEXPAGE_COLUMNS_PER_LINE];
+    int shelfX = 0;
+    int shelfY = 0;
+    int textureWidth = 0;
+    for (int line = 0; line < TEXPAGE_LINES; ++line)
+    {
+        for (int column = 0; column < TEXPAGE_COLUMNS_PER_LINE;)
+        {
+            if (!usedTexpageColumns[line][column])
+            {
+                ++column;
+                continue;
+            }
+            int firstColumn = column;
+            while (column < TEXPAGE_COLUMNS_PER_LINE && usedTexpageColumns[line][column])
+            { texpageColumnRects[line][column++] = mesh.vramRects.count(); }
+            int width = (column - firstColumn) * TEXPAGE_COLUMN_WIDTH;
+            if (shelfX + width > MAX_TEXTURE_WIDTH)
+            {
+                shelfX = 0;
+                shelfY += PsxVRamConst::TEXTURE_PAGE_HEIGHT;
+            }
+            mesh.vramRects.append({
+                        static_cast<uint16_t>(firstColumn * TEXPAGE_COLUMN_WIDTH),
+                        static_cast<uint16_t>(line * PsxVRamConst::TEXTURE_PAGE_HEIGHT),
+                        static_cast<uint16_t>(width),
+                        PsxVRamConst::TEXTURE_PAGE_HEIGHT,
+                        static_cast<uint16_t>(shelfX),
+                        static_cast<uint16_t>(shelfY)});
+            shelfX += width;
+            textureWidth = qMax(textureWidth, shelfX);
+        }
+    }
+    int textureHeight = mesh.vramRects.isEmpty() ? 0 : shelfY + PsxVRamConst::TEXTURE_PAGE_HEIGHT;
+
+    int maxSegmentWidth = 0;
+    for (auto& lineSegments : clutSegments)
+    {
+        std::sort(lineSegments.begin(), lineSegments.end(), [](ClutSegment const& one, ClutSegment const& other) {
+            return one.begin < other.begin;
+        });
+        QVector<ClutSegment> mergedSegments;
+        for (auto const& segment : lineSegments)
+        {
+            if (!mergedSegments.isEmpty() && segment.begin <= mergedSegments.last().end)
+            { mergedSegments.last().end = qMax(mergedSegments.last().end, segment.end); }
+            else
+            { mergedSegments.append(segment); }
+            maxSegmentWidth = qMax(maxSegmentWidth, mergedSegments.last().end - mergedSegments.last().begin);
+        }
+        lineSegments = mergedSegments;
+    }
+    textureWidth = qMax(textureWidth, maxSegmentWidth);
+    int lineX = textureWidth;
+    int lineY = textureHeight - 1;
+    for (auto lineSegmentsIt = clutSegments.begin(); lineSegmentsIt != clutSegments.end(); ++lineSegmentsIt)
+    {
+        for (auto& segment : lineSegmentsIt.value())
+        {
+            int width = segment.end - segment.begin;
+            if (lineX + width > textureWidth)
+            {
+                lineX = 0;
+                ++lineY;
+            }
+            segment.rectIndex = mesh.vramRects.count();
+            mesh.vramRects.append({
+                        static_cast<uint16_t>(segment.begin),
+                        static_cast<uint16_t>(lineSegmentsIt.key()),
+                        static_cast<uint16_t>(width),
+                        PsxVRamConst::CLUT_HEIGHT,
+                        static_cast<uint16_t>(lineX),
+                        static_cast<uint16_t>(lineY)});
+            lineX += width;
+        }
+    }
+    mesh.vramTextureWidth = textureWidth;
+    mesh.vramTextureHeight = lineY + 1;
+
+    for (int vertexIndex = 0; vertexIndex < mesh.vertices.count(); vertexIndex += 4)
+    {
+        auto const& vertex = mesh.vertices[vertexIndex];
+        int texpageX = vertex.texpage.x;
+        int texpageY = vertex.texpage.y;
+        auto const& texpageRect = mesh.vramRects[
+                texpageColumnRects[texpageY / PsxVRamConst::TEXTURE_PAGE_HEIGHT][texpageX / TEXPAGE_COLUMN_WIDTH]];
+        int clutX = vertex.clut.x;
+        int clutY = vertex.clut.y;
+        auto const& lineSegments = clutSegments[clutY];
+        auto segmentIt = std::find_if(lineSegments.begin(), lineSegments.end(), [clutX](ClutSegment const& segment) {
+            return clutX >= segment.begin && clutX < segment.end;
+        });
+        auto const& clutRect = mesh.vramRects[segmentIt->rectIndex];
+        SceneMeshVector2 texpageOrigin{
+            static_cast<float>(texpageRect.textureX + texpageX - texpageRect.x),
+            static_cast<float>(texpageRect.textureY + texpageY - texpageRect.y)};
+        SceneMeshVector2 clutOrigin{
+            static_cast<float>(clutRect.textureX + clutX - clutRect.x),
+            static_cast<float>(clutRect.textureY)};
+        for (int quadVertexIndex = vertexIndex; quadVertexIndex < vertexIndex + 4; ++quadVertexIndex)
+        {
+            auto& quadVertex = mesh.vertices[quadVertexIndex];
+            quadVertex.texpage.x = texpageOrigin.x;
+            quadVertex.texpage.y = texpageOrigin.y;
+            quadVertex.clut = clutOrigin;
+        }
+    }
+}
+
+bool SceneVRamLayout::isRectEqual(QByteArray const& vram, QByteArray const& otherVRam, SceneVRamRect const& rect)
+{
+    auto lineSize = rect.width * PsxVRamConst::PIXEL_SIZE;
+    for (int y = rect.y; y < rect.y + rect.height; ++y)
+    {
+        auto offset = (y * PsxVRamConst::PIXELS_PER_LINE + rect.x) * PsxVRamConst::PIXEL_SIZE;
+        if (std::memcmp(vram.constData() + offset, otherVRam.constData() + offset, lineSize) != 0)
+        { return false; }
+    }
+    return true;
+}
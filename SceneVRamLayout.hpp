@@ -0,0 +1,25 @@
+#ifndef SCENEVRAMLAYOUT_HPP
+#define SCENEVRAMLAYOUT_HPP
+
+#include "PsxVRamConst.hpp"
+#include "SceneMesh.hpp"
+#include <QByteArray>
+
+// Packs the VRAM areas referenced by the texpages and CLUTs of a mesh into a compact texture.
+// Texpages are kept as runs of 64 pixel wide columns, CLUTs as runs of pixels within a VRAM line, so
+// texture coordinates stay linear inside every rectangle and only the origins in the vertices move.
+class SceneVRamLayout
+{
+public:
+    static constexpr uint16_t const TEXPAGE_COLUMN_WIDTH = PsxVRamConst::TEXTURE_4BPP_PAGE_WIDTH;
+    static constexpr uint16_t const MAX_TEXTURE_WIDTH = PsxVRamConst::PIXELS_PER_LINE;
+
+    SceneVRamLayout() = delete;
+
+    // Expects vertex texpage and CLUT origins in VRAM pixels, as SceneMeshBuilder writes them, and moves
+    // them into the compact texture described by mesh.vramRects.
+    static void build(SceneMesh& mesh);
+    static bool isRectEqual(QByteArray const& vram, QByteArray const& otherVRam, SceneVRamRect const& rect);
+};
+
+#endif // SCENEVRAMLAYOUT_HPP
@@ -0,0 +1,338 @@
+#include "ADSceneConst.hpp"
+#include "PsxVRamConst.hpp"
+#include "SyntheticSceneGenerator.hpp"
+#include <QString>
+#include <algorithm>
+#include <cstring>
+
+static constexpr PsxRamAddress::Raw const FIRST_TABLE_ADDRESS = 0x80090000;
+static constexpr PsxRamAddress::Raw const RAM_END_ADDRESS = PsxRamConst::KSEG0_ADDRESS + PsxRamConst::SIZE;
+static constexpr uint8_t const FIRST_TEXTURE_PAGE_X = 5;
+static constexpr uint8_t const TEXTURE_PAGES_X_NUMBER = 16;
+static constexpr uint8_t const TEXTURE_PAGES_Y_NUMBER = 2;
+static constexpr uint16_t const FIRST_CLUT_Y = 480;
+static constexpr uint8_t const CLUTS_PER_LINE = 4;
+static constexpr uint8_t const CLUT_LINES_NUMBER = PsxVRamConst::HEIGHT - FIRST_CLUT_Y;
+static constexpr uint8_t const TEXTURE_TILE_SIZE = 32;
+static constexpr uint8_t const TEXTURE_TILES_PER_LINE = PsxVRamConst::TEXTURE_PAGE_SIZE / TEXTURE_TILE_SIZE;
+
+SyntheticSceneGenerator::SyntheticSceneGenerator(Parameters const& parameters)
+    : parameters_(parameters),
+      randomGenerator_(parameters.seed),
+      log2VoxelsWidth_{log2Ceil(parameters.voxelsWidth)},
+      log2VoxelsHeight_{log2Ceil(parameters.voxelsHeight)},
+      rectanglesNumber_{0},
+      descriptorsListsNumber_{0},
+      statistics_{}
+{ validateParameters(); }
+
+uint8_t SyntheticSceneGenerator::log2Ceil(uint16_t value)
+{
+    uint8_t log2 = 0;
+    while (valuesInBits(log2) < value)
+    { ++log2; }
+    return log2;
+}
+
+void SyntheticSceneGenerator::validateParameters() const
+{
+    if (parameters_.voxelsWidth == 0 || parameters_.voxelsHeight == 0)
+    { throw QString("Voxels grid size must not be empty."); }
+    if (parameters_.voxelsWidth > 0x8000 || parameters_.voxelsHeight > 0x8000)
+    { throw QString("Voxels grid size %1x%2 is too big.").arg(parameters_.voxelsWidth).arg(parameters_.voxelsHeight); }
+    if (parameters_.minPolygonsPerVoxel == 0 || parameters_.minPolygonsPerVoxel > parameters_.maxPolygonsPerVoxel)
+    {
+        throw QString("Invalid polygons per voxel range %1..%2.")
+                .arg(parameters_.minPolygonsPerVoxel)
+                .arg(parameters_.maxPolygonsPerVoxel);
+    }
+    if (parameters_.verticesNumber < 4 || parameters_.verticesNumber > ADSceneConst::MAX_VERTICES_NUMBER)
+    {
+        throw QString("Vertices number %1 is outside of range 4..%2.")
+                .arg(parameters_.verticesNumber)
+                .arg(ADSceneConst::MAX_VERTICES_NUMBER);
+    }
+    uint32_t const maxTexpagesNumber = (TEXTURE_PAGES_X_NUMBER - FIRST_TEXTURE_PAGE_X) * TEXTURE_PAGES_Y_NUMBER;
+    if (parameters_.texpagesNumber == 0 || parameters_.texpagesNumber > maxTexpagesNumber)
+    { throw QString("Texpages number %1 is outside of range 1..%2.").arg(parameters_.texpagesNumber).arg(maxTexpagesNumber); }
+    uint32_t const maxClutsNumber = CLUTS_PER_LINE * CLUT_LINES_NUMBER;
+    if (parameters_.clutsNumber == 0 || parameters_.clutsNumber > maxClutsNumber)
+    { throw QString("CLUTs number %1 is outside of range 1..%2.").arg(parameters_.clutsNumber).arg(maxClutsNumber); }
+}
+
+QByteArray SyntheticSceneGenerator::generateDump()
+{
+    auto psxRam = std::make_unique<BufferedPsxRam>();
+    QByteArray psxVRam;
+    generate(*psxRam, psxVRam);
+    QByteArray dump(PsxRamConst::SIZE + PsxVRamConst::SIZE, 0);
+    psxRam->dump(dump.data());
+    std::memcpy(dump.data() + PsxRamConst::SIZE, psxVRam.constData(), PsxVRamConst::SIZE);
+    return dump;
+}
+
+void SyntheticSceneGenerator::generate(BufferedPsxRam& psxRam, QByteArray& psxVRam)
+{
+    randomGenerator_.seed(parameters_.seed);
+    statistics_ = Statistics{};
+    nextFreeAddress_ = FIRST_TABLE_ADDRESS;
+    rectanglesNumber_ = parameters_.verticesNumber / 4;
+    psxRam.clear();
+    psxRam.writeRegion(
+                {PsxRamConst::KSEG0_ADDRESS, static_cast<uint32_t>(PsxRamConst::PSX_RAM_PATTERN.size())},
+                reinterpret_cast<uint8_t const*>(PsxRamConst::PSX_RAM_PATTERN.constData()));
+    chooseTexpages();
+    chooseCluts();
+    planVoxels();
+    auto verticesAddress = allocate(rectanglesNumber_ * 4 * sizeof(AD::Point3D));
+    auto voxelsAddress = allocate(voxels_.size() * sizeof(AD::Voxel));
+    auto descriptorsAddresses = allocate((descriptorsListsNumber_ + 1) * sizeof(PsxRamAddress::Raw));
+    writeVertices(psxRam, verticesAddress);
+    writeVoxels(psxRam, voxelsAddress);
+    writePolygonsDescriptorsLists(psxRam, descriptorsAddresses);
+    writeHeader(psxRam, voxelsAddress, descriptorsAddresses, verticesAddress);
+    psxVRam = QByteArray(PsxVRamConst::SIZE, 0);
+    writeTexpages(psxVRam);
+    writeCluts(psxVRam);
+    statistics_.descriptorsListsNumber = descriptorsListsNumber_;
+    statistics_.verticesNumber = rectanglesNumber_ * 4;
+    statistics_.usedRamSize = nextFreeAddress_.raw() - FIRST_TABLE_ADDRESS;
+}
+
+PsxRamAddress SyntheticSceneGenerator::allocate(uint32_t size)
+{
+    auto address = nextFreeAddress_;
+    uint32_t alignedSize = (size + 3) & ~3u;
+    if (alignedSize > RAM_END_ADDRESS - address.raw())
+    {
+        throw QString("Generated scene does not fit in PSX RAM (allocation of 0x%1 bytes at 0x%2).")
+                .arg(size, 0, 16)
+                .arg(address.raw(), 0, 16);
+    }
+    nextFreeAddress_ += alignedSize;
+    return address;
+}
+
+uint32_t SyntheticSceneGenerator::randomInRange(uint32_t min, uint32_t max)
+{ return std::uniform_int_distribution<uint32_t>(min, max)(randomGenerator_); }
+
+bool SyntheticSceneGenerator::randomChance(float ratio)
+{ return std::uniform_real_distribution<float>(0.0f, 1.0f)(randomGenerator_) < ratio; }
+
+void SyntheticSceneGenerator::chooseTexpages()
+{
+    QVector<GpuTexpage> candidates;
+    for (uint8_t y = 0; y < TEXTURE_PAGES_Y_NUMBER; ++y)
+    {
+        for (uint8_t x = FIRST_TEXTURE_PAGE_X; x < TEXTURE_PAGES_X_NUMBER; ++x)
+        {
+            GpuTexpage texpage{};
+            texpage.x = x;
+            texpage.y = y;
+            texpage.texpageBpp = static_cast<uint16_t>(GpuTexpageBpp::BPP_4);
+            candidates.append(texpage);
+        }
+    }
+    std::shuffle(candidates.begin(), candidates.end(), randomGenerator_);
+    texpages_ = candidates.mid(0, parameters_.texpagesNumber);
+}
+
+void SyntheticSceneGenerator::chooseCluts()
+{
+    cluts_.clear();
+    for (uint16_t clutIndex = 0; clutIndex < parameters_.clutsNumber; ++clutIndex)
+    {
+        GpuClut clut{};
+        clut.x = clutIndex % CLUTS_PER_LINE;
+        clut.y = FIRST_CLUT_Y + clutIndex / CLUTS_PER_LINE;
+        cluts_.append(clut);
+    }
+}
+
+void SyntheticSceneGenerator::writeVertices(BufferedPsxRam& psxRam, PsxRamAddress verticesAddress)
+{
+    static constexpr int16_t const HALF_SIZE = ADSceneConst::HALF_VOXEL_SIZE;
+    auto* vertexIt = psxRam.writeAsPointer<AD::Point3D>(verticesAddress);
+    for (uint32_t rectangleIndex = 0; rectangleIndex < rectanglesNumber_; ++rectangleIndex)
+    {
+        auto orientation = static_cast<uint8_t>(randomInRange(0, 2));
+        auto plane = static_cast<int16_t>(randomInRange(0, 2 * HALF_SIZE)) - HALF_SIZE;
+        auto u = static_cast<int16_t>(randomInRange(0, HALF_SIZE)) - HALF_SIZE;
+        auto v = static_cast<int16_t>(randomInRange(0, HALF_SIZE)) - HALF_SIZE;
+        auto uSize = static_cast<int16_t>(randomInRange(HALF_SIZE / 4, HALF_SIZE));
+        auto vSize = static_cast<int16_t>(randomInRange(HALF_SIZE / 4, HALF_SIZE));
+        *vertexIt++ = randomRectangleCorner(orientation, plane, u, v);
+        *vertexIt++ = randomRectangleCorner(orientation, plane, u + uSize, v);
+        *vertexIt++ = randomRectangleCorner(orientation, plane, u, v + vSize);
+        *vertexIt++ = randomRectangleCorner(orientation, plane, u + uSize, v + vSize);
+    }
+}
+
+AD::Point3D SyntheticSceneGenerator::randomRectangleCorner(
+        uint8_t orientation,
+        int16_t plane,
+        int16_t u,
+        int16_t v) const
+{
+    AD::Point3D corner{};
+    switch (orientation)
+    {
+    case 0:
+        corner.x = u;
+        corner.y = v;
+        corner.z = plane;
+        break;
+    case 1:
+        corner.x = plane;
+        corner.y = u;
+        corner.z = v;
+        break;
+    default:
+        corner.x = u;
+        corner.y = plane;
+        corner.z = v;
+        break;
+    }
+    return corner;
+}
+
+void SyntheticSceneGenerator::planVoxels()
+{
+    voxels_.fill(AD::Voxel{}, valuesInBits(log2VoxelsWidth_) * parameters_.voxelsHeight);
+    descriptorsListsNumber_ = 0;
+    for (uint16_t voxelY = 0; voxelY < parameters_.voxelsHeight; ++voxelY)
+    {
+        auto* voxelIt = voxels_.data() + (voxelY << log2VoxelsWidth_);
+        for (uint16_t voxelX = 0; voxelX < parameters_.voxelsWidth; ++voxelX, ++voxelIt)
+        {
+            if (!randomChance(parameters_.filledVoxelsRatio))
+            { continue; }
+            ++statistics_.filledVoxelsNumber;
+            bool reuseList =
+                    descriptorsListsNumber_ == ADSceneConst::MAX_POLYGONS_DESCRIPTORS_INDEX ||
+                    (descriptorsListsNumber_ > 0 && randomChance(parameters_.descriptorsListsReuseRatio));
+            voxelIt->polygonsDescriptorsIndex = reuseList ?
+                        randomInRange(1, descriptorsListsNumber_) :
+                        ++descriptorsListsNumber_;
+            voxelIt->flags_ = randomInRange(0, 3);
+        }
+    }
+}
+
+void SyntheticSceneGenerator::writeVoxels(BufferedPsxRam& psxRam, PsxRamAddress voxelsAddress)
+{
+    psxRam.writeRegion(
+                {voxelsAddress, static_cast<uint32_t>(voxels_.size() * sizeof(AD::Voxel))},
+                reinterpret_cast<uint8_t const*>(voxels_.constData()));
+}
+
+void SyntheticSceneGenerator::writePolygonsDescriptorsLists(
+        BufferedPsxRam& psxRam,
+        PsxRamAddress descriptorsAddresses)
+{
+    psxRam.writeAddress(descriptorsAddresses, PsxRamAddress::ZERO);
+    for (uint16_t listIndex = 1; listIndex <= descriptorsListsNumber_; ++listIndex)
+    {
+        psxRam.writeAddress(
+                    descriptorsAddresses + static_cast<uint32_t>(listIndex * sizeof(PsxRamAddress::Raw)),
+                    writePolygonsDescriptorsList(psxRam));
+    }
+}
+
+PsxRamAddress SyntheticSceneGenerator::writePolygonsDescriptorsList(BufferedPsxRam& psxRam)
+{
+    auto polygonsNumber = randomInRange(parameters_.minPolygonsPerVoxel, parameters_.maxPolygonsPerVoxel);
+    auto listAddress = allocate(polygonsNumber * sizeof(AD::PolygonDescriptor));
+    auto* polygonDescriptorIt = psxRam.writeAsPointer<AD::PolygonDescriptor>(listAddress);
+    for (uint32_t polygonIndex = 0; polygonIndex < polygonsNumber; ++polygonIndex)
+    { *polygonDescriptorIt++ = randomPolygonDescriptor(polygonIndex + 1 == polygonsNumber); }
+    statistics_.polygonsNumber += polygonsNumber;
+    return listAddress;
+}
+
+AD::PolygonDescriptor SyntheticSceneGenerator::randomPolygonDescriptor(bool isLastPolygon)
+{
+    static constexpr uint8_t const TILE_END = TEXTURE_TILE_SIZE - 1;
+    AD::PolygonDescriptor polygonDescriptor;
+    std::memset(&polygonDescriptor, 0, sizeof(polygonDescriptor));
+    uint16_t firstVertexIndex = randomInRange(0, rectanglesNumber_ - 1) * 4;
+    polygonDescriptor.vertex1Index = firstVertexIndex + 0;
+    polygonDescriptor.vertex2Index = firstVertexIndex + 1;
+    polygonDescriptor.vertex3Index = firstVertexIndex + 2;
+    polygonDescriptor.vertex4Index = firstVertexIndex + 3;
+    uint8_t u = randomInRange(0, TEXTURE_TILES_PER_LINE - 1) * TEXTURE_TILE_SIZE;
+    uint8_t v = randomInRange(0, TEXTURE_TILES_PER_LINE - 1) * TEXTURE_TILE_SIZE;
+    polygonDescriptor.texCoord1 = {u, v};
+    polygonDescriptor.texCoord2AndTexPage.fields.texCoord2 = {static_cast<uint8_t>(u + TILE_END), v};
+    polygonDescriptor.texCoord3 = {u, static_cast<uint8_t>(v + TILE_END)};
+    polygonDescriptor.texCoord4 = {static_cast<uint8_t>(u + TILE_END), static_cast<uint8_t>(v + TILE_END)};
+    polygonDescriptor.texCoord2AndTexPage.fields.texpage = texpages_[randomInRange(0, texpages_.size() - 1)];
+    polygonDescriptor.clut = cluts_[randomInRange(0, cluts_.size() - 1)];
+    polygonDescriptor.flags.lsb.fields.someSize = 1;
+    polygonDescriptor.flags.lsb.fields.nextPolygonOffset = 0;
+    polygonDescriptor.flags.semiTransparencyFlag_ = randomChance(parameters_.semiTransparentRatio) ? 1 : 0;
+    polygonDescriptor.flags.lastPolygonFlag_ = isLastPolygon ? 1 : 0;
+    return polygonDescriptor;
+}
+
+void SyntheticSceneGenerator::writeHeader(
+        BufferedPsxRam& psxRam,
+        PsxRamAddress voxelsAddress,
+        PsxRamAddress descriptorsAddresses,
+        PsxRamAddress verticesAddress)
+{
+    psxRam.writeAddress(ADSceneConst::VOXELS_ADDRESS_POINTER, voxelsAddress);
+    psxRam.writeAddress(ADSceneConst::POLYGONS_DESCRIPTORS_ADDRESSES_POINTER, descriptorsAddresses);
+    psxRam.writeAddress(ADSceneConst::VERTICES_ADDRESS_POINTER, verticesAddress);
+    psxRam.writeWord(ADSceneConst::LOG2_VOXELS_WIDTH_ADDRESS, log2VoxelsWidth_);
+    psxRam.writeWord(ADSceneConst::LOG2_VOXELS_HEIGHT_ADDRESS, log2VoxelsHeight_);
+    psxRam.writeWord(ADSceneConst::MAX_VOXEL_X_ADDRESS, parameters_.voxelsWidth - 1);
+    psxRam.writeWord(ADSceneConst::MAX_VOXEL_Y_ADDRESS, parameters_.voxelsHeight - 1);
+}
+
+void SyntheticSceneGenerator::writeTexpages(QByteArray& psxVRam)
+{
+    for (auto const& texpage : texpages_)
+    {
+        uint16_t firstX = texpage.x << PsxVRamConst::TEXTURE_PAGE_X_SHIFT;
+        uint16_t firstY = texpage.y << PsxVRamConst::TEXTURE_PAGE_Y_SHIFT;
+        auto tileColorSeed = static_cast<uint8_t>(randomInRange(0, 0xf));
+        for (uint16_t y = 0; y < PsxVRamConst::TEXTURE_PAGE_HEIGHT; ++y)
+        {
+            for (uint16_t x = 0; x < PsxVRamConst::TEXTURE_4BPP_PAGE_WIDTH; ++x)
+            {
+                uint16_t colorIndices = 0;
+                for (uint8_t pixelIndex = 0; pixelIndex < 4; ++pixelIndex)
+                {
+                    uint16_t u = x * 4 + pixelIndex;
+                    bool isBorder = (u % TEXTURE_TILE_SIZE) == 0 || (y % TEXTURE_TILE_SIZE) == 0;
+                    uint8_t colorIndex = isBorder ?
+                                0xf :
+                                1 + ((tileColorSeed + u / TEXTURE_TILE_SIZE + y / TEXTURE_TILE_SIZE) % 0xe);
+                    colorIndices |= colorIndex << (pixelIndex * 4);
+                }
+                writeVRamPixel(psxVRam, firstX + x, firstY + y, colorIndices);
+            }
+        }
+    }
+}
+
+void SyntheticSceneGenerator::writeCluts(QByteArray& psxVRam)
+{
+    for (auto const& clut : cluts_)
+    {
+        uint16_t firstX = clut.x << PsxVRamConst::CLUT_X_SHIFT;
+        for (uint16_t colorIndex = 0; colorIndex < PsxVRamConst::CLUT_4_BPP_WIDTH; ++colorIndex)
+        {
+            auto color = static_cast<uint16_t>(randomInRange(1, 0x7fff));
+            writeVRamPixel(psxVRam, firstX + colorIndex, clut.y, color);
+        }
+    }
+}
+
+void SyntheticSceneGenerator::writeVRamPixel(QByteArray& psxVRam, uint16_t x, uint16_t y, uint16_t value)
+{
+    auto offset = y * PsxVRamConst::WIDTH + x * PsxVRamConst::PIXEL_SIZE;
+    psxVRam[offset] = static_cast<char>(value & 0xff);
+    psxVRam[offset + 1] = static_cast<char>(value >> 8);
+}
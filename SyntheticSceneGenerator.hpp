@@ -0,0 +1,81 @@
+#ifndef SYNTHETICSCENEGENERATOR_HPP
+#define SYNTHETICSCENEGENERATOR_HPP
+
+#include "ADDefinitions.hpp"
+#include "BufferedPsxRam.hpp"
+#include <QByteArray>
+#include <QVector>
+#include <random>
+
+class SyntheticSceneGenerator
+{
+public:
+    struct Parameters
+    {
+        uint16_t voxelsWidth{32};
+        uint16_t voxelsHeight{32};
+        float filledVoxelsRatio{1.0f};
+        float descriptorsListsReuseRatio{0.5f};
+        uint8_t minPolygonsPerVoxel{1};
+        uint8_t maxPolygonsPerVoxel{6};
+        float semiTransparentRatio{0.1f};
+        uint32_t verticesNumber{4096};
+        uint8_t texpagesNumber{4};
+        uint8_t clutsNumber{8};
+        uint32_t seed{0};
+    };
+
+    struct Statistics
+    {
+        uint32_t filledVoxelsNumber;
+        uint32_t descriptorsListsNumber;
+        uint32_t polygonsNumber;
+        uint32_t verticesNumber;
+        uint32_t usedRamSize;
+    };
+
+    explicit SyntheticSceneGenerator(Parameters const& parameters);
+
+    void generate(BufferedPsxRam& psxRam, QByteArray& psxVRam);
+    QByteArray generateDump();
+    Statistics const& statistics() const
+    { return statistics_; }
+
+private:
+    static uint8_t log2Ceil(uint16_t value);
+    void validateParameters() const;
+    PsxRamAddress allocate(uint32_t size);
+    uint32_t randomInRange(uint32_t min, uint32_t max);
+    bool randomChance(float ratio);
+    void chooseTexpages();
+    void chooseCluts();
+    void writeVertices(BufferedPsxRam& psxRam, PsxRamAddress verticesAddress);
+    AD::Point3D randomRectangleCorner(uint8_t orientation, int16_t plane, int16_t u, int16_t v) const;
+    void planVoxels();
+    void writeVoxels(BufferedPsxRam& psxRam, PsxRamAddress voxelsAddress);
+    void writePolygonsDescriptorsLists(BufferedPsxRam& psxRam, PsxRamAddress descriptorsAddresses);
+    PsxRamAddress writePolygonsDescriptorsList(BufferedPsxRam& psxRam);
+    AD::PolygonDescriptor randomPolygonDescriptor(bool isLastPolygon);
+    void writeHeader(
+            BufferedPsxRam& psxRam,
+            PsxRamAddress voxelsAddress,
+            PsxRamAddress descriptorsAddresses,
+            PsxRamAddress verticesAddress);
+    void writeTexpages(QByteArray& psxVRam);
+    void writeCluts(QByteArray& psxVRam);
+    static void writeVRamPixel(QByteArray& psxVRam, uint16_t x, uint16_t y, uint16_t value);
+
+    Parameters parameters_;
+    std::mt19937 randomGenerator_;
+    uint8_t log2VoxelsWidth_;
+    uint8_t log2VoxelsHeight_;
+    uint32_t rectanglesNumber_;
+    PsxRamAddress nextFreeAddress_;
+    QVector<GpuTexpage> texpages_;
+    QVector<GpuClut> cluts_;
+    QVector<AD::Voxel> voxels_;
+    uint16_t descriptorsListsNumber_;
+    Statistics statistics_;
+};
+
+#endif // SYNTHETICSCENEGENERATOR_HPP
@@ -1,4 +1,4 @@
-QT       += core gui opengl
+QT       += core gui opengl concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,26 +9,32 @@ DEFINES -= UNICODE
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+include(VirtualMonsbaiaRender.pri)
+
 SOURCES += \
-    ADScene.cpp \
-    BufferedPsxRam.cpp \
-    PsxRamConst.cpp \
+    DumpCatalogDialog.cpp \
+    DumpCatalogModel.cpp \
+    DynamicResolutionController.cpp \
+    FrameCapturer.cpp \
+    GpuFrameTimer.cpp \
+    OcclusionCuller.cpp \
+    OverdrawHeatmap.cpp \
     SceneGLRenderer.cpp \
+    SceneMinimap.cpp \
     main.cpp \
     MainWindow.cpp
 
 HEADERS += \
-    ADDefinitions.hpp \
-    ADScene.hpp \
-    BitsHelper.hpp \
-    BufferedPsxRam.hpp \
-    GpuTypes.hpp \
+    DumpCatalogDialog.hpp \
+    DumpCatalogModel.hpp \
+    DynamicResolutionController.hpp \
+    FrameCapturer.hpp \
+    GpuFrameTimer.hpp \
     MainWindow.hpp \
-    MemoryAddress.hpp \
-    PsxRamAddress.hpp \
-    PsxRamConst.hpp \
-    PsxVRamConst.hpp \
-    SceneGLRenderer.hpp
+    OcclusionCuller.hpp \
+    OverdrawHeatmap.hpp \
+    SceneGLRenderer.hpp \
+    SceneMinimap.hpp
 
 FORMS += \
     MainWindow.ui
@@ -37,8 +43,3 @@ FORMS += \
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
-
-win32: LIBS += -lOpenGL32
-
-RESOURCES += \
-    resources.qrc
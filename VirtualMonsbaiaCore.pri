@@ -0,0 +1,75 @@
+# PSX memory access, scene parsing and mesh building. Depends on QtCore, QtConcurrent and the zlib Qt uses only,
+# so tools built on it run headless without GUI plugins.
+
+QT *= core concurrent
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/ADScene.cpp \
+    $$PWD/BufferedPsxRam.cpp \
+    $$PWD/DumpCatalog.cpp \
+    $$PWD/DumpCatalogIndexer.cpp \
+    $$PWD/DumpPrefetcher.cpp \
+    $$PWD/DumpSceneScanner.cpp \
+    $$PWD/DumpSequenceConst.cpp \
+    $$PWD/DumpSequenceDelta.cpp \
+    $$PWD/DumpSequenceReader.cpp \
+    $$PWD/DumpSequenceWriter.cpp \
+    $$PWD/DumpTriage.cpp \
+    $$PWD/PatternSearcher.cpp \
+    $$PWD/PsxRamConst.cpp \
+    $$PWD/SavestateImporter.cpp \
+    $$PWD/SavestateSectionLocator.cpp \
+    $$PWD/SceneLoader.cpp \
+    $$PWD/SceneLodBuilder.cpp \
+    $$PWD/SceneMeshBuilder.cpp \
+    $$PWD/ScenePvs.cpp \
+    $$PWD/SceneSemiTransparentOrder.cpp \
+    $$PWD/SceneTextureOpacity.cpp \
+    $$PWD/SceneVRamLayout.cpp \
+    $$PWD/SyntheticSceneGenerator.cpp
+
+HEADERS += \
+    $$PWD/ADDefinitions.hpp \
+    $$PWD/ADScene.hpp \
+    $$PWD/ADSceneConst.hpp \
+    $$PWD/BitsHelper.hpp \
+    $$PWD/BufferedPsxRam.hpp \
+    $$PWD/CoreError.hpp \
+    $$PWD/DumpCatalog.hpp \
+    $$PWD/DumpCatalogIndexer.hpp \
+    $$PWD/DumpPrefetcher.hpp \
+    $$PWD/DumpSceneScanner.hpp \
+    $$PWD/DumpSequenceConst.hpp \
+    $$PWD/DumpSequenceDelta.hpp \
+    $$PWD/DumpSequenceReader.hpp \
+    $$PWD/DumpSequenceWriter.hpp \
+    $$PWD/DumpTriage.hpp \
+    $$PWD/GpuTypes.hpp \
+    $$PWD/MemoryAddress.hpp \
+    $$PWD/PatternSearcher.hpp \
+    $$PWD/PsxRamAddress.hpp \
+    $$PWD/PsxRamConst.hpp \
+    $$PWD/PsxVRamConst.hpp \
+    $$PWD/SavestateImporter.hpp \
+    $$PWD/SavestateSectionLocator.hpp \
+    $$PWD/SceneLoader.hpp \
+    $$PWD/SceneLodBuilder.hpp \
+    $$PWD/SceneMesh.hpp \
+    $$PWD/SceneMeshBuilder.hpp \
+    $$PWD/ScenePvs.hpp \
+    $$PWD/SceneSemiTransparentOrder.hpp \
+    $$PWD/SceneTextureOpacity.hpp \
+    $$PWD/SceneVRamLayout.hpp \
+    $$PWD/SyntheticSceneGenerator.hpp
+
+# Savestates are inflated with the zlib Qt itself uses: the system one where Qt links it, otherwise the
+# copy bundled into QtCore, so no platform needs a separate zlib.
+qtConfig(system-zlib): LIBS += -lz
+else: QT_PRIVATE *= zlib-private
+
+linux {
+    SOURCES += $$PWD/EmulatorProcessMemory.cpp
+    HEADERS += $$PWD/EmulatorProcessMemory.hpp
+}
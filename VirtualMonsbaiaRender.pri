@@ -0,0 +1,28 @@
+# Scene GPU resources and windowless rendering shared by the viewer and the render tools. Requires an
+# OpenGL 3.3 core context; includes the core library.
+
+QT *= core gui
+
+include($$PWD/VirtualMonsbaiaCore.pri)
+
+SOURCES += \
+    $$PWD/OffscreenSceneRenderer.cpp \
+    $$PWD/SceneBvh.cpp \
+    $$PWD/SceneGLResources.cpp \
+    $$PWD/SceneGLVertexArrays.cpp \
+    $$PWD/ScenePvsBuilder.cpp \
+    $$PWD/SceneResidencyManager.cpp
+
+HEADERS += \
+    $$PWD/OffscreenSceneRenderer.hpp \
+    $$PWD/SceneBvh.hpp \
+    $$PWD/SceneCamera.hpp \
+    $$PWD/SceneGLResources.hpp \
+    $$PWD/SceneGLVertexArrays.hpp \
+    $$PWD/ScenePvsBuilder.hpp \
+    $$PWD/SceneResidencyManager.hpp
+
+RESOURCES += \
+    $$PWD/resources.qrc
+
+win32: LIBS += -lOpenGL32
@@ -0,0 +1,9 @@
+TEMPLATE = lib
+TARGET = VirtualMonsbaiaCore
+
+QT       = core
+
+CONFIG += c++14 staticlib
+DEFINES -= UNICODE
+
+include(../VirtualMonsbaiaCore.pri)
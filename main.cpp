@@ -4,6 +4,8 @@
 
 int main(int argc, char *argv[])
 {
+    // Comparison views share the scene buffers and textures of the main view.
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
     QApplication a(argc, argv);
     QSurfaceFormat format;
     format.setDepthBufferSize(24);
@@ -0,0 +1,10 @@
+QT       = core
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+DEFINES -= UNICODE
+
+include(../../VirtualMonsbaiaCore.pri)
+
+SOURCES += \
+    main.cpp
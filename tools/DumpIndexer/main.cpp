@@ -0,0 +1,94 @@
+#include "DumpCatalog.hpp"
+#include "DumpCatalogIndexer.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace
+{
+
+void list(DumpCatalog const& catalog, QString const& filter, QTextStream& out)
+{
+    out << "path\tgrid\tpolygons\tsemi-transparent\tvertices\ttexpages\tduplicate of" << '\n';
+    for (int recordIndex = 0; recordIndex < catalog.recordsNumber(); ++recordIndex)
+    {
+        auto relativePath = catalog.relativePath(recordIndex);
+        if (!filter.isEmpty() && !relativePath.contains(filter, Qt::CaseInsensitive))
+        { continue; }
+        auto const& record = catalog.record(recordIndex);
+        if (!record.isSceneRead())
+        {
+            out << relativePath << (record.isScanFailed() ? "\tscan failed" : "\tscene not read") << '\n';
+            continue;
+        }
+        out << QString("%1\t%2x%3\t%4\t%5\t%6\t%7\t%8")
+               .arg(relativePath)
+               .arg(record.voxelsWidth)
+               .arg(record.voxelsHeight)
+               .arg(record.polygonsNumber)
+               .arg(record.semiTransparentPolygonsNumber)
+               .arg(record.verticesNumber)
+               .arg(record.texpagesNumber())
+               .arg(record.duplicateOf >= 0 ? catalog.relativePath(record.duplicateOf) : QString("-")) << '\n';
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Indexes the AD 3D models (*.3dm) under a directory into a catalog. Only files added or "
+                "changed since the previous run are scanned.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("directory", "Root directory of the dump archive.");
+    QCommandLineOption catalogOption(
+                "catalog",
+                QString("Catalog file, %1 in the directory by default.").arg(DumpCatalog::DEFAULT_FILE_NAME),
+                "file");
+    parser.addOption(catalogOption);
+    QCommandLineOption listOption("list", "List the catalog after indexing.");
+    parser.addOption(listOption);
+    QCommandLineOption filterOption("filter", "List only dumps whose path contains the text.", "text");
+    parser.addOption(filterOption);
+    parser.process(application);
+    if (parser.positionalArguments().size() != 1)
+    { parser.showHelp(1); }
+    auto rootPath = parser.positionalArguments().first();
+    auto catalogPath = parser.isSet(catalogOption) ?
+                parser.value(catalogOption) :
+                DumpCatalogIndexer::defaultCatalogPath(rootPath);
+    try
+    {
+        DumpCatalogIndexer indexer;
+        QElapsedTimer timer;
+        timer.start();
+        auto statistics = indexer.index(rootPath, catalogPath);
+        for (auto const& error : indexer.errors())
+        { err << error << '\n'; }
+        out << QString("Indexed %1 dumps in %2 ms: %3 scanned, %4 unchanged, %5 failed, %6 duplicates.")
+               .arg(statistics.filesNumber)
+               .arg(timer.elapsed())
+               .arg(statistics.scannedFilesNumber)
+               .arg(statistics.reusedRecordsNumber)
+               .arg(statistics.failedFilesNumber)
+               .arg(statistics.duplicatesNumber) << '\n';
+        if (parser.isSet(listOption) || parser.isSet(filterOption))
+        {
+            DumpCatalog catalog;
+            catalog.open(catalogPath);
+            list(catalog, parser.value(filterOption), out);
+        }
+    }
+    catch (QString const& error)
+    {
+        err << error << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "DumpSequenceReader.hpp"
+#include "DumpSequenceWriter.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace
+{
+
+void pack(QString const& outputPath, QStringList const& inputPaths, uint32_t keyframeInterval, QTextStream& out)
+{
+    DumpSequenceWriter writer;
+    writer.open(outputPath, keyframeInterval);
+    qint64 inputBytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (auto const& inputPath : inputPaths)
+    {
+        QFile file(inputPath);
+        if (!file.open(QFile::ReadOnly))
+        { throw QString("Could not open file %1.").arg(inputPath); }
+        auto frame = file.readAll();
+        inputBytes += frame.size();
+        writer.addFrame(frame);
+    }
+    auto outputBytes = writer.writtenBytes();
+    writer.close();
+    out << QString("Packed %1 frames, %2 MB into %3 KB (%4x smaller) in %5 ms.")
+           .arg(inputPaths.size())
+           .arg(inputBytes >> 20)
+           .arg(outputBytes >> 10)
+           .arg(static_cast<double>(inputBytes) / qMax<qint64>(1, outputBytes), 0, 'f', 1)
+           .arg(timer.elapsed()) << '\n';
+}
+
+void unpack(QString const& inputPath, QString const& outputDirectoryPath, QTextStream& out)
+{
+    DumpSequenceReader reader;
+    reader.open(inputPath);
+    QDir outputDirectory(outputDirectoryPath);
+    if (!outputDirectory.mkpath("."))
+    { throw QString("Could not create directory %1.").arg(outputDirectoryPath); }
+    auto baseName = QFileInfo(inputPath).completeBaseName();
+    for (uint32_t frameIndex = 0; frameIndex < reader.framesNumber(); ++frameIndex)
+    {
+        reader.seek(frameIndex);
+        QFile file(outputDirectory.filePath(QString("%1_%2.3dm").arg(baseName).arg(frameIndex, 6, 10, QChar('0'))));
+        if (!file.open(QFile::WriteOnly) || file.write(reader.frame()) != reader.frame().size())
+        { throw QString("Could not write file %1.").arg(file.fileName()); }
+    }
+    out << QString("Unpacked %1 frames.").arg(reader.framesNumber()) << '\n';
+}
+
+void measurePlayback(QString const& inputPath, QTextStream& out)
+{
+    DumpSequenceReader reader;
+    reader.open(inputPath);
+    QElapsedTimer timer;
+    timer.start();
+    for (uint32_t frameIndex = 0; frameIndex < reader.framesNumber(); ++frameIndex)
+    { reader.seek(frameIndex); }
+    auto forwardTimeMs = qMax<qint64>(1, timer.elapsed());
+    timer.restart();
+    for (auto frameIndex = static_cast<int>(reader.framesNumber()) - 1; frameIndex >= 0; --frameIndex)
+    { reader.seek(frameIndex); }
+    auto backwardTimeMs = qMax<qint64>(1, timer.elapsed());
+    out << QString("Played %1 frames forward at %2 fps and backward at %3 fps.")
+           .arg(reader.framesNumber())
+           .arg(reader.framesNumber() * 1000.0 / forwardTimeMs, 0, 'f', 0)
+           .arg(reader.framesNumber() * 1000.0 / backwardTimeMs, 0, 'f', 0) << '\n';
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Packs AD 3D models (*.3dm) into a delta compressed dump sequence (*.3ds) and back.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("sequence", "Dump sequence *.3ds file.");
+    parser.addPositionalArgument("dumps", "Input *.3dm files in frame order, when packing.", "[dumps...]");
+    QCommandLineOption keyframeInterval(
+                "keyframe-interval",
+                "Maximal number of frames between keyframes.",
+                "frames",
+                QString::number(DumpSequenceConst::DEFAULT_KEYFRAME_INTERVAL));
+    QCommandLineOption unpackDirectory("unpack", "Unpack sequence frames into directory.", "directory");
+    QCommandLineOption measure("measure-playback", "Measure how fast the sequence is played back.");
+    parser.addOption(keyframeInterval);
+    parser.addOption(unpackDirectory);
+    parser.addOption(measure);
+    parser.process(application);
+    auto arguments = parser.positionalArguments();
+    if (arguments.isEmpty())
+    { parser.showHelp(1); }
+    try
+    {
+        auto sequencePath = arguments.takeFirst();
+        if (!arguments.isEmpty())
+        {
+            bool ok = false;
+            auto interval = parser.value(keyframeInterval).toUInt(&ok);
+            if (!ok || interval == 0)
+            { throw QString("Value of --keyframe-interval must be a positive number."); }
+            pack(sequencePath, arguments, interval, out);
+        }
+        if (parser.isSet(unpackDirectory))
+        { unpack(sequencePath, parser.value(unpackDirectory), out); }
+        if (parser.isSet(measure))
+        { measurePlayback(sequencePath, out); }
+    }
+    catch (QString const& error)
+    {
+        err << error << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "DumpTriage.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <array>
+#include <numeric>
+
+namespace
+{
+constexpr int const VERDICTS_NUMBER = static_cast<int>(DumpTriage::Verdict::NOT_A_DUMP) + 1;
+// Reads are tiny and mostly wait on the storage, so far more of them run at once than there are cores.
+constexpr int const THREADS_PER_CORE = 8;
+
+QStringList dumpPaths(QStringList const& paths)
+{
+    QStringList dumpPaths;
+    for (auto const& path : paths)
+    {
+        if (!QFileInfo(path).isDir())
+        {
+            dumpPaths.append(path);
+            continue;
+        }
+        QDirIterator fileIt(path, {"*.3dm"}, QDir::Files, QDirIterator::Subdirectories);
+        while (fileIt.hasNext())
+        { dumpPaths.append(fileIt.next()); }
+    }
+    return dumpPaths;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Classifies AD 3D models (*.3dm) by whether they hold a loaded scene, reading only a few bytes of "
+                "each. Prints path, verdict, grid size and reason for every dump.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("paths", "Dumps, or directories searched for *.3dm files.", "paths...");
+    QCommandLineOption samplesOption(
+                "samples",
+                QString("Voxels sampled from the tables of every dump, %1 by default.")
+                    .arg(DumpTriage::DEFAULT_SAMPLED_VOXELS_NUMBER),
+                "number");
+    parser.addOption(samplesOption);
+    QCommandLineOption threadsOption(
+                "threads",
+                QString("Dumps read at once, %1 per core by default.").arg(THREADS_PER_CORE),
+                "number");
+    parser.addOption(threadsOption);
+    QCommandLineOption validOption("valid", "List only dumps holding a valid scene.");
+    parser.addOption(validOption);
+    parser.process(application);
+    if (parser.positionalArguments().isEmpty())
+    { parser.showHelp(1); }
+    auto sampledVoxelsNumber = static_cast<int>(DumpTriage::DEFAULT_SAMPLED_VOXELS_NUMBER);
+    auto threadsNumber = QThread::idealThreadCount() * THREADS_PER_CORE;
+    bool ok = true;
+    if (parser.isSet(samplesOption))
+    { sampledVoxelsNumber = parser.value(samplesOption).toInt(&ok); }
+    if (!ok || sampledVoxelsNumber < 0)
+    {
+        err << "Value of --samples must be a number." << '\n';
+        return 1;
+    }
+    if (parser.isSet(threadsOption))
+    { threadsNumber = parser.value(threadsOption).toInt(&ok); }
+    if (!ok || threadsNumber < 1)
+    {
+        err << "Value of --threads must be a positive number." << '\n';
+        return 1;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    auto paths = dumpPaths(parser.positionalArguments());
+    QVector<DumpTriage::Result> results(paths.count());
+    QVector<int> pathsIndices(paths.count());
+    std::iota(pathsIndices.begin(), pathsIndices.end(), 0);
+    QThreadPool::globalInstance()->setMaxThreadCount(threadsNumber);
+    auto* resultsData = results.data();
+    QtConcurrent::blockingMap(pathsIndices, [&](int pathIndex) {
+        resultsData[pathIndex] = DumpTriage::triage(paths[pathIndex], sampledVoxelsNumber);
+    });
+    auto elapsedMs = timer.elapsed();
+    std::array<int, VERDICTS_NUMBER> verdictsCounts{};
+    for (int pathIndex = 0; pathIndex < paths.count(); ++pathIndex)
+    {
+        auto const& result = results[pathIndex];
+        ++verdictsCounts[static_cast<int>(result.verdict)];
+        if (parser.isSet(validOption) && result.verdict != DumpTriage::Verdict::VALID_SCENE)
+        { continue; }
+        out << QString("%1\t%2\t%3x%4\t%5")
+               .arg(paths[pathIndex])
+               .arg(DumpTriage::verdictName(result.verdict))
+               .arg(result.voxelsWidth)
+               .arg(result.voxelsHeight)
+               .arg(result.reason) << '\n';
+    }
+    out.flush();
+    QStringList countsTexts;
+    for (int verdict = 0; verdict < VERDICTS_NUMBER; ++verdict)
+    {
+        countsTexts.append(QString("%1 %2")
+                           .arg(verdictsCounts[verdict])
+                           .arg(DumpTriage::verdictName(static_cast<DumpTriage::Verdict>(verdict))));
+    }
+    err << QString("Triaged %1 dumps in %2 ms (%3 per second): %4.")
+           .arg(paths.count())
+           .arg(elapsedMs)
+           .arg(elapsedMs > 0 ? paths.count() * 1000 / elapsedMs : paths.count())
+           .arg(countsTexts.join(", ")) << '\n';
+    return 0;
+}
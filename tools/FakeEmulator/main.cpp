@@ -0,0 +1,65 @@
+#include "PsxRamConst.hpp"
+#include "PsxVRamConst.hpp"
+#include "SyntheticSceneGenerator.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <cstring>
+#include <memory>
+#include <random>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Stands in for an emulator: keeps PSX RAM and VRAM of an AD 3D model (*.3dm) "
+                "at a random offset of a large heap block until terminated.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("model", "AD 3D model (*.3dm). A synthetic scene is generated when omitted.");
+    QCommandLineOption heapSizeOption("heap-size", "Size of the heap block holding the memory (MB).", "MB", "256");
+    parser.addOption(heapSizeOption);
+    parser.process(application);
+    QByteArray dump;
+    try
+    {
+        if (parser.positionalArguments().isEmpty())
+        { dump = SyntheticSceneGenerator({}).generateDump(); }
+        else
+        {
+            QFile file(parser.positionalArguments().first());
+            if (!file.open(QFile::ReadOnly))
+            { throw QString("Could not open file %1.").arg(file.fileName()); }
+            dump = file.readAll();
+        }
+    }
+    catch (QString const& error)
+    {
+        err << error << '\n';
+        return 1;
+    }
+    if (dump.size() != static_cast<int>(PsxRamConst::SIZE + PsxVRamConst::SIZE))
+    {
+        err << QString("Model size %1 is different than expected %2.")
+               .arg(dump.size())
+               .arg(PsxRamConst::SIZE + PsxVRamConst::SIZE) << '\n';
+        return 1;
+    }
+    if (!dump.startsWith(PsxRamConst::PSX_RAM_PATTERN))
+    { err << "Warning: PSX RAM does not start with the PSX RAM pattern." << '\n'; }
+    size_t heapSize = qMax<size_t>(parser.value(heapSizeOption).toULongLong() << 20, dump.size() * 2);
+    auto heap = std::make_unique<char[]>(heapSize);
+    std::mt19937_64 randomGenerator(std::random_device{}());
+    size_t dumpOffset = (randomGenerator() % (heapSize - dump.size())) & ~static_cast<size_t>(0xf);
+    std::memset(heap.get(), 0xcd, heapSize);
+    std::memcpy(heap.get() + dumpOffset, dump.constData(), dump.size());
+    out << QString("PID %1, PSX RAM at 0x%2, VRAM at 0x%3.")
+           .arg(QCoreApplication::applicationPid())
+           .arg(reinterpret_cast<quintptr>(heap.get() + dumpOffset), 0, 16)
+           .arg(reinterpret_cast<quintptr>(heap.get() + dumpOffset + PsxRamConst::SIZE), 0, 16) << '\n';
+    out.flush();
+    return application.exec();
+}
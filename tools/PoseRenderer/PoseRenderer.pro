@@ -0,0 +1,10 @@
+QT       = core gui
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+DEFINES -= UNICODE
+
+include(../../VirtualMonsbaiaRender.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,153 @@
+#include "OffscreenSceneRenderer.hpp"
+#include "SceneCamera.hpp"
+#include "SceneLoader.hpp"
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QSurfaceFormat>
+#include <QTextStream>
+
+namespace
+{
+constexpr int const MAX_IMAGE_SIZE = 8192;
+
+struct Pose
+{
+    SceneCamera camera;
+    QSize size;
+    QString outputPath;
+};
+
+// One JSON object per line with the camera fields of RenderService requests, an optional image size and
+// the output image path, relative to the output directory.
+QVector<Pose> readPoses(QString const& posesPath, QSize const& defaultSize, QDir const& outputDirectory)
+{
+    QFile file(posesPath);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    { throw QString("Could not open file %1.").arg(posesPath); }
+    QVector<Pose> poses;
+    int lineNumber = 0;
+    while (!file.atEnd())
+    {
+        ++lineNumber;
+        auto line = file.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+        { continue; }
+        try
+        {
+            QJsonParseError parseError;
+            auto poseObject = QJsonDocument::fromJson(line, &parseError).object();
+            if (parseError.error != QJsonParseError::NoError)
+            { throw QString("Pose is not a JSON object: %1").arg(parseError.errorString()); }
+            Pose pose;
+            pose.camera = SceneCamera::fromJson(poseObject);
+            pose.size = QSize(
+                        poseObject.value("width").toInt(defaultSize.width()),
+                        poseObject.value("height").toInt(defaultSize.height()));
+            if (pose.size.width() <= 0 || pose.size.height() <= 0
+                    || pose.size.width() > MAX_IMAGE_SIZE || pose.size.height() > MAX_IMAGE_SIZE)
+            { throw QString("Image size %1x%2 is out of range.").arg(pose.size.width()).arg(pose.size.height()); }
+            auto defaultOutput = QString("pose%1.png").arg(poses.count(), 4, 10, QChar('0'));
+            pose.outputPath = outputDirectory.filePath(poseObject.value("output").toString(defaultOutput));
+            poses.append(pose);
+        }
+        catch (QString const& error)
+        { throw QString("%1:%2: %3").arg(posesPath).arg(lineNumber).arg(error); }
+    }
+    return poses;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Renders an AD 3D model (*.3dm) from a list of camera poses into image files, without a window. "
+                "Poses are JSON lines with optional position, yaw, pitch, fov, width, height and output fields. "
+                "Without a display the offscreen platform is used; --software selects Mesa llvmpipe.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("dump", "AD 3D model (*.3dm).");
+    parser.addPositionalArgument("poses", "Camera poses file.");
+    QCommandLineOption outputOption("output", "Directory of the images.", "directory", ".");
+    parser.addOption(outputOption);
+    QCommandLineOption widthOption("width", "Default image width.", "pixels", "640");
+    parser.addOption(widthOption);
+    QCommandLineOption heightOption("height", "Default image height.", "pixels", "480");
+    parser.addOption(heightOption);
+    QCommandLineOption softwareOption("software", "Render with the Mesa software rasterizer.");
+    parser.addOption(softwareOption);
+    QStringList arguments;
+    for (int argumentIndex = 0; argumentIndex < argc; ++argumentIndex)
+    { arguments.append(QString::fromLocal8Bit(argv[argumentIndex])); }
+    parser.parse(arguments);
+    // Has to happen before the platform is loaded and creates any context.
+    if (parser.isSet(softwareOption))
+    {
+        qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+        qputenv("GALLIUM_DRIVER", "llvmpipe");
+    }
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY")
+            && qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY"))
+    { qputenv("QT_QPA_PLATFORM", "offscreen"); }
+    QGuiApplication application(argc, argv);
+    parser.process(application);
+    if (parser.positionalArguments().size() != 2)
+    { parser.showHelp(1); }
+    QSurfaceFormat format;
+    format.setDepthBufferSize(24);
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setRenderableType(QSurfaceFormat::OpenGL);
+    QSurfaceFormat::setDefaultFormat(format);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    try
+    {
+        auto dumpPath = parser.positionalArguments()[0];
+        QDir outputDirectory(parser.value(outputOption));
+        if (!outputDirectory.mkpath("."))
+        { throw QString("Could not create directory %1.").arg(outputDirectory.path()); }
+        auto poses = readPoses(
+                    parser.positionalArguments()[1],
+                    QSize(parser.value(widthOption).toInt(), parser.value(heightOption).toInt()),
+                    outputDirectory);
+        QElapsedTimer timer;
+        timer.start();
+        SceneLoader sceneLoader;
+        SceneMesh mesh;
+        auto error = sceneLoader.loadDump(dumpPath);
+        if (error.isOk())
+        { error = sceneLoader.readScene(); }
+        if (error.isOk())
+        { error = sceneLoader.buildMesh(mesh); }
+        if (!error.isOk())
+        { throw error.message; }
+        // The context and the scene upload are shared by all poses, every image only costs its draw.
+        OffscreenSceneRenderer renderer;
+        renderer.initialize();
+        renderer.loadScene(QFileInfo(dumpPath).canonicalFilePath(), std::move(mesh), sceneLoader.psxVRam());
+        out << QString("Loaded %1 in %2 ms.").arg(dumpPath).arg(timer.elapsed()) << '\n';
+        for (auto const& pose : poses)
+        {
+            timer.restart();
+            auto image = renderer.render(pose.camera, pose.size);
+            auto renderTimeUs = timer.nsecsElapsed() / 1000;
+            if (!image.save(pose.outputPath))
+            { throw QString("Could not write image %1.").arg(pose.outputPath); }
+            out << QString("%1: rendered in %2 us.").arg(pose.outputPath).arg(renderTimeUs) << '\n';
+        }
+        renderer.release();
+    }
+    catch (QString const& error)
+    {
+        err << error << '\n';
+        return 1;
+    }
+    return 0;
+}
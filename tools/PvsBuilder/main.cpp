@@ -0,0 +1,78 @@
+#include "SceneLoader.hpp"
+#include "ScenePvs.hpp"
+#include "ScenePvsBuilder.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                QString("Computes the potentially visible set of AD 3D models (*.3dm) and saves it next to every "
+                        "model as <model>%1, where the viewer picks it up.").arg(ScenePvs::FILE_SUFFIX));
+    parser.addHelpOption();
+    parser.addPositionalArgument("dumps", "AD 3D models (*.3dm).", "dumps...");
+    QCommandLineOption samplesOption(
+                "samples",
+                QString("Rays cast from every cell to every chunk, %1 by default.")
+                    .arg(ScenePvsBuilder::DEFAULT_SAMPLES_PER_CHUNK),
+                "number");
+    parser.addOption(samplesOption);
+    parser.process(application);
+    if (parser.positionalArguments().isEmpty())
+    { parser.showHelp(1); }
+    auto samplesPerChunk = static_cast<int>(ScenePvsBuilder::DEFAULT_SAMPLES_PER_CHUNK);
+    if (parser.isSet(samplesOption))
+    {
+        bool ok = false;
+        samplesPerChunk = parser.value(samplesOption).toInt(&ok);
+        if (!ok || samplesPerChunk < 1)
+        {
+            err << "Value of --samples must be a positive number." << '\n';
+            return 1;
+        }
+    }
+    int failedDumpsNumber = 0;
+    // Kept across dumps, so their buffers are reused.
+    SceneLoader sceneLoader;
+    SceneMesh mesh;
+    for (auto const& dumpPath : parser.positionalArguments())
+    {
+        try
+        {
+            auto error = sceneLoader.loadDump(dumpPath);
+            if (error.isOk())
+            { error = sceneLoader.readScene(); }
+            if (error.isOk())
+            { error = sceneLoader.buildMesh(mesh); }
+            if (!error.isOk())
+            { throw error.message; }
+            QElapsedTimer timer;
+            timer.start();
+            ScenePvs pvs;
+            ScenePvsBuilder::build(mesh, pvs, samplesPerChunk);
+            auto buildTimeMs = timer.elapsed();
+            pvs.save(ScenePvs::filePath(dumpPath));
+            qint64 visibleChunksNumber = 0;
+            for (int cellIndex = 0; cellIndex < pvs.cellsNumber(); ++cellIndex)
+            { visibleChunksNumber += pvs.visibleChunksNumber(cellIndex); }
+            out << QString("%1: %2 cells, %3 chunks, %4 visible chunks per cell on average, built in %5 ms.")
+                   .arg(dumpPath)
+                   .arg(pvs.cellsNumber())
+                   .arg(pvs.chunksNumber())
+                   .arg(pvs.cellsNumber() > 0 ? double(visibleChunksNumber) / pvs.cellsNumber() : 0.0, 0, 'f', 1)
+                   .arg(buildTimeMs) << '\n';
+        }
+        catch (QString const& error)
+        {
+            err << dumpPath << ": " << error << '\n';
+            ++failedDumpsNumber;
+        }
+    }
+    return failedDumpsNumber == 0 ? 0 : 1;
+}
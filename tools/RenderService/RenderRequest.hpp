@@ -0,0 +1,44 @@
+#ifndef RENDERREQUEST_HPP
+#define RENDERREQUEST_HPP
+
+#include "SceneCamera.hpp"
+#include <QByteArray>
+#include <QJsonValue>
+#include <QMetaType>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+struct RenderRequest
+{
+    enum Format
+    {
+        PNG,
+        RGBA
+    };
+
+    quint64 number;
+    QJsonValue id;
+    QString dumpPath;
+    QString sceneKey;
+    SceneCamera camera;
+    QSize size;
+    Format format;
+};
+
+struct RenderResponse
+{
+    quint64 requestNumber;
+    QString error;
+    QSize size;
+    QByteArray payload;
+    qint64 loadTimeUs;
+    qint64 renderTimeUs;
+    bool sceneReused;
+    QStringList sceneKeys;
+};
+
+Q_DECLARE_METATYPE(RenderRequest)
+Q_DECLARE_METATYPE(RenderResponse)
+
+#endif // RENDERREQUEST_HPP
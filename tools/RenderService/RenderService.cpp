@@ -0,0 +1,170 @@
+#include "RenderService.hpp"
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+RenderService::RenderService(int workersNumber, size_t sceneMemoryBudget, QObject* parent)
+    : QObject(parent),
+      nextRequestNumber_{0}
+{
+    qRegisterMetaType<RenderRequest>();
+    qRegisterMetaType<RenderResponse>();
+    workers_.resize(workersNumber);
+    for (int workerIndex = 0; workerIndex < workersNumber; ++workerIndex)
+    {
+        auto& worker = workers_[workerIndex];
+        worker.renderWorker = std::make_unique<RenderWorker>(workerIndex, sceneCache_, sceneMemoryBudget);
+        worker.isBusy = false;
+        connect(worker.renderWorker.get(), &RenderWorker::finished, this, &RenderService::completeRequest);
+    }
+    connect(&server_, &QLocalServer::newConnection, this, &RenderService::acceptConnections);
+}
+
+RenderService::~RenderService()
+{ server_.close(); }
+
+void RenderService::listen(QString const& serverName)
+{
+    QLocalServer::removeServer(serverName);
+    if (!server_.listen(serverName))
+    { throw QString("Could not listen on %1: %2").arg(serverName, server_.errorString()); }
+}
+
+void RenderService::acceptConnections()
+{
+    while (server_.hasPendingConnections())
+    {
+        auto* socket = server_.nextPendingConnection();
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+        connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+    }
+}
+
+void RenderService::readRequests(QLocalSocket* socket)
+{
+    while (socket->canReadLine())
+    {
+        PendingRequest pendingRequest;
+        pendingRequest.receivedTimer.start();
+        pendingRequest.socket = socket;
+        pendingRequest.queueTimeUs = 0;
+        auto line = socket->readLine().trimmed();
+        if (line.isEmpty())
+        { continue; }
+        QJsonParseError parseError;
+        auto requestDocument = QJsonDocument::fromJson(line, &parseError);
+        QJsonObject requestObject = requestDocument.object();
+        try
+        {
+            if (!requestDocument.isObject())
+            { throw QString("Request is not a JSON object: %1").arg(parseError.errorString()); }
+            pendingRequest.request = parseRequest(requestObject);
+        }
+        catch (QString const& error)
+        {
+            writeResponse(
+                        socket,
+                        {{"id", requestObject.value("id")}, {"status", "error"}, {"error", error}, {"size", 0}},
+                        {});
+            continue;
+        }
+        queuedRequests_.append(pendingRequest);
+    }
+    dispatch();
+}
+
+RenderRequest RenderService::parseRequest(QJsonObject const& requestObject)
+{
+    RenderRequest request;
+    request.number = nextRequestNumber_++;
+    request.id = requestObject.value("id");
+    request.dumpPath = requestObject.value("dump").toString();
+    if (request.dumpPath.isEmpty())
+    { throw QString("Request has no dump path."); }
+    request.sceneKey = SceneCache::sceneKey(request.dumpPath);
+    request.camera = SceneCamera::fromJson(requestObject);
+    request.size = QSize(requestObject.value("width").toInt(640), requestObject.value("height").toInt(480));
+    if (request.size.width() <= 0 || request.size.height() <= 0
+            || request.size.width() > MAX_IMAGE_SIZE || request.size.height() > MAX_IMAGE_SIZE)
+    { throw QString("Image size %1x%2 is out of range.").arg(request.size.width()).arg(request.size.height()); }
+    auto format = requestObject.value("format").toString("png");
+    if (format == "png")
+    { request.format = RenderRequest::PNG; }
+    else if (format == "rgba")
+    { request.format = RenderRequest::RGBA; }
+    else
+    { throw QString("Unsupported image format %1.").arg(format); }
+    return request;
+}
+
+int RenderService::selectWorker(QString const& sceneKey) const
+{
+    // A worker already holding the scene skips the upload, which dominates small renders on llvmpipe.
+    int selectedWorkerIndex = -1;
+    for (int workerIndex = 0; workerIndex < static_cast<int>(workers_.size()); ++workerIndex)
+    {
+        auto const& worker = workers_[workerIndex];
+        if (worker.isBusy)
+        { continue; }
+        if (worker.sceneKeys.contains(sceneKey))
+        { return workerIndex; }
+        if (selectedWorkerIndex < 0
+                || worker.sceneKeys.count() < workers_[selectedWorkerIndex].sceneKeys.count())
+        { selectedWorkerIndex = workerIndex; }
+    }
+    return selectedWorkerIndex;
+}
+
+void RenderService::dispatch()
+{
+    while (!queuedRequests_.isEmpty())
+    {
+        auto workerIndex = selectWorker(queuedRequests_.first().request.sceneKey);
+        if (workerIndex < 0)
+        { return; }
+        auto pendingRequest = queuedRequests_.takeFirst();
+        if (pendingRequest.socket == nullptr)
+        { continue; }
+        pendingRequest.queueTimeUs = pendingRequest.receivedTimer.nsecsElapsed() / 1000;
+        workers_[workerIndex].isBusy = true;
+        workers_[workerIndex].renderWorker->render(pendingRequest.request);
+        runningRequests_.insert(pendingRequest.request.number, pendingRequest);
+    }
+}
+
+void RenderService::completeRequest(int workerIndex, RenderResponse const& response)
+{
+    auto& worker = workers_[workerIndex];
+    worker.isBusy = false;
+    worker.sceneKeys = response.sceneKeys;
+    auto pendingRequest = runningRequests_.take(response.requestNumber);
+    if (pendingRequest.socket != nullptr)
+    {
+        QJsonObject header{
+            {"id", pendingRequest.request.id},
+            {"status", response.error.isEmpty() ? "ok" : "error"},
+            {"size", response.payload.size()},
+            {"worker", workerIndex},
+            {"sceneReused", response.sceneReused},
+            {"queueMs", pendingRequest.queueTimeUs / 1000.0},
+            {"loadMs", response.loadTimeUs / 1000.0},
+            {"renderMs", response.renderTimeUs / 1000.0},
+            {"latencyMs", pendingRequest.receivedTimer.nsecsElapsed() / 1000000.0}};
+        if (response.error.isEmpty())
+        {
+            header.insert("width", response.size.width());
+            header.insert("height", response.size.height());
+            header.insert("format", pendingRequest.request.format == RenderRequest::PNG ? "png" : "rgba");
+        }
+        else
+        { header.insert("error", response.error); }
+        writeResponse(pendingRequest.socket, header, response.payload);
+    }
+    dispatch();
+}
+
+void RenderService::writeResponse(QLocalSocket* socket, QJsonObject const& header, QByteArray const& payload)
+{
+    socket->write(QJsonDocument(header).toJson(QJsonDocument::Compact));
+    socket->write("\n");
+    socket->write(payload);
+}
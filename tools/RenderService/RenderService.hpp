@@ -0,0 +1,68 @@
+#ifndef RENDERSERVICE_HPP
+#define RENDERSERVICE_HPP
+
+#include "RenderRequest.hpp"
+#include "RenderWorker.hpp"
+#include "SceneCache.hpp"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QPointer>
+#include <memory>
+#include <vector>
+
+// Accepts render requests on a local socket and hands them to a pool of render workers.
+// Protocol: every request is a JSON object on one line:
+//   {"id": any, "dump": path, "position": [x, y, z], "yaw": degrees, "pitch": degrees, "fov": degrees,
+//    "width": pixels, "height": pixels, "format": "png" | "rgba"}
+// Only "dump" is required. Every response is a JSON header on one line followed by "size" bytes of the
+// image: PNG, or RGBA rows from top to bottom. Responses carry the request id and may come out of order.
+class RenderService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int const MAX_IMAGE_SIZE = 8192;
+
+    RenderService(int workersNumber, size_t sceneMemoryBudget, QObject* parent = nullptr);
+    ~RenderService();
+
+    void listen(QString const& serverName);
+
+private:
+    struct Worker
+    {
+        std::unique_ptr<RenderWorker> renderWorker;
+        bool isBusy;
+        QStringList sceneKeys;
+    };
+
+    struct PendingRequest
+    {
+        RenderRequest request;
+        QPointer<QLocalSocket> socket;
+        QElapsedTimer receivedTimer;
+        qint64 queueTimeUs;
+    };
+
+    void acceptConnections();
+    void readRequests(QLocalSocket* socket);
+    RenderRequest parseRequest(QJsonObject const& requestObject);
+    void dispatch();
+    int selectWorker(QString const& sceneKey) const;
+    void completeRequest(int workerIndex, RenderResponse const& response);
+    static void writeResponse(QLocalSocket* socket, QJsonObject const& header, QByteArray const& payload);
+
+    SceneCache sceneCache_;
+    QLocalServer server_;
+    std::vector<Worker> workers_;
+    QList<PendingRequest> queuedRequests_;
+    QHash<quint64, PendingRequest> runningRequests_;
+    quint64 nextRequestNumber_;
+};
+
+#endif // RENDERSERVICE_HPP
@@ -0,0 +1,19 @@
+QT       = core gui network
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+DEFINES -= UNICODE
+
+include(../../VirtualMonsbaiaRender.pri)
+
+SOURCES += \
+    RenderService.cpp \
+    RenderWorker.cpp \
+    SceneCache.cpp \
+    main.cpp
+
+HEADERS += \
+    RenderRequest.hpp \
+    RenderService.hpp \
+    RenderWorker.hpp \
+    SceneCache.hpp
@@ -0,0 +1,92 @@
+#include "RenderWorker.hpp"
+#include <QBuffer>
+#include <QElapsedTimer>
+
+namespace
+{
+// Maps to zlib level 1 in the PNG writer: the image is sent over a local socket, so encoding speed matters
+// more than size.
+constexpr int const PNG_QUALITY = 80;
+}
+
+RenderWorker::RenderWorker(int index, SceneCache& sceneCache, size_t sceneMemoryBudget)
+    : index_{index},
+      sceneCache_(sceneCache),
+      renderer_(std::make_unique<OffscreenSceneRenderer>())
+{
+    thread_.setObjectName(QString("RenderWorker %1").arg(index));
+    threadContext_.moveToThread(&thread_);
+    renderer_->moveToThread(&thread_);
+    thread_.start();
+    QMetaObject::invokeMethod(
+                &threadContext_,
+                [this, sceneMemoryBudget]() { initialize(sceneMemoryBudget); },
+                Qt::QueuedConnection);
+}
+
+RenderWorker::~RenderWorker()
+{
+    QMetaObject::invokeMethod(&threadContext_, [this]() { renderer_->release(); }, Qt::BlockingQueuedConnection);
+    thread_.quit();
+    thread_.wait();
+}
+
+void RenderWorker::initialize(size_t sceneMemoryBudget)
+{
+    try
+    {
+        renderer_->initialize();
+        renderer_->setSceneMemoryBudget(sceneMemoryBudget);
+    }
+    catch (QString const& error)
+    { initializationError_ = error; }
+}
+
+void RenderWorker::render(RenderRequest const& request)
+{
+    QMetaObject::invokeMethod(
+                &threadContext_,
+                [this, request]() { renderInThread(request); },
+                Qt::QueuedConnection);
+}
+
+void RenderWorker::renderInThread(RenderRequest const& request)
+{
+    RenderResponse response{request.number, {}, request.size, {}, 0, 0, false, {}};
+    QElapsedTimer timer;
+    timer.start();
+    try
+    {
+        if (!initializationError_.isEmpty())
+        { throw initializationError_; }
+        response.sceneReused = renderer_->activateScene(request.sceneKey);
+        if (!response.sceneReused)
+        {
+            QString error;
+            auto scene = sceneCache_.scene(request.sceneKey, request.dumpPath, error);
+            if (scene == nullptr)
+            { throw error; }
+            renderer_->loadScene(request.sceneKey, scene->mesh, scene->vram);
+        }
+        response.loadTimeUs = timer.nsecsElapsed() / 1000;
+        timer.restart();
+        auto image = renderer_->render(request.camera, request.size);
+        if (request.format == RenderRequest::PNG)
+        {
+            QBuffer buffer(&response.payload);
+            buffer.open(QBuffer::WriteOnly);
+            if (!image.save(&buffer, "PNG", PNG_QUALITY))
+            { throw QString("Could not encode PNG image."); }
+        }
+        else
+        { response.payload = QByteArray(reinterpret_cast<char const*>(image.constBits()), image.sizeInBytes()); }
+        response.renderTimeUs = timer.nsecsElapsed() / 1000;
+    }
+    catch (QString const& error)
+    {
+        response.error = error;
+        response.payload.clear();
+    }
+    response.sceneKeys = renderer_->sceneKeys();
+    emit finished(index_, response);
+}
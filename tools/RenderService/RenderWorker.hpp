@@ -0,0 +1,40 @@
+#ifndef RENDERWORKER_HPP
+#define RENDERWORKER_HPP
+
+#include "OffscreenSceneRenderer.hpp"
+#include "RenderRequest.hpp"
+#include "SceneCache.hpp"
+#include <QObject>
+#include <QThread>
+#include <memory>
+
+// One OpenGL context with its own thread. Requests are rendered one at a time in that thread; scenes
+// stay loaded in the context between requests under the given GPU memory budget.
+class RenderWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    RenderWorker(int index, SceneCache& sceneCache, size_t sceneMemoryBudget);
+    ~RenderWorker();
+
+    int index() const
+    { return index_; }
+    void render(RenderRequest const& request);
+
+signals:
+    void finished(int workerIndex, RenderResponse response);
+
+private:
+    void initialize(size_t sceneMemoryBudget);
+    void renderInThread(RenderRequest const& request);
+
+    int index_;
+    SceneCache& sceneCache_;
+    QThread thread_;
+    QObject threadContext_;
+    std::unique_ptr<OffscreenSceneRenderer> renderer_;
+    QString initializationError_;
+};
+
+#endif // RENDERWORKER_HPP
@@ -0,0 +1,79 @@
+#include "SceneCache.hpp"
+#include "SceneLoader.hpp"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+SceneCache::SceneCache(int capacity)
+    : capacity_{capacity}
+{}
+
+QString SceneCache::sceneKey(QString const& dumpPath)
+{
+    QFileInfo fileInfo(dumpPath);
+    return QString("%1|%2|%3")
+            .arg(fileInfo.canonicalFilePath())
+            .arg(fileInfo.lastModified().toMSecsSinceEpoch())
+            .arg(fileInfo.size());
+}
+
+std::shared_ptr<SceneCache::Scene const> SceneCache::find(QString const& sceneKey)
+{
+    QMutexLocker locker(&mutex_);
+    for (int entryIndex = 0; entryIndex < entries_.count(); ++entryIndex)
+    {
+        if (entries_[entryIndex].key == sceneKey)
+        {
+            entries_.move(entryIndex, 0);
+            return entries_.first().scene;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<SceneCache::Scene const> SceneCache::scene(
+        QString const& sceneKey,
+        QString const& dumpPath,
+        QString& error)
+{
+    auto cachedScene = find(sceneKey);
+    if (cachedScene != nullptr)
+    { return cachedScene; }
+    // Parsed without holding the lock; two workers missing the same scene at once both parse it, which is
+    // cheaper than serializing every load.
+    SceneLoader sceneLoader;
+    auto scene = std::make_shared<Scene>();
+    auto loadError = sceneLoader.loadDump(dumpPath);
+    if (loadError.isOk())
+    { loadError = sceneLoader.readScene(); }
+    if (loadError.isOk())
+    { loadError = sceneLoader.buildMesh(scene->mesh); }
+    if (!loadError.isOk())
+    {
+        error = loadError.message;
+        return nullptr;
+    }
+    // Squeezed here, so the copies workers hand to SceneGLResources keep sharing the same data.
+    scene->mesh.vertices.squeeze();
+    scene->mesh.opaquePolygonsIndices.squeeze();
+    scene->mesh.semiTransparentPolygonsIndices.squeeze();
+    scene->mesh.voxelsChunks.squeeze();
+    scene->mesh.polygonsSources.squeeze();
+    scene->mesh.voxelsGrid.semiTransparentFirstIndices.squeeze();
+    scene->mesh.voxelsGrid.chunksIndices.squeeze();
+    scene->mesh.vramRects.squeeze();
+    scene->vram = sceneLoader.psxVRam();
+    QMutexLocker locker(&mutex_);
+    for (int entryIndex = 0; entryIndex < entries_.count(); ++entryIndex)
+    {
+        if (entries_[entryIndex].key == sceneKey)
+        {
+            entries_.removeAt(entryIndex);
+            break;
+        }
+    }
+    entries_.prepend({sceneKey, scene});
+    while (entries_.count() > capacity_)
+    { entries_.removeLast(); }
+    return scene;
+}
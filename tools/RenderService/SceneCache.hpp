@@ -0,0 +1,43 @@
+#ifndef SCENECACHE_HPP
+#define SCENECACHE_HPP
+
+#include "SceneMesh.hpp"
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <memory>
+
+// Parsed scenes shared by all render workers, so a dump is read and parsed once however many OpenGL
+// contexts upload it. Thread safe; scenes beyond the capacity are dropped in least recently used order.
+class SceneCache
+{
+public:
+    struct Scene
+    {
+        SceneMesh mesh;
+        QByteArray vram;
+    };
+
+    static constexpr int const DEFAULT_CAPACITY = 16;
+
+    explicit SceneCache(int capacity = DEFAULT_CAPACITY);
+
+    static QString sceneKey(QString const& dumpPath);
+    std::shared_ptr<Scene const> scene(QString const& sceneKey, QString const& dumpPath, QString& error);
+
+private:
+    struct Entry
+    {
+        QString key;
+        std::shared_ptr<Scene const> scene;
+    };
+
+    std::shared_ptr<Scene const> find(QString const& sceneKey);
+
+    int capacity_;
+    QMutex mutex_;
+    QList<Entry> entries_;
+};
+
+#endif // SCENECACHE_HPP
@@ -0,0 +1,61 @@
+#include "RenderService.hpp"
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QSurfaceFormat>
+#include <QTextStream>
+#include <QThread>
+
+int main(int argc, char *argv[])
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Renders AD 3D models (*.3dm) on request over a local socket, using a pool of offscreen "
+                "OpenGL contexts that keep recently used scenes loaded. Needs a Qt platform with OpenGL, "
+                "e.g. xcb under xvfb-run on a machine without display.");
+    parser.addHelpOption();
+    QCommandLineOption nameOption("name", "Local server name or socket path.", "name", "virtualmonsbaia-render");
+    parser.addOption(nameOption);
+    QCommandLineOption workersOption("workers", "Number of OpenGL contexts rendering in parallel.", "number", "2");
+    parser.addOption(workersOption);
+    QCommandLineOption sceneMemoryBudgetOption(
+                "scene-memory-budget",
+                "GPU memory kept for loaded scenes by every context (MB).",
+                "MB",
+                QString::number(SceneResidencyManager::DEFAULT_GPU_MEMORY_BUDGET >> 20));
+    parser.addOption(sceneMemoryBudgetOption);
+    QStringList arguments;
+    for (int argumentIndex = 0; argumentIndex < argc; ++argumentIndex)
+    { arguments.append(QString::fromLocal8Bit(argv[argumentIndex])); }
+    parser.parse(arguments);
+    auto workersNumber = qMax(1, parser.value(workersOption).toInt());
+    // llvmpipe starts one rasterizer thread per core for every context; with several contexts drawing at
+    // once they only contend, so the cores are split between the workers unless set explicitly.
+    // Has to happen before the platform creates any context.
+    if (qEnvironmentVariableIsEmpty("LP_NUM_THREADS"))
+    { qputenv("LP_NUM_THREADS", QByteArray::number(qMax(1, QThread::idealThreadCount() / workersNumber))); }
+    QGuiApplication application(argc, argv);
+    parser.process(application);
+    QSurfaceFormat format;
+    format.setDepthBufferSize(24);
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setRenderableType(QSurfaceFormat::OpenGL);
+    QSurfaceFormat::setDefaultFormat(format);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    try
+    {
+        RenderService renderService(
+                    workersNumber,
+                    parser.value(sceneMemoryBudgetOption).toULongLong() << 20);
+        renderService.listen(parser.value(nameOption));
+        out << QString("Listening on %1 with %2 workers.").arg(parser.value(nameOption)).arg(workersNumber) << '\n';
+        out.flush();
+        return application.exec();
+    }
+    catch (QString const& error)
+    {
+        err << error << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,125 @@
+#include "SceneLoader.hpp"
+#include "SyntheticSceneGenerator.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+namespace
+{
+
+struct NumericOption
+{
+    QCommandLineOption option;
+    double min;
+    double max;
+};
+
+double numericValue(QCommandLineParser const& parser, NumericOption const& numericOption, double defaultValue)
+{
+    if (!parser.isSet(numericOption.option))
+    { return defaultValue; }
+    bool ok = false;
+    auto value = parser.value(numericOption.option).toDouble(&ok);
+    if (!ok || value < numericOption.min || value > numericOption.max)
+    {
+        throw QString("Value of --%1 must be a number in range %2..%3.")
+                .arg(numericOption.option.names().first())
+                .arg(numericOption.min)
+                .arg(numericOption.max);
+    }
+    return value;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates synthetic AD 3D models (*.3dm) for scaling and stress tests.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("output", "Output *.3dm file.");
+    NumericOption width{{"width", "Voxels grid width.", "voxels"}, 1, 0x8000};
+    NumericOption height{{"height", "Voxels grid height.", "voxels"}, 1, 0x8000};
+    NumericOption filled{{"filled", "Ratio of voxels having polygons.", "ratio"}, 0, 1};
+    NumericOption reuse{{"reuse", "Ratio of voxels reusing an existing polygons descriptors list.", "ratio"}, 0, 1};
+    NumericOption minPolygons{{"min-polygons", "Minimal number of polygons per descriptors list.", "number"}, 1, 255};
+    NumericOption maxPolygons{{"max-polygons", "Maximal number of polygons per descriptors list.", "number"}, 1, 255};
+    NumericOption semiTransparent{{"semi-transparent", "Ratio of semi-transparent polygons.", "ratio"}, 0, 1};
+    NumericOption vertices{{"vertices", "Number of vertices.", "number"}, 4, 0x10000};
+    NumericOption texpages{{"texpages", "Number of distinct texpages.", "number"}, 1, 22};
+    NumericOption cluts{{"cluts", "Number of distinct CLUTs.", "number"}, 1, 128};
+    NumericOption seed{{"seed", "Random generator seed.", "number"}, 0, 0xffffffffu};
+    QCommandLineOption measureParse("measure-parse", "Measure how long parsing of generated scene takes.");
+    for (auto const* numericOption : {
+         &width, &height, &filled, &reuse, &minPolygons, &maxPolygons,
+         &semiTransparent, &vertices, &texpages, &cluts, &seed})
+    { parser.addOption(numericOption->option); }
+    parser.addOption(measureParse);
+    parser.process(application);
+    if (parser.positionalArguments().size() != 1)
+    { parser.showHelp(1); }
+    try
+    {
+        SyntheticSceneGenerator::Parameters parameters;
+        parameters.voxelsWidth = numericValue(parser, width, parameters.voxelsWidth);
+        parameters.voxelsHeight = numericValue(parser, height, parameters.voxelsHeight);
+        parameters.filledVoxelsRatio = numericValue(parser, filled, parameters.filledVoxelsRatio);
+        parameters.descriptorsListsReuseRatio = numericValue(parser, reuse, parameters.descriptorsListsReuseRatio);
+        parameters.minPolygonsPerVoxel = numericValue(parser, minPolygons, parameters.minPolygonsPerVoxel);
+        parameters.maxPolygonsPerVoxel = numericValue(parser, maxPolygons, parameters.maxPolygonsPerVoxel);
+        parameters.semiTransparentRatio = numericValue(parser, semiTransparent, parameters.semiTransparentRatio);
+        parameters.verticesNumber = numericValue(parser, vertices, parameters.verticesNumber);
+        parameters.texpagesNumber = numericValue(parser, texpages, parameters.texpagesNumber);
+        parameters.clutsNumber = numericValue(parser, cluts, parameters.clutsNumber);
+        parameters.seed = numericValue(parser, seed, parameters.seed);
+        SyntheticSceneGenerator generator(parameters);
+        QElapsedTimer timer;
+        timer.start();
+        auto dump = generator.generateDump();
+        auto generationTimeMs = timer.elapsed();
+        auto const& statistics = generator.statistics();
+        out << QString("Generated %1 polygons in %2 descriptors lists over %3 filled voxels, %4 vertices, "
+                       "0x%5 bytes of tables in %6 ms.")
+               .arg(statistics.polygonsNumber)
+               .arg(statistics.descriptorsListsNumber)
+               .arg(statistics.filledVoxelsNumber)
+               .arg(statistics.verticesNumber)
+               .arg(statistics.usedRamSize, 0, 16)
+               .arg(generationTimeMs) << '\n';
+        if (parser.isSet(measureParse))
+        {
+            SceneLoader sceneLoader;
+            auto error = sceneLoader.setMemory(dump);
+            timer.restart();
+            if (error.isOk())
+            { error = sceneLoader.readScene(); }
+            auto parseTimeUs = timer.nsecsElapsed() / 1000;
+            SceneMesh mesh;
+            timer.restart();
+            if (error.isOk())
+            { error = sceneLoader.buildMesh(mesh); }
+            if (!error.isOk())
+            { throw error.message; }
+            out << QString("Parsed %1x%2 voxels in %3 us, built %4 polygons mesh in %5 us.")
+                   .arg(sceneLoader.scene().width())
+                   .arg(sceneLoader.scene().height())
+                   .arg(parseTimeUs)
+                   .arg(mesh.polygonsSources.count())
+                   .arg(timer.nsecsElapsed() / 1000) << '\n';
+        }
+        QFile file(parser.positionalArguments().first());
+        if (!file.open(QFile::WriteOnly) || file.write(dump) != dump.size())
+        { throw QString("Could not write file %1.").arg(file.fileName()); }
+    }
+    catch (QString const& error)
+    {
+        err << error << '\n';
+        return 1;
+    }
+    return 0;
+}